@@ -142,6 +142,8 @@ macro(write_configtable)
   string(APPEND out "DES Metrics event collection  : ")
   check_on_or_off("NS3_DES_METRICS" "NS3_DES_METRICS")
 
+  string(APPEND out "Packet metadata               : ${NS3_PACKET_METADATA}\n")
+
   string(APPEND out "DPDK NetDevice                : ")
   check_on_or_off("NS3_DPDK" "ENABLE_DPDKDEVNET")
 
@@ -386,6 +386,18 @@ macro(process_options)
     add_definitions(-DENABLE_DES_METRICS)
   endif()
 
+  # Select the packet metadata implementation; "off" compiles it out
+  if(${NS3_PACKET_METADATA} STREQUAL "compact")
+    add_definitions(-DNS3_PACKET_METADATA_COMPACT)
+  elseif(${NS3_PACKET_METADATA} STREQUAL "off")
+    add_definitions(-DNS3_PACKET_METADATA_DISABLE)
+  elseif(NOT (${NS3_PACKET_METADATA} STREQUAL "full"))
+    message(
+      FATAL_ERROR
+        "NS3_PACKET_METADATA must be full, compact or off, not ${NS3_PACKET_METADATA}"
+    )
+  endif()
+
   if(${NS3_SANITIZE} AND ${NS3_SANITIZE_MEMORY})
     message(
       FATAL_ERROR
@@ -0,0 +1,324 @@
+// src/antnet/examples/antnet-benchmark.cc
+//
+// Convergence and overhead benchmark for AntNet over point-to-point topologies.
+//
+// Topologies:
+//   grid   rows x cols lattice with N nodes
+//   rgg    random geometric graph in the unit square, radius chosen so the
+//          graph is connected with high probability (components are bridged)
+//   brite  topology read from a BRITE output file (--briteFile), link delays
+//          taken from the file
+//
+// One result record is written to stdout (JSON by default, or a CSV row with
+// --format=csv) so runs can be collected and compared for regressions:
+//   ./ns3 run "antnet-benchmark --topology=grid --nodes=100 --flows=10"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/antnet-helper.h"
+#include "ns3/antnet-routing-protocol.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AntNetBenchmark");
+
+namespace {
+
+struct Link {
+  uint32_t a;
+  uint32_t b;
+  Time delay;
+};
+
+struct ByteCounters {
+  uint64_t total = 0;
+  uint64_t ant = 0;
+  uint64_t hello = 0;
+};
+
+ByteCounters g_bytes;
+uint16_t g_antPort = 5001;
+uint16_t g_helloPort = 5002;
+
+// Classifies from the raw IPv4 + UDP header bytes so tracing stays cheap
+void TxTrace(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t iface) {
+  uint32_t size = p->GetSize();
+  g_bytes.total += size;
+  uint8_t hdr[24];
+  if (size < sizeof(hdr)) return;
+  p->CopyData(hdr, sizeof(hdr));
+  uint32_t ihl = (hdr[0] & 0x0f) * 4;
+  if (hdr[9] != UdpL4Protocol::PROT_NUMBER || ihl != 20) return;
+  uint16_t dport = (hdr[22] << 8) | hdr[23];
+  if (dport == g_antPort) g_bytes.ant += size;
+  else if (dport == g_helloPort) g_bytes.hello += size;
+}
+
+uint32_t Find(std::vector<uint32_t>& parent, uint32_t x) {
+  while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+  return x;
+}
+
+std::vector<Link> MakeGrid(uint32_t n, Time delay) {
+  std::vector<Link> links;
+  uint32_t cols = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+  for (uint32_t i = 0; i < n; ++i) {
+    if ((i % cols) + 1 < cols && i + 1 < n) links.push_back({i, i + 1, delay});
+    if (i + cols < n) links.push_back({i, i + cols, delay});
+  }
+  return links;
+}
+
+std::vector<Link> MakeRandomGeometric(uint32_t n, Time delay) {
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable>();
+  std::vector<double> x(n), y(n);
+  for (uint32_t i = 0; i < n; ++i) { x[i] = u->GetValue(); y[i] = u->GetValue(); }
+  double r = std::sqrt(2.0 * std::log(std::max(2u, n)) / (M_PI * n));
+  std::vector<Link> links;
+  std::vector<uint32_t> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  for (uint32_t i = 0; i < n; ++i) {
+    for (uint32_t j = i + 1; j < n; ++j) {
+      double dx = x[i] - x[j], dy = y[i] - y[j];
+      if (dx * dx + dy * dy <= r * r) {
+        links.push_back({i, j, delay});
+        parent[Find(parent, i)] = Find(parent, j);
+      }
+    }
+  }
+  // Bridge leftover components to the one holding node 0
+  for (uint32_t i = 1; i < n; ++i) {
+    if (Find(parent, i) != Find(parent, 0)) {
+      links.push_back({0, i, delay});
+      parent[Find(parent, i)] = Find(parent, 0);
+    }
+  }
+  return links;
+}
+
+// Reads the "Nodes:" and "Edges:" sections of a BRITE output file
+std::vector<Link> ReadBrite(const std::string& file, uint32_t& n) {
+  std::ifstream in(file);
+  NS_ABORT_MSG_IF(!in, "Cannot open BRITE file " << file);
+  std::map<int64_t, uint32_t> ids;
+  std::vector<Link> links;
+  enum { NONE, NODES, EDGES } section = NONE;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.rfind("Nodes:", 0) == 0) { section = NODES; continue; }
+    if (line.rfind("Edges:", 0) == 0) { section = EDGES; continue; }
+    std::istringstream ss(line);
+    if (section == NODES) {
+      int64_t id;
+      if (ss >> id) ids.emplace(id, static_cast<uint32_t>(ids.size()));
+    } else if (section == EDGES) {
+      int64_t id, from, to;
+      double length, delayMs;
+      if (ss >> id >> from >> to >> length >> delayMs) {
+        NS_ABORT_MSG_IF(!ids.count(from) || !ids.count(to), "Edge " << id << " uses an unknown node");
+        links.push_back({ids[from], ids[to], MicroSeconds(std::max<int64_t>(1, std::llround(delayMs * 1000)))});
+      }
+    }
+  }
+  n = static_cast<uint32_t>(ids.size());
+  return links;
+}
+
+// Peak resident set size in kilobytes, or -1 where getrusage is not available
+long GetPeakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+#if defined(__APPLE__)
+  return ru.ru_maxrss / 1024; // bytes on macOS
+#else
+  return ru.ru_maxrss; // kilobytes on Linux
+#endif
+#else
+  return -1;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  std::string topology = "grid";
+  std::string briteFile;
+  std::string format = "json";
+  uint32_t nNodes = 100;
+  uint32_t nFlows = 10;
+  double simTime = 30.0;
+  double linkDelayMs = 2.0;
+  std::string linkRate = "100Mbps";
+  std::string flowRate = "256kbps";
+  double entropyThreshold = 0.5;
+  double sampleInterval = 0.5;
+
+  CommandLine cmd(__FILE__);
+  cmd.AddValue("topology", "grid, rgg or brite", topology);
+  cmd.AddValue("briteFile", "BRITE output file for --topology=brite", briteFile);
+  cmd.AddValue("nodes", "Number of nodes (grid, rgg)", nNodes);
+  cmd.AddValue("flows", "Number of random UDP flows", nFlows);
+  cmd.AddValue("simTime", "Simulation time (s)", simTime);
+  cmd.AddValue("linkDelay", "Link delay in ms (grid, rgg)", linkDelayMs);
+  cmd.AddValue("linkRate", "Link data rate", linkRate);
+  cmd.AddValue("flowRate", "Data rate of each flow", flowRate);
+  cmd.AddValue("entropyThreshold", "Mean normalized pheromone entropy counted as converged",
+               entropyThreshold);
+  cmd.AddValue("sampleInterval", "Entropy sampling interval (s)", sampleInterval);
+  cmd.AddValue("format", "Output format: json or csv", format);
+  cmd.Parse(argc, argv);
+
+  // --- 1) Topology
+  std::vector<Link> links;
+  Time delay = MicroSeconds(static_cast<uint64_t>(linkDelayMs * 1000));
+  if (topology == "grid") {
+    links = MakeGrid(nNodes, delay);
+  } else if (topology == "rgg") {
+    links = MakeRandomGeometric(nNodes, delay);
+  } else if (topology == "brite") {
+    NS_ABORT_MSG_IF(briteFile.empty(), "--topology=brite needs --briteFile");
+    links = ReadBrite(briteFile, nNodes);
+  } else {
+    NS_ABORT_MSG("Unknown topology " << topology);
+  }
+  NS_ABORT_MSG_IF(nNodes < 2, "Need at least two nodes");
+
+  NodeContainer nodes;
+  nodes.Create(nNodes);
+
+  InternetStackHelper stack;
+  Ipv4ListRoutingHelper list;
+  AntNetHelper antnet;
+  list.Add(antnet, 10);
+  stack.SetRoutingHelper(list);
+  stack.Install(nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute("DataRate", StringValue(linkRate));
+  Ipv4AddressHelper addr("10.0.0.0", "255.255.255.252");
+  for (auto const& l : links) {
+    p2p.SetChannelAttribute("Delay", TimeValue(l.delay));
+    addr.Assign(p2p.Install(nodes.Get(l.a), nodes.Get(l.b)));
+    addr.NewNetwork();
+  }
+
+  // --- 2) Traffic: random source/destination pairs
+  uint16_t port = 9000;
+  Ptr<UniformRandomVariable> pick = CreateObject<UniformRandomVariable>();
+  std::set<uint32_t> sinks;
+  for (uint32_t f = 0; f < nFlows; ++f) {
+    uint32_t s = pick->GetInteger(0, nNodes - 1);
+    uint32_t d = pick->GetInteger(0, nNodes - 2);
+    if (d >= s) d++;
+    Ipv4Address dAddr = nodes.Get(d)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+    if (sinks.insert(d).second) {
+      PacketSinkHelper sink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+      sink.Install(nodes.Get(d)).Start(Seconds(0.5));
+    }
+    OnOffHelper onoff("ns3::UdpSocketFactory", InetSocketAddress(dAddr, port));
+    onoff.SetConstantRate(DataRate(flowRate), 512);
+    ApplicationContainer app = onoff.Install(nodes.Get(s));
+    app.Start(Seconds(1.0 + pick->GetValue(0.0, 1.0)));
+    app.Stop(Seconds(simTime));
+  }
+
+  // --- 3) Measurement hooks
+  Config::ConnectWithoutContext("/NodeList/*/$ns3::Ipv4L3Protocol/Tx", MakeCallback(&TxTrace));
+  std::vector<Ptr<AntNetRoutingProtocol>> agents;
+  for (uint32_t i = 0; i < nNodes; ++i) {
+    agents.push_back(nodes.Get(i)->GetObject<AntNetRoutingProtocol>());
+  }
+  double convergence = -1.0;
+  double lastEntropy = -1.0;
+  std::function<void()> sample = [&]() {
+    double sum = 0.0;
+    uint32_t n = 0;
+    for (auto const& a : agents) {
+      double h = a ? a->GetMeanEntropy() : -1.0;
+      if (h >= 0) { sum += h; n++; }
+    }
+    if (n > 0) {
+      lastEntropy = sum / n;
+      if (convergence < 0 && lastEntropy < entropyThreshold) {
+        convergence = Simulator::Now().GetSeconds();
+      }
+    }
+    Simulator::Schedule(Seconds(sampleInterval), sample);
+  };
+  Simulator::Schedule(Seconds(sampleInterval), sample);
+
+  // --- 4) Run
+  Simulator::Stop(Seconds(simTime));
+  auto t0 = std::chrono::steady_clock::now();
+  Simulator::Run();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  uint64_t events = Simulator::GetEventCount();
+
+  uint64_t rxBytes = 0;
+  for (uint32_t d : sinks) {
+    Ptr<Node> node = nodes.Get(d);
+    for (uint32_t k = 0; k < node->GetNApplications(); ++k) {
+      Ptr<PacketSink> sink = DynamicCast<PacketSink>(node->GetApplication(k));
+      if (sink) rxBytes += sink->GetTotalRx();
+    }
+  }
+  long peakRssKb = GetPeakRssKb();
+  AntNetRoutingProtocol::Stats ants = AntNetHelper::GetStats(nodes);
+  uint64_t antDrops = ants.dropHopLimit + ants.dropNoNextHop;
+
+  double antPct = g_bytes.total ? 100.0 * g_bytes.ant / g_bytes.total : 0.0;
+  double helloPct = g_bytes.total ? 100.0 * g_bytes.hello / g_bytes.total : 0.0;
+  if (format == "csv") {
+    std::cout << "topology,nodes,links,flows,simTime,wallClock,wallPerSimSecond,events,eventsPerSecond,"
+                 "totalBytes,antBytes,antBytesPct,helloBytes,helloBytesPct,rxBytes,"
+                 "convergenceTime,finalEntropy,fwdAntsLaunched,antDrops,peakRssKb\n";
+    std::cout << topology << "," << nNodes << "," << links.size() << "," << nFlows << ","
+              << simTime << "," << wall << "," << wall / simTime << "," << events << ","
+              << (wall > 0 ? events / wall : 0.0) << "," << g_bytes.total << "," << g_bytes.ant << ","
+              << antPct << "," << g_bytes.hello << "," << helloPct << "," << rxBytes << ","
+              << convergence << "," << lastEntropy << "," << ants.fwdLaunched << "," << antDrops
+              << "," << peakRssKb << "\n";
+  } else {
+    std::cout << "{\"topology\":\"" << topology << "\""
+              << ",\"nodes\":" << nNodes
+              << ",\"links\":" << links.size()
+              << ",\"flows\":" << nFlows
+              << ",\"simTime\":" << simTime
+              << ",\"wallClock\":" << wall
+              << ",\"wallPerSimSecond\":" << wall / simTime
+              << ",\"events\":" << events
+              << ",\"eventsPerSecond\":" << (wall > 0 ? events / wall : 0.0)
+              << ",\"totalBytes\":" << g_bytes.total
+              << ",\"antBytes\":" << g_bytes.ant
+              << ",\"antBytesPct\":" << antPct
+              << ",\"helloBytes\":" << g_bytes.hello
+              << ",\"helloBytesPct\":" << helloPct
+              << ",\"rxBytes\":" << rxBytes
+              << ",\"convergenceTime\":" << convergence
+              << ",\"finalEntropy\":" << lastEntropy
+              << ",\"fwdAntsLaunched\":" << ants.fwdLaunched
+              << ",\"antDrops\":" << antDrops
+              << ",\"peakRssKb\":" << peakRssKb
+              << "}\n";
+  }
+
+  Simulator::Destroy();
+  return 0;
+}
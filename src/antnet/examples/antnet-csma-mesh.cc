@@ -174,6 +174,7 @@ int main(int argc, char *argv[])
     }
   }
   std::cout << "[RESULT] Aggregate throughput ~ " << aggThr << " Mbps\n";
+  AntNetHelper::PrintStats(std::cout);
 
   Simulator::Destroy();
   return 0;
@@ -4,6 +4,10 @@
 #include "ns3/names.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <map>
+#include <sstream>
 
 namespace ns3 {
 
@@ -31,4 +35,99 @@ void AntNetHelper::Set(std::string name, const AttributeValue &value) {
   m_agentFactory.Set(name, value);
 }
 
+AntNetRoutingProtocol::Stats AntNetHelper::GetStats(NodeContainer c) {
+  AntNetRoutingProtocol::Stats t;
+  for (auto it = c.Begin(); it != c.End(); ++it) {
+    Ptr<AntNetRoutingProtocol> agent = (*it)->GetObject<AntNetRoutingProtocol>();
+    if (!agent) continue;
+    const AntNetRoutingProtocol::Stats &s = agent->GetStats();
+    t.fwdLaunched += s.fwdLaunched;
+    t.fwdRelayed += s.fwdRelayed;
+    t.fwdArrived += s.fwdArrived;
+    t.bwdRelayed += s.bwdRelayed;
+    t.bwdEnded += s.bwdEnded;
+    t.dropHopLimit += s.dropHopLimit;
+    t.dropNoNextHop += s.dropNoNextHop;
+    t.reinforcements += s.reinforcements;
+    t.reinforcementSum += s.reinforcementSum;
+    t.dataRouted += s.dataRouted;
+    t.dataNoRoute += s.dataNoRoute;
+  }
+  return t;
+}
+
+void AntNetHelper::PrintStats(std::ostream& os, NodeContainer c) {
+  AntNetRoutingProtocol::Stats t = GetStats(c);
+  double rttSum = 0.0;
+  uint32_t rttN = 0;
+  for (auto it = c.Begin(); it != c.End(); ++it) {
+    Ptr<AntNetRoutingProtocol> agent = (*it)->GetObject<AntNetRoutingProtocol>();
+    if (!agent) continue;
+    const PheromoneTable &ph = agent->GetPheromoneTable();
+    for (auto const& d : ph.GetDestinations()) {
+      const LocalStats *st = ph.GetStats(d);
+      if (st) { rttSum += st->mu; rttN++; }
+    }
+  }
+  os << "AntNet fwdLaunched=" << t.fwdLaunched << " fwdRelayed=" << t.fwdRelayed
+     << " fwdArrived=" << t.fwdArrived << " bwdRelayed=" << t.bwdRelayed
+     << " bwdEnded=" << t.bwdEnded << " dropHopLimit=" << t.dropHopLimit
+     << " dropNoNextHop=" << t.dropNoNextHop << " reinforcements=" << t.reinforcements
+     << " meanReinforcement=" << (t.reinforcements ? t.reinforcementSum / t.reinforcements : 0.0)
+     << " meanRttEwma=" << (rttN ? rttSum / rttN : 0.0)
+     << " dataRouted=" << t.dataRouted << " dataNoRoute=" << t.dataNoRoute << std::endl;
+}
+
+// File layout: u32 node count, then per node u32 id, u64 length, table image
+void AntNetHelper::SaveSnapshot(std::string filename, NodeContainer c) {
+  std::ofstream os(filename, std::ios::binary);
+  NS_ABORT_MSG_IF(!os, "Cannot open " << filename);
+  std::vector<std::pair<uint32_t, std::string>> images;
+  for (auto it = c.Begin(); it != c.End(); ++it) {
+    Ptr<AntNetRoutingProtocol> agent = (*it)->GetObject<AntNetRoutingProtocol>();
+    if (!agent) continue;
+    std::ostringstream img;
+    agent->SaveSnapshot(img);
+    images.emplace_back((*it)->GetId(), img.str());
+  }
+  uint32_t n = static_cast<uint32_t>(images.size());
+  os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  for (auto const& im : images) {
+    uint64_t len = im.second.size();
+    os.write(reinterpret_cast<const char*>(&im.first), sizeof(im.first));
+    os.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    os.write(im.second.data(), len);
+  }
+  NS_LOG_INFO("Saved " << n << " AntNet tables to " << filename);
+}
+
+uint32_t AntNetHelper::LoadSnapshot(std::string filename, NodeContainer c) {
+  std::ifstream is(filename, std::ios::binary);
+  NS_ABORT_MSG_IF(!is, "Cannot open " << filename);
+  std::map<uint32_t, std::string> images;
+  uint32_t n = 0;
+  is.read(reinterpret_cast<char*>(&n), sizeof(n));
+  for (uint32_t k = 0; k < n && is; ++k) {
+    uint32_t id = 0;
+    uint64_t len = 0;
+    is.read(reinterpret_cast<char*>(&id), sizeof(id));
+    is.read(reinterpret_cast<char*>(&len), sizeof(len));
+    std::string img(len, '\0');
+    is.read(&img[0], len);
+    images[id] = img;
+  }
+  NS_ABORT_MSG_IF(!is, "Truncated AntNet snapshot " << filename);
+  uint32_t restored = 0;
+  for (auto it = c.Begin(); it != c.End(); ++it) {
+    Ptr<AntNetRoutingProtocol> agent = (*it)->GetObject<AntNetRoutingProtocol>();
+    auto im = images.find((*it)->GetId());
+    if (!agent || im == images.end()) continue;
+    std::istringstream img(im->second);
+    NS_ABORT_MSG_IF(!agent->LoadSnapshot(img), "Corrupt table for node " << im->first);
+    restored++;
+  }
+  NS_LOG_INFO("Restored " << restored << " AntNet tables from " << filename);
+  return restored;
+}
+
 } // namespace ns3
@@ -1,13 +1,13 @@
 #ifndef ANNET_HELPER_H
 #define ANNET_HELPER_H
 
+#include "ns3/antnet-routing-protocol.h"
 #include "ns3/ipv4-routing-helper.h"
+#include "ns3/node-container.h"
 #include "ns3/object-factory.h"
 
 namespace ns3 {
 
-class AntNetRoutingProtocol;
-
 class AntNetHelper : public Ipv4RoutingHelper
 {
 public:
@@ -19,6 +19,17 @@ public:
 
   void Set(std::string name, const AttributeValue &value);
 
+  // Writes the pheromone tables of all AntNet nodes in c to one binary file
+  static void SaveSnapshot(std::string filename, NodeContainer c = NodeContainer::GetGlobal());
+  // Warm-starts the nodes in c from a SaveSnapshot() file, matching nodes by
+  // id; returns the number of nodes restored. Call after the stack is installed.
+  static uint32_t LoadSnapshot(std::string filename, NodeContainer c = NodeContainer::GetGlobal());
+
+  // Sum of the per-node counters of all AntNet nodes in c
+  static AntNetRoutingProtocol::Stats GetStats(NodeContainer c = NodeContainer::GetGlobal());
+  // One-line per-run summary of GetStats() plus the mean ant RTT EWMA
+  static void PrintStats(std::ostream& os, NodeContainer c = NodeContainer::GetGlobal());
+
 private:
   ObjectFactory m_agentFactory;
 };
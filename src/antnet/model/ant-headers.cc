@@ -8,7 +8,7 @@ NS_LOG_COMPONENT_DEFINE("AntHeaders");
 NS_OBJECT_ENSURE_REGISTERED(AntHeader);
 
 AntHeader::AntHeader()
-  : m_type(ANT_FORWARD), m_src(), m_dst(), m_id(0), m_launchTime(0.0) {}
+  : m_type(ANT_FORWARD), m_src(), m_dst(), m_id(0), m_launchTime(0), m_pathLen(0) {}
 
 TypeId AntHeader::GetTypeId() {
   static TypeId tid = TypeId("ns3::AntHeader")
@@ -22,42 +22,42 @@ TypeId AntHeader::GetInstanceTypeId() const { return GetTypeId(); }
 void AntHeader::Print(std::ostream& os) const {
   os << (m_type == ANT_FORWARD ? "FWD" : "BWD")
      << " id=" << m_id << " " << m_src << "->" << m_dst
-     << " t0=" << m_launchTime << " hops=" << m_path.size();
+     << " t0=" << GetLaunchTime().As(Time::S) << " hops=" << static_cast<uint32_t>(m_pathLen);
 }
 
 uint32_t AntHeader::GetSerializedSize() const {
-  return 1 + 4 + 8 + 4 + 4 + 2 + 4 * m_path.size();
+  return 1 + 4 + 8 + 4 + 4 + 1 + 4 * m_pathLen;
 }
 
 void AntHeader::Serialize(Buffer::Iterator i) const {
   i.WriteU8(static_cast<uint8_t>(m_type));
   i.WriteHtonU32(m_id);
-  union { double d; uint64_t u; } u;
-  u.d = m_launchTime;
-  i.WriteHtonU64(u.u);
+  i.WriteHtonU64(static_cast<uint64_t>(m_launchTime));
   WriteTo(i, m_src);
   WriteTo(i, m_dst);
-  i.WriteHtonU16(static_cast<uint16_t>(m_path.size()));
-  for (auto const& a : m_path) {
-    WriteTo(i, a);
+  i.WriteU8(m_pathLen);
+  for (uint8_t k = 0; k < m_pathLen; ++k) {
+    WriteTo(i, m_path[k]);
   }
 }
 
 uint32_t AntHeader::Deserialize(Buffer::Iterator i) {
-  uint8_t t = i.ReadU8();
-  m_type = static_cast<AntType>(t);
+  m_type = static_cast<AntType>(i.ReadU8());
   m_id = i.ReadNtohU32();
-  union { double d; uint64_t u; } u;
-  u.u = i.ReadNtohU64();
-  m_launchTime = u.d;
+  m_launchTime = static_cast<int64_t>(i.ReadNtohU64());
   ReadFrom(i, m_src);
   ReadFrom(i, m_dst);
-  uint16_t len = i.ReadNtohU16();
-  m_path.clear();
-  for (uint16_t k = 0; k < len; ++k) {
-    Ipv4Address a; ReadFrom(i, a); m_path.push_back(a);
+  uint8_t len = i.ReadU8();
+  m_pathLen = 0;
+  if (len > MAX_PATH) {
+    NS_LOG_WARN("Rejecting ant with a path of " << static_cast<uint32_t>(len) << " hops");
+    return 0;
   }
-  return GetSerializedSize();
+  for (uint8_t k = 0; k < len; ++k) {
+    ReadFrom(i, m_path[k]);
+  }
+  m_pathLen = len;
+  return 1 + 4 + 8 + 4 + 4 + 1 + 4 * len;
 }
 
 void AntHeader::SetType(AntType t) { m_type = t; }
@@ -71,18 +71,29 @@ Ipv4Address AntHeader::GetDst() const { return m_dst; }
 void AntHeader::SetId(uint32_t id) { m_id = id; }
 uint32_t AntHeader::GetId() const { return m_id; }
 
-void AntHeader::SetLaunchTime(double t) { m_launchTime = t; }
-double AntHeader::GetLaunchTime() const { return m_launchTime; }
+void AntHeader::SetLaunchTime(Time t) { m_launchTime = t.GetNanoSeconds(); }
+Time AntHeader::GetLaunchTime() const { return NanoSeconds(m_launchTime); }
 
-void AntHeader::PushHop(Ipv4Address addr) { m_path.push_back(addr); }
+bool AntHeader::PushHop(Ipv4Address addr) {
+  if (m_pathLen >= MAX_PATH) return false;
+  m_path[m_pathLen++] = addr;
+  return true;
+}
 bool AntHeader::PopHop(Ipv4Address &addr) {
-  if (m_path.empty()) return false;
-  addr = m_path.back();
-  m_path.pop_back();
+  if (m_pathLen == 0) return false;
+  addr = m_path[--m_pathLen];
   return true;
 }
-const std::vector<Ipv4Address>& GetPath();
-const std::vector<Ipv4Address>& AntHeader::GetPath() const { return m_path; }
-void AntHeader::SetPath(const std::vector<Ipv4Address>& p) { m_path = p; }
+uint16_t AntHeader::GetPathLength() const { return m_pathLen; }
+Ipv4Address AntHeader::GetHop(uint16_t i) const { return i < m_pathLen ? m_path[i] : Ipv4Address(); }
+std::vector<Ipv4Address> AntHeader::GetPath() const {
+  return std::vector<Ipv4Address>(m_path.begin(), m_path.begin() + m_pathLen);
+}
+void AntHeader::SetPath(const std::vector<Ipv4Address>& p) {
+  m_pathLen = 0;
+  for (auto const& a : p) {
+    if (!PushHop(a)) break;
+  }
+}
 
 } // namespace ns3
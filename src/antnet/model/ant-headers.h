@@ -3,6 +3,8 @@
 
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include <array>
 #include <vector>
 
 namespace ns3 {
@@ -12,12 +14,18 @@ enum AntType : uint8_t { ANT_FORWARD = 1, ANT_BACKWARD = 2 };
 class AntHeader : public Header
 {
 public:
+  // Forward ants are dropped once they have been relayed this many times
+  static constexpr uint16_t MAX_HOPS = 16;
+  // Source + relays + destination
+  static constexpr uint16_t MAX_PATH = MAX_HOPS + 2;
+
   AntHeader();
   static TypeId GetTypeId();
   virtual TypeId GetInstanceTypeId() const;
   virtual void Print(std::ostream &os) const;
   virtual uint32_t GetSerializedSize() const;
   virtual void Serialize(Buffer::Iterator start) const;
+  // Returns 0, so that Packet::RemoveHeader fails, if the path is longer than MAX_PATH
   virtual uint32_t Deserialize(Buffer::Iterator start);
 
   void SetType(AntType t);
@@ -31,12 +39,15 @@ public:
   void SetId(uint32_t id);
   uint32_t GetId() const;
 
-  void SetLaunchTime(double t);
-  double GetLaunchTime() const;
+  void SetLaunchTime(Time t);
+  Time GetLaunchTime() const;
 
-  void PushHop(Ipv4Address addr);
+  // Returns false (and leaves the path untouched) when the path is full
+  bool PushHop(Ipv4Address addr);
   bool PopHop(Ipv4Address &addr);
-  const std::vector<Ipv4Address>& GetPath() const;
+  uint16_t GetPathLength() const;
+  Ipv4Address GetHop(uint16_t i) const;
+  std::vector<Ipv4Address> GetPath() const;
   void SetPath(const std::vector<Ipv4Address>& p);
 
 private:
@@ -44,8 +55,9 @@ private:
   Ipv4Address m_src;
   Ipv4Address m_dst;
   uint32_t m_id;
-  double m_launchTime; // seconds
-  std::vector<Ipv4Address> m_path; // reverse path for backward ants (top is back())
+  int64_t m_launchTime; // nanoseconds
+  uint8_t m_pathLen;
+  std::array<Ipv4Address, MAX_PATH> m_path; // reverse path for backward ants (top is last)
 };
 
 } // namespace ns3
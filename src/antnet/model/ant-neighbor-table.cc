@@ -0,0 +1,67 @@
+#include "ns3/ant-neighbor-table.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("AntNeighborTable");
+
+bool AntNeighborTable::Refresh(Ipv4Address nb, Time now, Time timeout) {
+  Time deadline = now + timeout;
+  auto it = m_index.find(nb.Get());
+  if (it != m_index.end()) {
+    Slot &s = m_slots[it->second];
+    // The old deadline stays queued and is skipped once it reaches the head
+    s.deadline = deadline;
+    m_deadlines.push_back({deadline, it->second});
+    return false;
+  }
+  uint32_t slot;
+  if (!m_free.empty()) { slot = m_free.back(); m_free.pop_back(); }
+  else { slot = static_cast<uint32_t>(m_slots.size()); m_slots.emplace_back(); }
+  m_slots[slot].addr = nb;
+  m_slots[slot].deadline = deadline;
+  m_slots[slot].used = true;
+  m_index[nb.Get()] = slot;
+  m_deadlines.push_back({deadline, slot});
+  Changed();
+  NS_LOG_INFO("Neighbor up " << nb << " slot=" << slot);
+  return true;
+}
+
+std::vector<Ipv4Address> AntNeighborTable::Purge(Time now) {
+  std::vector<Ipv4Address> dead;
+  while (!m_deadlines.empty() && m_deadlines.front().at < now) {
+    Deadline d = m_deadlines.front();
+    m_deadlines.pop_front();
+    Slot &s = m_slots[d.slot];
+    // Stale record: the slot was refreshed, freed or reused since
+    if (!s.used || s.deadline != d.at) continue;
+    dead.push_back(s.addr);
+    m_index.erase(s.addr.Get());
+    s.used = false;
+    m_free.push_back(d.slot);
+    NS_LOG_INFO("Neighbor expired " << s.addr << " slot=" << d.slot);
+  }
+  if (!dead.empty()) Changed();
+  return dead;
+}
+
+bool AntNeighborTable::IsNeighbor(Ipv4Address nb) const {
+  return m_index.count(nb.Get()) != 0;
+}
+
+int32_t AntNeighborTable::GetIndex(Ipv4Address nb) const {
+  auto it = m_index.find(nb.Get());
+  return it == m_index.end() ? -1 : static_cast<int32_t>(it->second);
+}
+
+void AntNeighborTable::Changed() {
+  m_list.clear();
+  m_list.reserve(m_index.size());
+  for (auto const& s : m_slots) {
+    if (s.used) m_list.push_back(s.addr);
+  }
+  m_version++;
+}
+
+} // namespace ns3
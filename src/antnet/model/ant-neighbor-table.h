@@ -0,0 +1,56 @@
+#ifndef ANT_NEIGHBOR_TABLE_H
+#define ANT_NEIGHBOR_TABLE_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// One-hop neighbors learned from hellos. Every neighbor owns a dense slot
+// that stays stable while it is alive; freed slots are reused. Expiry is
+// lazy: each refresh appends to a FIFO of deadlines and Purge() only looks
+// at the head, so the hello timer does not scan the whole table.
+class AntNeighborTable {
+public:
+  // Returns true if the neighbor was not known before
+  bool Refresh(Ipv4Address nb, Time now, Time timeout);
+  // Drops neighbors whose deadline passed and returns them
+  std::vector<Ipv4Address> Purge(Time now);
+
+  bool IsNeighbor(Ipv4Address nb) const;
+  int32_t GetIndex(Ipv4Address nb) const; // dense slot, -1 if unknown
+  bool IsEmpty() const { return m_index.empty(); }
+  uint32_t GetN() const { return static_cast<uint32_t>(m_index.size()); }
+
+  // Live neighbors; rebuilt only when the set changes
+  const std::vector<Ipv4Address>& GetList() const { return m_list; }
+  // Bumped whenever a neighbor is added or removed
+  uint32_t GetVersion() const { return m_version; }
+
+private:
+  struct Slot {
+    Ipv4Address addr;
+    Time deadline;
+    bool used = false;
+  };
+  struct Deadline {
+    Time at;
+    uint32_t slot;
+  };
+
+  void Changed();
+
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_free;
+  std::unordered_map<uint32_t, uint32_t> m_index; // address -> slot
+  std::deque<Deadline> m_deadlines;               // non-decreasing for a fixed timeout
+  std::vector<Ipv4Address> m_list;
+  uint32_t m_version = 0;
+};
+
+} // namespace ns3
+
+#endif // ANT_NEIGHBOR_TABLE_H
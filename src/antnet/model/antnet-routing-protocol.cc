@@ -9,7 +9,12 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/ipv4-raw-socket-factory.h"
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/node.h"  // for GetId()
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include <algorithm>
+#include <functional>
 
 namespace ns3 {
 
@@ -60,12 +65,55 @@ TypeId AntNetRoutingProtocol::GetTypeId() {
     .AddAttribute("Phi", "Power map for data route sampling",
                   DoubleValue(1.2),
                   MakeDoubleAccessor(&AntNetRoutingProtocol::m_phi),
-                  MakeDoubleChecker<double>());
+                  MakeDoubleChecker<double>())
+    .AddAttribute("SamplingMode", "How next hops are drawn from the pheromone table. Alias, "
+                  "the default, takes one uniform draw per packet where Direct takes one "
+                  "integer seed, so the same run number gives different routes in each mode",
+                  EnumValue(SAMPLING_ALIAS),
+                  MakeEnumAccessor<SamplingMode>(&AntNetRoutingProtocol::m_samplingMode),
+                  MakeEnumChecker(SAMPLING_DIRECT, "Direct",
+                                  SAMPLING_ALIAS, "Alias"))
+    .AddAttribute("AntBudget", "Max forward ants launched per second by this node; "
+                  "zero launches one ant per known destination every AntPeriod",
+                  DoubleValue(0.0),
+                  MakeDoubleAccessor(&AntNetRoutingProtocol::m_antBudget),
+                  MakeDoubleChecker<double>(0.0))
+    .AddAttribute("MaxAntJitter", "Max random delay added to each forward ant launch",
+                  TimeValue(MilliSeconds(10)),
+                  MakeTimeAccessor(&AntNetRoutingProtocol::m_antJitter),
+                  MakeTimeChecker())
+    .AddAttribute("DestinationTimeout", "Destinations without data traffic for this long "
+                  "stop receiving ants; zero keeps them forever",
+                  TimeValue(Seconds(30.0)),
+                  MakeTimeAccessor(&AntNetRoutingProtocol::m_destTimeout),
+                  MakeTimeChecker())
+    .AddAttribute("FlowPinTime", "Max time a data flow keeps its sampled next hop while "
+                  "that next hop keeps at least half of its pheromone; zero disables "
+                  "flow pinning",
+                  TimeValue(Seconds(1.0)),
+                  MakeTimeAccessor(&AntNetRoutingProtocol::m_flowPinTime),
+                  MakeTimeChecker())
+    .AddTraceSource("ForwardAntLaunch", "A forward ant was created and sent to its first hop",
+                    MakeTraceSourceAccessor(&AntNetRoutingProtocol::m_fwdLaunchTrace),
+                    "ns3::AntNetRoutingProtocol::AntTracedCallback")
+    .AddTraceSource("AntRelay", "A forward or backward ant was sent on to the next hop",
+                    MakeTraceSourceAccessor(&AntNetRoutingProtocol::m_antRelayTrace),
+                    "ns3::AntNetRoutingProtocol::AntTracedCallback")
+    .AddTraceSource("AntDrop", "A forward ant was discarded",
+                    MakeTraceSourceAccessor(&AntNetRoutingProtocol::m_antDropTrace),
+                    "ns3::AntNetRoutingProtocol::AntDropTracedCallback")
+    .AddTraceSource("Reinforce", "A backward ant reinforced a next hop (RTT and reward)",
+                    MakeTraceSourceAccessor(&AntNetRoutingProtocol::m_reinforceTrace),
+                    "ns3::AntNetRoutingProtocol::ReinforceTracedCallback")
+    .AddTraceSource("NextHop", "Next hop chosen for a data packet",
+                    MakeTraceSourceAccessor(&AntNetRoutingProtocol::m_nextHopTrace),
+                    "ns3::AntNetRoutingProtocol::NextHopTracedCallback");
   return tid;
 }
 
 AntNetRoutingProtocol::AntNetRoutingProtocol()
   : m_running(false),
+    m_sendingControl(false),
     m_ipv4(nullptr),
     m_antSocket(nullptr),
     m_helloSocket(nullptr),
@@ -79,6 +127,12 @@ AntNetRoutingProtocol::AntNetRoutingProtocol()
     m_helloPeriod(Seconds(1.0)),
     m_neighborTimeout(Seconds(3.0)),
     m_antPeriod(Seconds(1.0)),
+    m_samplingMode(SAMPLING_ALIAS),
+    m_flowPinTime(Seconds(1.0)),
+    m_antBudget(0.0),
+    m_antJitter(MilliSeconds(10)),
+    m_destTimeout(Seconds(30.0)),
+    m_antCredit(0.0),
     m_antSeq(1)
 {
   m_rng = CreateObject<UniformRandomVariable>();
@@ -96,6 +150,7 @@ void AntNetRoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4) {
     return;
   }
   m_ipv4 = ipv4;
+  RebuildAddressIndex();
   Simulator::ScheduleNow(&AntNetRoutingProtocol::Start, this);
 }
 
@@ -114,6 +169,8 @@ void AntNetRoutingProtocol::Stop() {
   if (m_helloSocket) { m_helloSocket->Close(); m_helloSocket = nullptr; }
   if (m_helloEvent.IsPending()) m_helloEvent.Cancel();
   if (m_antEvent.IsPending()) m_antEvent.Cancel();
+  for (auto &ev : m_pendingAnts) ev.Cancel();
+  m_pendingAnts.clear();
 }
 
 void AntNetRoutingProtocol::CreateSockets() {
@@ -138,17 +195,16 @@ void AntNetRoutingProtocol::SendHello() {
   for (uint32_t i=0; i<m_ipv4->GetNInterfaces(); ++i) {
     for (uint32_t j=0; j<m_ipv4->GetNAddresses(i); ++j) {
       Ipv4InterfaceAddress ifaddr = m_ipv4->GetAddress(i, j);
-      if (ifaddr.GetMask() == Ipv4Mask::GetZero()) continue;
-      Ipv4Address bcast = ifaddr.GetBroadcast();
-      m_helloSocket->SendTo(p->Copy(), 0, InetSocketAddress(bcast, m_helloPort));
+      if (ifaddr.GetMask() == Ipv4Mask::GetZero() || ifaddr.GetLocal().IsLocalhost()) continue;
+      SendControl(m_helloSocket, p->Copy(), ifaddr.GetBroadcast(), m_helloPort);
     }
   }
   Time now = Simulator::Now();
-  std::vector<Ipv4Address> toErase;
-  for (auto const& kv : m_neighbors) {
-    if (now - kv.second > m_neighborTimeout) toErase.push_back(kv.first);
+  for (auto const& a : m_neighbors.Purge(now)) m_ph.RemoveNextHop(a);
+  for (auto it = m_flows.begin(); it != m_flows.end();) {
+    if (now - it->second.lastUsed > m_flowPinTime) it = m_flows.erase(it);
+    else ++it;
   }
-  for (auto const& a : toErase) m_neighbors.erase(a);
   m_helloEvent = Simulator::Schedule(m_helloPeriod, &AntNetRoutingProtocol::SendHello, this);
 }
 
@@ -157,41 +213,98 @@ void AntNetRoutingProtocol::RecvHello(Ptr<Socket> socket) {
   Ptr<Packet> p = socket->RecvFrom(from);
   InetSocketAddress isa = InetSocketAddress::ConvertFrom(from);
   Ipv4Address peer = isa.GetIpv4();
-  m_neighbors[peer] = Simulator::Now();
+  m_neighbors.Refresh(peer, Simulator::Now(), m_neighborTimeout);
   NS_LOG_INFO("RecvHello from=" << peer);
 }
 
+void AntNetRoutingProtocol::SendControl(Ptr<Socket> socket, Ptr<Packet> p, Ipv4Address to, uint16_t port) {
+  m_sendingControl = true;
+  socket->SendTo(p, 0, InetSocketAddress(to, port));
+  m_sendingControl = false;
+}
+
 void AntNetRoutingProtocol::ScheduleAnt() {
   LaunchAntsForKnownDestinations();
   m_antEvent = Simulator::Schedule(m_antPeriod, &AntNetRoutingProtocol::ScheduleAnt, this);
 }
 
 void AntNetRoutingProtocol::LaunchAntsForKnownDestinations() {
-  for (auto const& d : m_knownDestinations) {
-    if (!IsMyAddress(d)) SendForwardAnt(d);
+  Time now = Simulator::Now();
+  // Jitter can push a launch of the previous period past its end
+  m_pendingAnts.erase(std::remove_if(m_pendingAnts.begin(), m_pendingAnts.end(),
+                                     [](const EventId& ev) { return ev.IsExpired(); }),
+                      m_pendingAnts.end());
+  std::vector<std::pair<double, Ipv4Address>> cand;
+  double maxTraffic = 0.0;
+  for (auto it = m_destinations.begin(); it != m_destinations.end();) {
+    if (m_destTimeout.IsStrictlyPositive() && now - it->second.lastSeen > m_destTimeout) {
+      it = m_destinations.erase(it);
+      continue;
+    }
+    maxTraffic = std::max(maxTraffic, it->second.traffic);
+    ++it;
   }
+  for (auto &kv : m_destinations) {
+    if (IsMyAddress(kv.first)) continue;
+    DestInfo &di = kv.second;
+    // Busy destinations with undecided pheromones go first; the age term keeps
+    // converged or quiet destinations from starving
+    double volume = maxTraffic > 0 ? di.traffic / maxTraffic : 0.0;
+    double entropy = m_ph.GetEntropy(kv.first);
+    double age = (now - di.lastAnt).GetSeconds() / m_antPeriod.GetSeconds();
+    cand.push_back({(1.0 + volume) * (0.05 + entropy) * age, kv.first});
+    di.traffic *= 0.5;
+  }
+  size_t n = cand.size();
+  if (m_antBudget > 0) {
+    m_antCredit = std::min(m_antCredit + m_antBudget * m_antPeriod.GetSeconds(),
+                           std::max(1.0, m_antBudget * m_antPeriod.GetSeconds()));
+    n = std::min(n, static_cast<size_t>(m_antCredit));
+    m_antCredit -= n;
+    std::partial_sort(cand.begin(), cand.begin() + n, cand.end(),
+                      [](const std::pair<double, Ipv4Address>& a, const std::pair<double, Ipv4Address>& b) {
+                        return a.first > b.first || (a.first == b.first && a.second < b.second);
+                      });
+  }
+  // Spread the batch over the period so ants do not collide on the medium
+  for (size_t i = 0; i < n; ++i) {
+    Time offset = m_antPeriod * (static_cast<double>(i) / n);
+    if (m_antJitter.IsStrictlyPositive()) {
+      offset += Seconds(m_rng->GetValue(0.0, m_antJitter.GetSeconds()));
+    }
+    m_destinations[cand[i].second].lastAnt = now + offset;
+    m_pendingAnts.push_back(
+      Simulator::Schedule(offset, &AntNetRoutingProtocol::LaunchAnt, this, cand[i].second));
+  }
+}
+
+void AntNetRoutingProtocol::LaunchAnt(Ipv4Address dst) {
+  if (m_running) SendForwardAnt(dst);
 }
 
 void AntNetRoutingProtocol::SendForwardAnt(Ipv4Address dst) {
-  if (m_neighbors.empty()) return;
+  if (m_neighbors.IsEmpty()) return;
   AntHeader h;
   h.SetType(ANT_FORWARD);
   h.SetSrc(GetPrimaryAddress());
   h.SetDst(dst);
   h.SetId(m_antSeq++);
-  h.SetLaunchTime(Simulator::Now().GetSeconds());
+  h.SetLaunchTime(Simulator::Now());
   h.PushHop(GetPrimaryAddress());
 
-  std::vector<Ipv4Address> nbs;
-  nbs.reserve(m_neighbors.size());
-  for (auto const& kv : m_neighbors) nbs.push_back(kv.first);
-  m_ph.EnsureDest(dst, nbs);
-  Ipv4Address nh = m_ph.SampleNextHop(dst, m_betaAnt, m_rng->GetInteger(1, 0x7fffffff));
-  if (nh == Ipv4Address()) return;
+  m_ph.EnsureDest(dst, m_neighbors.GetList(), m_neighbors.GetVersion());
+  Ipv4Address nh = SampleNextHop(dst, m_betaAnt);
+  if (nh == Ipv4Address()) {
+    m_stats.dropNoNextHop++;
+    m_antDropTrace(h, ANT_DROP_NO_NEXT_HOP);
+    return;
+  }
 
   Ptr<Packet> p = Create<Packet>();
   p->AddHeader(h);
-  m_antSocket->SendTo(p, 0, InetSocketAddress(nh, m_antPort));
+  SendControl(m_antSocket, p, nh, m_antPort);
+  m_stats.fwdLaunched++;
+  m_fwdLaunchTrace(h, nh);
   NS_LOG_INFO("SendForwardAnt id=" << h.GetId() << " dst=" << dst << " nh=" << nh);
 }
 
@@ -202,49 +315,135 @@ void AntNetRoutingProtocol::RecvAnt(Ptr<Socket> socket) {
   Ipv4Address prev = isa.GetIpv4();
 
   AntHeader h;
-  if (p->PeekHeader(h), p->RemoveHeader(h), true) {
-    if (h.GetType() == ANT_FORWARD) { // ANT_FORWARD
-      if (IsMyAddress(h.GetDst())) { // arrived at destination
-        NS_LOG_INFO("FWD arrives at dst=" << h.GetDst() << " -> turn BACKWARD id=" << h.GetId());
-        h.SetType(ANT_BACKWARD);
-        h.PushHop(GetPrimaryAddress());
-        Ipv4Address back;
-        if (h.PopHop(back) && h.PopHop(back)) {
-          Ptr<Packet> qq = Create<Packet>();
-          qq->AddHeader(h);
-          m_antSocket->SendTo(qq, 0, InetSocketAddress(back, m_antPort));
-        }
-        return;
-      } else { // relay
-        auto path = h.GetPath();
-        if (!path.empty() && path.size() > 16) { return; }
-        h.PushHop(GetPrimaryAddress());
-        std::vector<Ipv4Address> nbs;
-        for (auto const& kv : m_neighbors) nbs.push_back(kv.first);
-        m_ph.EnsureDest(h.GetDst(), nbs);
-        Ipv4Address nh = m_ph.SampleNextHop(h.GetDst(), m_betaAnt, m_rng->GetInteger(1, 0x7fffffff));
-        NS_LOG_INFO("FWD relay id=" << h.GetId() << " dst=" << h.GetDst() << " next=" << nh);
-        if (nh == Ipv4Address()) return;
-        Ptr<Packet> q = Create<Packet>();
-        q->AddHeader(h);
-        m_antSocket->SendTo(q, 0, InetSocketAddress(nh, m_antPort));
-      }
-    } else { // ANT_BACKWARD
-      double T = Simulator::Now().GetSeconds() - h.GetLaunchTime();
-      NS_LOG_INFO("BWD id=" << h.GetId() << " dst=" << h.GetDst() << " T=" << T);
-      m_ph.ObserveRtt(h.GetDst(), T, m_eta);
-      double r = m_ph.GetReinforcement(h.GetDst(), T);
-      std::vector<Ipv4Address> nbs;
-      for (auto const& kv : m_neighbors) nbs.push_back(kv.first);
-      m_ph.Reinforce(h.GetDst(), prev, r, m_alphaLearn, nbs);
+  if (p->RemoveHeader(h) == 0) return;
+  // The received packet is reused for the next hop; only its header changes
+  p->RemoveAllPacketTags();
+  p->RemoveAllByteTags();
+  if (h.GetType() == ANT_FORWARD) { // ANT_FORWARD
+    if (IsMyAddress(h.GetDst())) { // arrived at destination
+      NS_LOG_INFO("FWD arrives at dst=" << h.GetDst() << " -> turn BACKWARD id=" << h.GetId());
+      m_stats.fwdArrived++;
+      h.SetType(ANT_BACKWARD);
+      h.PushHop(GetPrimaryAddress());
       Ipv4Address back;
       if (h.PopHop(back) && h.PopHop(back)) {
-        Ptr<Packet> q = Create<Packet>();
-        q->AddHeader(h);
-        m_antSocket->SendTo(q, 0, InetSocketAddress(back, m_antPort));
+        p->AddHeader(h);
+        SendControl(m_antSocket, p, back, m_antPort);
+      }
+      return;
+    } else { // relay
+      if (h.GetPathLength() > AntHeader::MAX_HOPS) {
+        m_stats.dropHopLimit++;
+        m_antDropTrace(h, ANT_DROP_HOP_LIMIT);
+        return;
+      }
+      h.PushHop(GetPrimaryAddress());
+      m_ph.EnsureDest(h.GetDst(), m_neighbors.GetList(), m_neighbors.GetVersion());
+      Ipv4Address nh = SampleNextHop(h.GetDst(), m_betaAnt);
+      NS_LOG_INFO("FWD relay id=" << h.GetId() << " dst=" << h.GetDst() << " next=" << nh);
+      if (nh == Ipv4Address()) {
+        m_stats.dropNoNextHop++;
+        m_antDropTrace(h, ANT_DROP_NO_NEXT_HOP);
+        return;
       }
+      p->AddHeader(h);
+      SendControl(m_antSocket, p, nh, m_antPort);
+      m_stats.fwdRelayed++;
+      m_antRelayTrace(h, nh);
     }
+  } else { // ANT_BACKWARD
+    double T = (Simulator::Now() - h.GetLaunchTime()).GetSeconds();
+    NS_LOG_INFO("BWD id=" << h.GetId() << " dst=" << h.GetDst() << " T=" << T);
+    m_ph.ObserveRtt(h.GetDst(), T, m_eta);
+    double r = m_ph.GetReinforcement(h.GetDst(), T);
+    m_ph.Reinforce(h.GetDst(), prev, r, m_alphaLearn, m_neighbors.GetList());
+    m_stats.reinforcements++;
+    m_stats.reinforcementSum += r;
+    m_reinforceTrace(h.GetDst(), prev, Seconds(T), r);
+    Ipv4Address back;
+    if (h.PopHop(back) && h.PopHop(back)) {
+      p->AddHeader(h);
+      SendControl(m_antSocket, p, back, m_antPort);
+      m_stats.bwdRelayed++;
+      m_antRelayTrace(h, back);
+    } else {
+      m_stats.bwdEnded++;
+    }
+  }
+}
+
+Ipv4Address AntNetRoutingProtocol::SampleNextHop(Ipv4Address dst, double beta) {
+  if (m_samplingMode == SAMPLING_ALIAS) {
+    return m_ph.SampleNextHopCached(dst, beta, m_rng->GetValue());
+  }
+  return m_ph.SampleNextHop(dst, beta, m_rng->GetInteger(1, 0x7fffffff));
+}
+
+bool AntNetRoutingProtocol::GetPorts(Ptr<const Packet> p, uint8_t proto,
+                                     uint16_t& sport, uint16_t& dport) {
+  if (!p || (proto != TcpL4Protocol::PROT_NUMBER && proto != UdpL4Protocol::PROT_NUMBER) ||
+      p->GetSize() < 8) {
+    return false;
+  }
+  uint8_t l4[8];
+  p->CopyData(l4, 8);
+  // The UDP length covers the whole datagram only if its header is attached
+  uint32_t udpLength = (l4[4] << 8) | l4[5];
+  if (proto == UdpL4Protocol::PROT_NUMBER && udpLength != p->GetSize()) return false;
+  sport = (l4[0] << 8) | l4[1];
+  dport = (l4[2] << 8) | l4[3];
+  return true;
+}
+
+Ptr<Ipv4Route> AntNetRoutingProtocol::SampleRoute(Ipv4Address dst) {
+  m_ph.EnsureDest(dst, m_neighbors.GetList(), m_neighbors.GetVersion());
+  return BuildRoute(dst, SampleNextHop(dst, m_betaData));
+}
+
+Ptr<Ipv4Route> AntNetRoutingProtocol::RouteData(const Ipv4Header &header, uint16_t sport, uint16_t dport) {
+  Ipv4Address dst = header.GetDestination();
+  Time now = Simulator::Now();
+  DestInfo &di = m_destinations[dst];
+  di.lastSeen = now;
+  di.traffic += 1.0;
+  FlowKey k{header.GetSource().Get(), dst.Get(), sport, dport, header.GetProtocol()};
+  if (m_flowPinTime.IsStrictlyPositive()) {
+    auto it = m_flows.find(k);
+    if (it != m_flows.end()) {
+      FlowEntry &fe = it->second;
+      bool holds = now - fe.pinnedAt < m_flowPinTime;
+      if (holds && fe.phVersion != m_ph.GetVersion(dst)) {
+        // Small pheromone updates keep the pin; it is dropped once the next
+        // hop has lost half of its mass or has gone
+        holds = m_ph.GetProbability(dst, fe.route->GetGateway()) >= 0.5 * fe.pinnedMass;
+        fe.phVersion = m_ph.GetVersion(dst);
+      }
+      if (holds) {
+        fe.lastUsed = now;
+        m_stats.dataRouted++;
+        m_nextHopTrace(dst, fe.route->GetGateway());
+        return fe.route;
+      }
+    }
+  }
+  Ptr<Ipv4Route> rt = SampleRoute(dst);
+  if (!rt) {
+    m_flows.erase(k);
+    m_stats.dataNoRoute++;
+    return nullptr;
+  }
+  Ipv4Address nh = rt->GetGateway();
+  if (m_flowPinTime.IsStrictlyPositive()) {
+    FlowEntry &fe = m_flows[k];
+    fe.route = rt;
+    fe.phVersion = m_ph.GetVersion(dst);
+    fe.pinnedMass = m_ph.GetProbability(dst, nh);
+    fe.pinnedAt = now;
+    fe.lastUsed = now;
   }
+  m_stats.dataRouted++;
+  m_nextHopTrace(dst, nh);
+  return rt;
 }
 
 Ptr<Ipv4Route> AntNetRoutingProtocol::BuildRoute(Ipv4Address dest, Ipv4Address nextHop) const {
@@ -259,17 +458,43 @@ Ptr<Ipv4Route> AntNetRoutingProtocol::BuildRoute(Ipv4Address dest, Ipv4Address n
   return rt;
 }
 
+Ptr<Ipv4Route> AntNetRoutingProtocol::RouteControl(Ipv4Address dst) const {
+  int32_t ifIndex = FindInterfaceForNextHop(dst);
+  if (ifIndex < 0) return nullptr;
+  Ipv4InterfaceAddress ifaddr = m_ipv4->GetAddress(ifIndex, 0);
+  Ptr<Ipv4Route> rt = Create<Ipv4Route>();
+  rt->SetDestination(dst);
+  rt->SetGateway(dst == ifaddr.GetBroadcast() ? Ipv4Address::GetAny() : dst);
+  rt->SetSource(ifaddr.GetLocal());
+  rt->SetOutputDevice(m_ipv4->GetNetDevice(ifIndex));
+  return rt;
+}
+
 Ptr<Ipv4Route> AntNetRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header& header,
                              Ptr<NetDevice> oif, Socket::SocketErrno& sockerr) {
   Ipv4Address dst = header.GetDestination();
   if (IsMyAddress(dst)) { sockerr = Socket::ERROR_NOROUTETOHOST; return nullptr; }
-  m_knownDestinations.insert(dst);
-  std::vector<Ipv4Address> nbs;
-  for (auto const& kv : m_neighbors) nbs.push_back(kv.first);
-  m_ph.EnsureDest(dst, nbs);
-  Ipv4Address nh = m_ph.SampleNextHop(dst, m_betaData, m_rng->GetInteger(1, 0x7fffffff));
-  NS_LOG_INFO("RouteOutput dst=" << dst << " nh=" << nh);
-  Ptr<Ipv4Route> rt = BuildRoute(dst, nh);
+  // Ants and hellos are not data: they neither register a destination nor add
+  // to its traffic volume
+  if (m_sendingControl) {
+    Ptr<Ipv4Route> rt = RouteControl(dst);
+    sockerr = rt ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+    return rt;
+  }
+  // TCP looks up a route without a packet to choose the source address of a
+  // connection, which is not data
+  if (!p) {
+    Ptr<Ipv4Route> rt = SampleRoute(dst);
+    sockerr = rt ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+    return rt;
+  }
+  // TCP attaches its header before the lookup, and UDP does when the socket is
+  // bound to a local address; otherwise the ports are unknown and the local
+  // flows to the same destination share a pin
+  uint16_t sport = 0, dport = 0;
+  GetPorts(p, header.GetProtocol(), sport, dport);
+  Ptr<Ipv4Route> rt = RouteData(header, sport, dport);
+  NS_LOG_INFO("RouteOutput dst=" << dst << " nh=" << (rt ? rt->GetGateway() : Ipv4Address()));
   if (rt) { sockerr = Socket::ERROR_NOTERROR; return rt; }
   sockerr = Socket::ERROR_NOROUTETOHOST; return nullptr;
 }
@@ -288,65 +513,114 @@ bool AntNetRoutingProtocol::RouteInput(Ptr<const Packet> p, const Ipv4Header &he
     }
     return false;
   }
-  m_knownDestinations.insert(dst);
-  std::vector<Ipv4Address> nbs;
-  for (auto const& kv : m_neighbors) nbs.push_back(kv.first);
-  m_ph.EnsureDest(dst, nbs);
-  Ipv4Address nh = m_ph.SampleNextHop(dst, m_betaData, m_rng->GetInteger(1, 0x7fffffff));
-  Ptr<Ipv4Route> rt = BuildRoute(dst, nh);
+  uint16_t sport = 0, dport = 0;
+  GetPorts(p, header.GetProtocol(), sport, dport);
+  Ptr<Ipv4Route> rt = RouteData(header, sport, dport);
   if (rt && !ucb.IsNull()) { ucb(rt, p, header); return true; }
   if (!ecb.IsNull()) ecb(p, header, Socket::ERROR_NOROUTETOHOST);
   return false;
 }
 
-void AntNetRoutingProtocol::NotifyInterfaceUp(uint32_t interface) {}
-void AntNetRoutingProtocol::NotifyInterfaceDown(uint32_t interface) {}
-void AntNetRoutingProtocol::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) {}
-void AntNetRoutingProtocol::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) {}
+void AntNetRoutingProtocol::NotifyInterfaceUp(uint32_t interface) { RebuildAddressIndex(); }
+void AntNetRoutingProtocol::NotifyInterfaceDown(uint32_t interface) { RebuildAddressIndex(); }
+void AntNetRoutingProtocol::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+  RebuildAddressIndex();
+}
+void AntNetRoutingProtocol::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+  RebuildAddressIndex();
+}
 
 void AntNetRoutingProtocol::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const {
-  *stream->GetStream() << "Node " << GetObject<Node>()->GetId() << " AntNet P-table\n";
+  std::ostream &os = *stream->GetStream();
+  os << "Node " << GetObject<Node>()->GetId() << ", Time: " << Simulator::Now().As(unit)
+     << ", AntNet P-table (" << m_neighbors.GetN() << " neighbors)\n";
+  m_ph.Print(os);
+  os << std::endl;
 }
 
-bool AntNetRoutingProtocol::IsMyAddress(Ipv4Address a) const {
-  for (uint32_t i=0; i<m_ipv4->GetNInterfaces(); ++i) {
-    for (uint32_t j=0; j<m_ipv4->GetNAddresses(i); ++j) {
-      if (m_ipv4->GetAddress(i,j).GetLocal() == a) return true;
-    }
+void AntNetRoutingProtocol::PrintStats(std::ostream& os) const {
+  os << "fwdLaunched=" << m_stats.fwdLaunched << " fwdRelayed=" << m_stats.fwdRelayed
+     << " fwdArrived=" << m_stats.fwdArrived << " bwdRelayed=" << m_stats.bwdRelayed
+     << " bwdEnded=" << m_stats.bwdEnded << " dropHopLimit=" << m_stats.dropHopLimit
+     << " dropNoNextHop=" << m_stats.dropNoNextHop << " reinforcements=" << m_stats.reinforcements
+     << " meanReinforcement="
+     << (m_stats.reinforcements ? m_stats.reinforcementSum / m_stats.reinforcements : 0.0)
+     << " dataRouted=" << m_stats.dataRouted << " dataNoRoute=" << m_stats.dataNoRoute << "\n";
+  for (auto const& d : m_ph.GetDestinations()) {
+    const LocalStats *st = m_ph.GetStats(d);
+    if (st) os << "  rtt " << d << " ewma=" << st->mu << " best=" << st->wbest << " samples=" << st->wcount << "\n";
   }
-  return false;
 }
 
-Ipv4Address AntNetRoutingProtocol::GetPrimaryAddress() const {
-  for (uint32_t i=0; i<m_ipv4->GetNInterfaces(); ++i) {
-    for (uint32_t j=0; j<m_ipv4->GetNAddresses(i); ++j) {
-      Ipv4InterfaceAddress ifaddr = m_ipv4->GetAddress(i,j);
-      if (ifaddr.GetMask() != Ipv4Mask::GetZero()) return ifaddr.GetLocal();
-    }
-  }
-  return Ipv4Address("0.0.0.0");
+void AntNetRoutingProtocol::SaveSnapshot(std::ostream& os) const {
+  m_ph.Save(os);
 }
 
-int32_t AntNetRoutingProtocol::FindInterfaceForAddress(Ipv4Address a) const {
-  for (uint32_t i=0; i<m_ipv4->GetNInterfaces(); ++i) {
-    for (uint32_t j=0; j<m_ipv4->GetNAddresses(i); ++j) {
-      if (m_ipv4->GetAddress(i,j).GetLocal() == a) return static_cast<int32_t>(i);
-    }
-  }
-  return -1;
+bool AntNetRoutingProtocol::LoadSnapshot(std::istream& is) {
+  m_flows.clear();
+  return m_ph.Load(is);
 }
 
-int32_t AntNetRoutingProtocol::FindInterfaceForNextHop(Ipv4Address nh) const {
+void AntNetRoutingProtocol::RebuildAddressIndex() {
+  m_localIfIndex.clear();
+  m_prefixIfIndex.clear();
+  m_prefixLengths.clear();
+  m_primaryAddress = Ipv4Address("0.0.0.0");
+  m_flows.clear(); // pinned routes may point at a stale interface
+  if (m_ipv4 == nullptr) return;
+  bool havePrimary = false;
+  // Interfaces are visited in order and first insertion wins, matching a linear scan
   for (uint32_t i=0; i<m_ipv4->GetNInterfaces(); ++i) {
     for (uint32_t j=0; j<m_ipv4->GetNAddresses(i); ++j) {
       Ipv4InterfaceAddress ifaddr = m_ipv4->GetAddress(i,j);
+      m_localIfIndex.insert({ifaddr.GetLocal().Get(), static_cast<int32_t>(i)});
       Ipv4Mask m = ifaddr.GetMask();
       if (m == Ipv4Mask::GetZero()) continue;
-      if ( (ifaddr.GetLocal().CombineMask(m)).Get() == (nh.CombineMask(m)).Get() ) {
-        return static_cast<int32_t>(i);
+      if (!havePrimary) { m_primaryAddress = ifaddr.GetLocal(); havePrimary = true; }
+      if (!m_ipv4->IsUp(i)) continue;
+      uint16_t len = m.GetPrefixLength();
+      uint64_t key = (static_cast<uint64_t>(ifaddr.GetLocal().CombineMask(m).Get()) << 8) | len;
+      if (m_prefixIfIndex.insert({key, static_cast<int32_t>(i)}).second &&
+          std::find(m_prefixLengths.begin(), m_prefixLengths.end(), len) == m_prefixLengths.end()) {
+        m_prefixLengths.push_back(len);
       }
     }
   }
+  std::sort(m_prefixLengths.begin(), m_prefixLengths.end(), std::greater<uint16_t>());
+}
+
+double AntNetRoutingProtocol::GetMeanEntropy() const {
+  double sum = 0.0;
+  uint32_t n = 0;
+  for (auto const& kv : m_destinations) {
+    if (IsMyAddress(kv.first)) continue;
+    sum += m_ph.GetEntropy(kv.first);
+    n++;
+  }
+  return n > 0 ? sum / n : -1.0;
+}
+
+bool AntNetRoutingProtocol::IsMyAddress(Ipv4Address a) const {
+  return m_localIfIndex.count(a.Get()) != 0;
+}
+
+Ipv4Address AntNetRoutingProtocol::GetPrimaryAddress() const {
+  return m_primaryAddress;
+}
+
+int32_t AntNetRoutingProtocol::FindInterfaceForAddress(Ipv4Address a) const {
+  auto it = m_localIfIndex.find(a.Get());
+  return it == m_localIfIndex.end() ? -1 : it->second;
+}
+
+int32_t AntNetRoutingProtocol::FindInterfaceForNextHop(Ipv4Address nh) const {
+  // Longest prefix first; typically only one or two distinct lengths exist
+  for (uint16_t len : m_prefixLengths) {
+    uint32_t mask = len == 0 ? 0 : (0xffffffffu << (32 - len));
+    uint64_t key = (static_cast<uint64_t>(nh.Get() & mask) << 8) | len;
+    auto it = m_prefixIfIndex.find(key);
+    if (it != m_prefixIfIndex.end()) return it->second;
+  }
   return -1;
 }
 
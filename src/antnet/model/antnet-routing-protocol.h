@@ -7,16 +7,51 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
 #include "ns3/pheromone-table.h"
 #include "ns3/ant-headers.h"
+#include "ns3/ant-neighbor-table.h"
 #include <set>
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
 class AntNetRoutingProtocol : public Ipv4RoutingProtocol
 {
 public:
+  // The two modes consume the random stream differently, so switching mode
+  // changes the routes of a scenario even with the same seed and run number
+  enum SamplingMode {
+    SAMPLING_DIRECT, // recompute weights and seed a fresh PRNG per packet
+    SAMPLING_ALIAS,  // cached per-destination alias tables, one draw per packet
+  };
+
+  enum AntDropReason {
+    ANT_DROP_HOP_LIMIT,   // forward ant exceeded AntHeader::MAX_HOPS
+    ANT_DROP_NO_NEXT_HOP, // no neighbor to forward to
+  };
+
+  // Per-node counters, always maintained (no logging needed)
+  struct Stats {
+    uint64_t fwdLaunched = 0;   // forward ants created here
+    uint64_t fwdRelayed = 0;    // forward ants relayed
+    uint64_t fwdArrived = 0;    // forward ants that reached this node as destination
+    uint64_t bwdRelayed = 0;    // backward ants processed and sent on
+    uint64_t bwdEnded = 0;      // backward ants whose return path ended here
+    uint64_t dropHopLimit = 0;
+    uint64_t dropNoNextHop = 0;
+    uint64_t reinforcements = 0;
+    double reinforcementSum = 0.0;
+    uint64_t dataRouted = 0;    // data packets given a route
+    uint64_t dataNoRoute = 0;   // data packets without a route
+  };
+
+  typedef void (*AntTracedCallback)(const AntHeader& header, Ipv4Address nextHop);
+  typedef void (*AntDropTracedCallback)(const AntHeader& header, AntDropReason reason);
+  typedef void (*ReinforceTracedCallback)(Ipv4Address dest, Ipv4Address via, Time rtt, double r);
+  typedef void (*NextHopTracedCallback)(Ipv4Address dest, Ipv4Address nextHop);
+
   static TypeId GetTypeId();
   AntNetRoutingProtocol();
   virtual ~AntNetRoutingProtocol();
@@ -35,7 +70,56 @@ public:
   void SetIpv4(Ptr<Ipv4> ipv4) override;
   void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const override;
 
+  // Mean normalized pheromone entropy over the destinations this node routes
+  // data to; negative if there are none. Lower means more converged.
+  double GetMeanEntropy() const;
+
+  // Pheromone and delay-statistics state, see PheromoneTable::Save/Load.
+  // Loading replaces the table and drops pinned flows.
+  void SaveSnapshot(std::ostream& os) const;
+  bool LoadSnapshot(std::istream& is);
+
+  const Stats& GetStats() const { return m_stats; }
+  // Data flows currently pinned to a next hop
+  uint32_t GetNPinnedFlows() const { return static_cast<uint32_t>(m_flows.size()); }
+  // Counters plus the RTT EWMA of every destination with samples
+  void PrintStats(std::ostream& os) const;
+  const PheromoneTable& GetPheromoneTable() const { return m_ph; }
+
 private:
+  // 5-tuple identifying a data flow for next-hop pinning
+  struct FlowKey {
+    uint32_t src;
+    uint32_t dst;
+    uint16_t sport;
+    uint16_t dport;
+    uint8_t proto;
+    bool operator==(const FlowKey& o) const {
+      return src == o.src && dst == o.dst && sport == o.sport && dport == o.dport && proto == o.proto;
+    }
+  };
+  struct FlowKeyHash {
+    size_t operator()(const FlowKey& k) const {
+      uint64_t h = (static_cast<uint64_t>(k.src) << 32) ^ k.dst;
+      h ^= (static_cast<uint64_t>(k.sport) << 24) ^ (static_cast<uint64_t>(k.dport) << 8) ^ k.proto;
+      h *= 0x9e3779b97f4a7c15ull;
+      return static_cast<size_t>(h ^ (h >> 32));
+    }
+  };
+  // Per-destination bookkeeping for the ant scheduler
+  struct DestInfo {
+    Time lastSeen;        // last data packet routed towards it
+    Time lastAnt;         // last forward ant launched towards it
+    double traffic = 0.0; // data packets, halved every ant period
+  };
+  struct FlowEntry {
+    Ptr<Ipv4Route> route;
+    uint32_t phVersion = 0; // pheromone bucket version last checked
+    double pinnedMass = 0;  // pheromone of the next hop when pinned
+    Time pinnedAt;
+    Time lastUsed;
+  };
+
   void Start();
   void Stop();
 
@@ -44,16 +128,29 @@ private:
   void RecvHello(Ptr<Socket> socket);
   void SendForwardAnt(Ipv4Address dst);
   void RecvAnt(Ptr<Socket> socket);
+  // Sends an ant or hello; RouteOutput routes it on-link and does not count it as data
+  void SendControl(Ptr<Socket> socket, Ptr<Packet> p, Ipv4Address to, uint16_t port);
   void ScheduleAnt();
   void LaunchAntsForKnownDestinations();
+  void LaunchAnt(Ipv4Address dst);
 
+  void RebuildAddressIndex();
   bool IsMyAddress(Ipv4Address a) const;
   Ipv4Address GetPrimaryAddress() const;
   int32_t FindInterfaceForAddress(Ipv4Address a) const;
   int32_t FindInterfaceForNextHop(Ipv4Address nh) const;
+  Ipv4Address SampleNextHop(Ipv4Address dst, double beta);
+  // Reads the ports of a TCP or UDP packet whose L4 header is attached
+  static bool GetPorts(Ptr<const Packet> p, uint8_t proto, uint16_t& sport, uint16_t& dport);
+  // Samples a next hop for a destination without pinning
+  Ptr<Ipv4Route> SampleRoute(Ipv4Address dst);
+  Ptr<Ipv4Route> RouteData(const Ipv4Header &header, uint16_t sport, uint16_t dport);
   Ptr<Ipv4Route> BuildRoute(Ipv4Address dest, Ipv4Address nextHop) const;
+  // Routes a control packet to a neighbor or to a subnet broadcast address
+  Ptr<Ipv4Route> RouteControl(Ipv4Address dst) const;
 
   bool m_running;
+  bool m_sendingControl; // set while an ant or hello is handed to a socket
 
   Ptr<Ipv4> m_ipv4;
   Ptr<Socket> m_antSocket;
@@ -71,11 +168,31 @@ private:
   Time m_helloPeriod;
   Time m_neighborTimeout;
   Time m_antPeriod;
-
-  std::map<Ipv4Address, Time> m_neighbors;
-  std::set<Ipv4Address> m_knownDestinations;
+  SamplingMode m_samplingMode;
+  Time m_flowPinTime;
+  double m_antBudget;
+  Time m_antJitter;
+  Time m_destTimeout;
+  double m_antCredit;
+
+  // Address index, rebuilt on interface/address notifications
+  std::unordered_map<uint32_t, int32_t> m_localIfIndex;  // local address -> interface
+  std::unordered_map<uint64_t, int32_t> m_prefixIfIndex; // (network << 8 | length) -> interface
+  std::vector<uint16_t> m_prefixLengths;                 // distinct lengths, longest first
+  Ipv4Address m_primaryAddress;
+
+  AntNeighborTable m_neighbors;
+  std::unordered_map<FlowKey, FlowEntry, FlowKeyHash> m_flows;
+  std::map<Ipv4Address, DestInfo> m_destinations;
+  std::vector<EventId> m_pendingAnts;
 
   PheromoneTable m_ph;
+  Stats m_stats;
+  TracedCallback<const AntHeader&, Ipv4Address> m_fwdLaunchTrace;
+  TracedCallback<const AntHeader&, Ipv4Address> m_antRelayTrace;
+  TracedCallback<const AntHeader&, AntDropReason> m_antDropTrace;
+  TracedCallback<Ipv4Address, Ipv4Address, Time, double> m_reinforceTrace;
+  TracedCallback<Ipv4Address, Ipv4Address> m_nextHopTrace;
   uint32_t m_antSeq;
   Ptr<UniformRandomVariable> m_rng;
 };
@@ -8,82 +8,365 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("PheromoneTable");
 
+int32_t PheromoneTable::FindRow(Ipv4Address dest) const {
+  auto it = m_rowIndex.find(dest.Get());
+  return it == m_rowIndex.end() ? -1 : static_cast<int32_t>(it->second);
+}
+
+uint32_t PheromoneTable::GetRow(Ipv4Address dest) {
+  auto it = m_rowIndex.find(dest.Get());
+  if (it != m_rowIndex.end()) return it->second;
+  uint32_t r = static_cast<uint32_t>(m_rows.size());
+  m_rowIndex[dest.Get()] = r;
+  m_rows.emplace_back();
+  m_stats.emplace_back();
+  m_samplers.emplace_back();
+  m_p.resize(m_rows.size() * m_stride, 0.0);
+  m_present.resize(m_rows.size() * m_stride, 0);
+  return r;
+}
+
+int32_t PheromoneTable::FindCol(Ipv4Address nh) const {
+  auto it = m_colIndex.find(nh.Get());
+  return it == m_colIndex.end() ? -1 : static_cast<int32_t>(it->second);
+}
+
+uint32_t PheromoneTable::GetCol(Ipv4Address nh) {
+  auto it = m_colIndex.find(nh.Get());
+  if (it != m_colIndex.end()) return it->second;
+  uint32_t c;
+  if (!m_freeCols.empty()) {
+    c = m_freeCols.back();
+    m_freeCols.pop_back();
+    m_colAddr[c] = nh;
+  } else {
+    c = static_cast<uint32_t>(m_colAddr.size());
+    m_colAddr.push_back(nh);
+    if (c >= m_stride) Grow(std::max<uint32_t>(4, 2 * m_stride));
+  }
+  m_colIndex[nh.Get()] = c;
+  return c;
+}
+
+void PheromoneTable::Grow(uint32_t stride) {
+  std::vector<double> p(m_rows.size() * stride, 0.0);
+  std::vector<uint8_t> present(m_rows.size() * stride, 0);
+  for (size_t r = 0; r < m_rows.size(); ++r) {
+    std::copy_n(&m_p[r * m_stride], m_stride, &p[r * stride]);
+    std::copy_n(&m_present[r * m_stride], m_stride, &present[r * stride]);
+  }
+  m_p.swap(p);
+  m_present.swap(present);
+  m_stride = stride;
+}
+
 void PheromoneTable::EnsureDest(Ipv4Address dest, const std::vector<Ipv4Address>& neighbors) {
-  auto &bucket = m_tbl[Key(dest)];
-  if (bucket.empty()) {
+  uint32_t r = GetRow(dest);
+  RowInfo &ri = m_rows[r];
+  if (ri.count == 0) {
     if (neighbors.empty()) return;
     double u = 1.0 / neighbors.size();
-    bucket.reserve(neighbors.size());
-    for (auto const& nh : neighbors) bucket.push_back({nh, u});
+    for (auto const& nh : neighbors) {
+      uint32_t c = GetCol(nh); // may grow the matrix, so index after
+      if (!Mask(r)[c]) { Mask(r)[c] = 1; Row(r)[c] = u; ri.count++; }
+    }
+    ri.version++;
   } else {
+    bool added = false;
     for (auto const& nh : neighbors) {
-      bool found = false;
-      for (auto &e : bucket) if (e.nh == nh) { found = true; break; }
-      if (!found) bucket.push_back({nh, 1e-6});
+      uint32_t c = GetCol(nh);
+      if (!Mask(r)[c]) { Mask(r)[c] = 1; Row(r)[c] = 1e-6; ri.count++; added = true; }
     }
-    Normalize(bucket);
+    if (!added) return; // bucket already normalized, keep cached samplers
+    Normalize(r);
+    ri.version++;
+  }
+}
+
+void PheromoneTable::EnsureDest(Ipv4Address dest, const std::vector<Ipv4Address>& neighbors,
+                                uint32_t nbVersion) {
+  uint32_t r = GetRow(dest);
+  if (nbVersion != 0 && m_rows[r].nbVersion == nbVersion && m_rows[r].count != 0) return;
+  EnsureDest(dest, neighbors);
+  if (m_rows[r].count != 0) m_rows[r].nbVersion = nbVersion;
+}
+
+void PheromoneTable::RemoveNextHop(Ipv4Address nh) {
+  int32_t c = FindCol(nh);
+  if (c < 0) return;
+  for (uint32_t r = 0; r < m_rows.size(); ++r) {
+    if (!Mask(r)[c]) continue;
+    Mask(r)[c] = 0;
+    Row(r)[c] = 0.0;
+    if (--m_rows[r].count != 0) Normalize(r);
+    m_rows[r].version++;
+    m_rows[r].nbVersion = 0;
   }
+  m_colIndex.erase(nh.Get());
+  m_colAddr[c] = Ipv4Address();
+  m_freeCols.push_back(static_cast<uint32_t>(c));
+  NS_LOG_INFO("RemoveNextHop nh=" << nh);
 }
 
 Ipv4Address PheromoneTable::SampleNextHop(Ipv4Address dest, double beta, uint32_t seed) const {
-  auto it = m_tbl.find(Key(dest));
-  if (it == m_tbl.end() || it->second.empty()) return Ipv4Address(); // invalid
-  std::vector<double> w; w.reserve(it->second.size());
+  int32_t r = FindRow(dest);
+  if (r < 0 || m_rows[r].count == 0) return Ipv4Address(); // invalid
+  const double *p = Row(r);
+  const uint8_t *m = Mask(r);
+  size_t n = m_colAddr.size();
+  std::vector<double> w(n, 0.0);
   double sum = 0.0;
-  for (auto const& e : it->second) {
-    double val = std::pow(std::max(e.p, 1e-12), beta);
-    w.push_back(val); sum += val;
+  size_t first = n, last = 0;
+  for (size_t c = 0; c < n; ++c) {
+    if (!m[c]) continue;
+    w[c] = std::pow(std::max(p[c], 1e-12), beta);
+    sum += w[c];
+    first = std::min(first, c);
+    last = c;
   }
-  if (sum <= 0) return it->second.front().nh;
+  if (sum <= 0) return m_colAddr[first];
   std::mt19937 rng(seed);
   std::uniform_real_distribution<> U(0.0, sum);
-  double r = U(rng);
+  double x = U(rng);
   double acc = 0.0;
-  for (size_t i=0;i<w.size();++i) {
-    acc += w[i];
-    if (r <= acc) return it->second[i].nh;
+  for (size_t c = 0; c < n; ++c) {
+    if (!m[c]) continue;
+    acc += w[c];
+    if (x <= acc) return m_colAddr[c];
+  }
+  return m_colAddr[last];
+}
+
+Ipv4Address PheromoneTable::SampleNextHopCached(Ipv4Address dest, double beta, double u) const {
+  int32_t r = FindRow(dest);
+  if (r < 0 || m_rows[r].count == 0) return Ipv4Address(); // invalid
+  AliasTable *t = nullptr;
+  for (auto &s : m_samplers[r]) {
+    if (s.beta == beta) { t = &s; break; }
+  }
+  if (t == nullptr) {
+    m_samplers[r].emplace_back();
+    t = &m_samplers[r].back();
+    t->beta = beta;
+    BuildAlias(r, *t);
+    t->version = m_rows[r].version;
+  } else if (t->version != m_rows[r].version) {
+    BuildAlias(r, *t);
+    t->version = m_rows[r].version;
   }
-  return it->second.back().nh;
+  size_t n = t->prob.size();
+  double x = std::min(std::max(u, 0.0), 1.0) * n;
+  size_t i = std::min(static_cast<size_t>(x), n - 1);
+  double frac = x - i;
+  return m_colAddr[t->col[frac < t->prob[i] ? i : t->alias[i]]];
+}
+
+void PheromoneTable::BuildAlias(uint32_t r, AliasTable& t) const {
+  const double *p = Row(r);
+  const uint8_t *m = Mask(r);
+  t.col.clear();
+  for (uint32_t c = 0; c < m_colAddr.size(); ++c) {
+    if (m[c]) t.col.push_back(c);
+  }
+  size_t n = t.col.size();
+  t.prob.assign(n, 1.0);
+  t.alias.resize(n);
+  std::vector<double> w(n);
+  double sum = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    w[i] = std::pow(std::max(p[t.col[i]], 1e-12), t.beta);
+    sum += w[i];
+    t.alias[i] = static_cast<uint32_t>(i);
+  }
+  if (sum <= 0) return; // degenerate: uniform over entries
+  std::vector<uint32_t> small, large;
+  small.reserve(n); large.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    w[i] = w[i] * n / sum;
+    (w[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back(); small.pop_back();
+    uint32_t l = large.back();
+    t.prob[s] = w[s];
+    t.alias[s] = l;
+    w[l] -= 1.0 - w[s];
+    if (w[l] < 1.0) { large.pop_back(); small.push_back(l); }
+  }
+  // Leftovers are 1.0 up to rounding error
+  for (auto i : small) t.prob[i] = 1.0;
+  for (auto i : large) t.prob[i] = 1.0;
 }
 
 void PheromoneTable::Reinforce(Ipv4Address dest, Ipv4Address fromPrevHop, double r, double alpha,
                                const std::vector<Ipv4Address>& neighbors) {
-  auto &bucket = m_tbl[Key(dest)];
-  if (bucket.empty()) {
+  uint32_t row = GetRow(dest);
+  if (m_rows[row].count == 0) {
     EnsureDest(dest, neighbors);
   }
-  if (bucket.empty()) return;
+  if (m_rows[row].count == 0) return;
   double rr = std::max(0.0, std::min(1.0, r)) * std::max(0.0, std::min(1.0, alpha));
-  for (auto &e : bucket) {
-    if (e.nh == fromPrevHop) {
-      e.p = e.p + rr * (1.0 - e.p);
-    } else {
-      e.p = e.p - rr * e.p;
-    }
-  }
-  Normalize(bucket);
+  // p' = p + rr * (1 - p) for the rewarded hop and p - rr * p for the others;
+  // absent columns hold zero and stay zero
+  double keep = 1.0 - rr;
+  double *p = Row(row);
+  size_t n = m_colAddr.size();
+  for (size_t c = 0; c < n; ++c) p[c] *= keep;
+  int32_t c = FindCol(fromPrevHop);
+  if (c >= 0 && Mask(row)[c]) p[c] += rr;
+  Normalize(row);
+  m_rows[row].version++;
   NS_LOG_INFO("Reinforce dest=" << dest << " via=" << fromPrevHop << " r=" << r << " alpha=" << alpha);
 }
 
-const std::vector<NextHopEntry>* PheromoneTable::GetBucket(Ipv4Address dest) const {
-  auto it = m_tbl.find(Key(dest));
-  if (it == m_tbl.end()) return nullptr;
-  return &it->second;
+std::vector<NextHopEntry> PheromoneTable::GetBucket(Ipv4Address dest) const {
+  std::vector<NextHopEntry> v;
+  int32_t r = FindRow(dest);
+  if (r < 0) return v;
+  v.reserve(m_rows[r].count);
+  for (uint32_t c = 0; c < m_colAddr.size(); ++c) {
+    if (Mask(r)[c]) v.push_back({m_colAddr[c], Row(r)[c]});
+  }
+  return v;
+}
+
+uint32_t PheromoneTable::GetVersion(Ipv4Address dest) const {
+  int32_t r = FindRow(dest);
+  return r < 0 ? 0 : m_rows[r].version;
+}
+
+double PheromoneTable::GetProbability(Ipv4Address dest, Ipv4Address nh) const {
+  int32_t r = FindRow(dest);
+  int32_t c = FindCol(nh);
+  if (r < 0 || c < 0 || !Mask(r)[c]) return 0.0;
+  return Row(r)[c];
+}
+
+double PheromoneTable::GetEntropy(Ipv4Address dest) const {
+  int32_t r = FindRow(dest);
+  if (r < 0 || m_rows[r].count < 2) return 1.0;
+  const double *p = Row(r);
+  double h = 0.0;
+  for (size_t c = 0; c < m_colAddr.size(); ++c) {
+    if (p[c] > 0) h -= p[c] * std::log(p[c]);
+  }
+  return std::min(1.0, h / std::log(static_cast<double>(m_rows[r].count)));
 }
 
-void PheromoneTable::Normalize(std::vector<NextHopEntry>& v) const {
+void PheromoneTable::Normalize(uint32_t r) {
+  double *p = Row(r);
+  const uint8_t *m = Mask(r);
+  size_t n = m_colAddr.size();
   double s = 0.0;
-  for (auto const& e : v) s += e.p;
+  for (size_t c = 0; c < n; ++c) s += p[c];
   if (s <= 0) {
-    double u = 1.0 / v.size();
-    for (auto &e : v) e.p = u;
+    double u = 1.0 / m_rows[r].count;
+    for (size_t c = 0; c < n; ++c) p[c] = m[c] ? u : 0.0;
   } else {
-    for (auto &e : v) e.p /= s;
+    double inv = 1.0 / s;
+    for (size_t c = 0; c < n; ++c) p[c] *= inv;
+  }
+}
+
+std::vector<Ipv4Address> PheromoneTable::GetDestinations() const {
+  std::vector<Ipv4Address> v(m_rows.size());
+  for (auto const& kv : m_rowIndex) v[kv.second] = Ipv4Address(kv.first);
+  return v;
+}
+
+const LocalStats* PheromoneTable::GetStats(Ipv4Address dest) const {
+  int32_t r = FindRow(dest);
+  if (r < 0 || m_stats[r].wcount == 0) return nullptr;
+  return &m_stats[r];
+}
+
+void PheromoneTable::Clear() {
+  *this = PheromoneTable();
+}
+
+namespace {
+const uint32_t SNAPSHOT_MAGIC = 0x414e5450; // "ANTP"
+const uint32_t SNAPSHOT_VERSION = 1;
+
+template <typename T>
+void Put(std::ostream& os, T v) { os.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+template <typename T>
+bool Get(std::istream& is, T& v) { return static_cast<bool>(is.read(reinterpret_cast<char*>(&v), sizeof(v))); }
+} // namespace
+
+void PheromoneTable::Save(std::ostream& os) const {
+  Put(os, SNAPSHOT_MAGIC);
+  Put(os, SNAPSHOT_VERSION);
+  std::vector<Ipv4Address> dests = GetDestinations();
+  Put(os, static_cast<uint32_t>(dests.size()));
+  for (uint32_t r = 0; r < dests.size(); ++r) {
+    const LocalStats &st = m_stats[r];
+    Put(os, dests[r].Get());
+    Put(os, st.mu);
+    Put(os, st.sigma2);
+    Put(os, st.wbest);
+    Put(os, st.wcount);
+    Put(os, m_rows[r].count);
+    for (uint32_t c = 0; c < m_colAddr.size(); ++c) {
+      if (!Mask(r)[c]) continue;
+      Put(os, m_colAddr[c].Get());
+      Put(os, Row(r)[c]);
+    }
+  }
+}
+
+bool PheromoneTable::Load(std::istream& is) {
+  Clear();
+  uint32_t magic = 0, version = 0, nDest = 0;
+  if (!Get(is, magic) || magic != SNAPSHOT_MAGIC || !Get(is, version) ||
+      version != SNAPSHOT_VERSION || !Get(is, nDest)) {
+    return false;
+  }
+  for (uint32_t k = 0; k < nDest; ++k) {
+    uint32_t dest = 0, count = 0;
+    LocalStats st;
+    if (!Get(is, dest) || !Get(is, st.mu) || !Get(is, st.sigma2) || !Get(is, st.wbest) ||
+        !Get(is, st.wcount) || !Get(is, count)) {
+      Clear();
+      return false;
+    }
+    uint32_t r = GetRow(Ipv4Address(dest));
+    m_stats[r] = st;
+    for (uint32_t e = 0; e < count; ++e) {
+      uint32_t nh = 0;
+      double p = 0.0;
+      if (!Get(is, nh) || !Get(is, p)) {
+        Clear();
+        return false;
+      }
+      uint32_t c = GetCol(Ipv4Address(nh));
+      if (!Mask(r)[c]) { Mask(r)[c] = 1; m_rows[r].count++; }
+      Row(r)[c] = p;
+    }
+    m_rows[r].version++;
+  }
+  NS_LOG_INFO("Load destinations=" << nDest);
+  return true;
+}
+
+void PheromoneTable::Print(std::ostream& os) const {
+  std::vector<Ipv4Address> dests = GetDestinations();
+  for (uint32_t r = 0; r < dests.size(); ++r) {
+    os << dests[r];
+    const LocalStats &st = m_stats[r];
+    if (st.wcount > 0) {
+      os << "  mu=" << st.mu << " sigma2=" << st.sigma2 << " best=" << st.wbest
+         << " samples=" << st.wcount;
+    }
+    os << "\n";
+    for (uint32_t c = 0; c < m_colAddr.size(); ++c) {
+      if (Mask(r)[c]) os << "    via " << m_colAddr[c] << "  p=" << Row(r)[c] << "\n";
+    }
   }
 }
 
 void PheromoneTable::ObserveRtt(Ipv4Address dest, double T, double eta) {
-  auto &st = m_stats[Key(dest)];
+  auto &st = m_stats[GetRow(dest)];
   if (st.wcount == 0) {
     st.mu = T; st.sigma2 = 0.0; st.wbest = T; st.wcount = 1;
     return;
@@ -97,9 +380,9 @@ void PheromoneTable::ObserveRtt(Ipv4Address dest, double T, double eta) {
 }
 
 double PheromoneTable::GetReinforcement(Ipv4Address dest, double T) const {
-  auto it = m_stats.find(Key(dest));
-  if (it == m_stats.end()) return 0.5;
-  const auto &st = it->second;
+  int32_t row = FindRow(dest);
+  if (row < 0 || m_stats[row].wcount == 0) return 0.5;
+  const auto &st = m_stats[row];
   if (T <= 0) return 1.0;
   double r1 = st.wbest / T;
   double denom = (st.mu - st.wbest) + (T - st.wbest) + 1e-9;
@@ -3,6 +3,7 @@
 
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
+#include <iostream>
 #include <unordered_map>
 #include <vector>
 
@@ -13,6 +14,15 @@ struct NextHopEntry {
   double p; // probability mass in [0,1]
 };
 
+// Walker alias table over a bucket, built for one beta exponent.
+struct AliasTable {
+  double beta = 0.0;
+  uint32_t version = 0;
+  std::vector<uint32_t> col;   // next-hop column per slot
+  std::vector<double> prob;    // acceptance threshold per slot
+  std::vector<uint32_t> alias; // fallback slot per slot
+};
+
 struct LocalStats {
   double mu = 0.0;
   double sigma2 = 0.0;
@@ -20,24 +30,79 @@ struct LocalStats {
   uint32_t wcount = 0;
 };
 
+// Probabilities are kept as a dense row-major matrix: one row per destination
+// and one column per next hop ever seen, so every per-destination operation
+// runs over a contiguous array of doubles. Next hops absent from a bucket
+// have zero mass and a cleared presence flag.
 class PheromoneTable {
 public:
   void EnsureDest(Ipv4Address dest, const std::vector<Ipv4Address>& neighbors);
+  // Same, but skips reconciliation if the bucket already saw this neighbor set version
+  void EnsureDest(Ipv4Address dest, const std::vector<Ipv4Address>& neighbors, uint32_t nbVersion);
+  // Drops a dead neighbor from every bucket and renormalizes the rest
+  void RemoveNextHop(Ipv4Address nh);
   Ipv4Address SampleNextHop(Ipv4Address dest, double beta, uint32_t seed) const;
+  // O(1) sampling from a cached alias table; u is a uniform draw in [0,1).
+  // The table for (dest, beta) is rebuilt lazily after the bucket changes.
+  Ipv4Address SampleNextHopCached(Ipv4Address dest, double beta, double u) const;
   void Reinforce(Ipv4Address dest, Ipv4Address fromPrevHop, double r, double alpha,
                  const std::vector<Ipv4Address>& neighbors);
 
-  const std::vector<NextHopEntry>* GetBucket(Ipv4Address dest) const;
+  // Copy of a bucket in column order; empty if the destination is unknown
+  std::vector<NextHopEntry> GetBucket(Ipv4Address dest) const;
+  // Change counter of a bucket; 0 if the destination is unknown.
+  uint32_t GetVersion(Ipv4Address dest) const;
+  // Mass of one next hop in a bucket; 0 if either is unknown
+  double GetProbability(Ipv4Address dest, Ipv4Address nh) const;
+  // Shannon entropy of a bucket normalized to [0,1]; 1 when nothing is known yet
+  double GetEntropy(Ipv4Address dest) const;
 
   void ObserveRtt(Ipv4Address dest, double T, double eta);
   double GetReinforcement(Ipv4Address dest, double T) const;
 
+  // Destinations in row order
+  std::vector<Ipv4Address> GetDestinations() const;
+  // Delay statistics of a destination; nullptr before its first RTT sample
+  const LocalStats* GetStats(Ipv4Address dest) const;
+
+  // Writes every bucket and its LocalStats in a compact binary form (host byte order)
+  void Save(std::ostream& os) const;
+  // Replaces the table with a Save() image; returns false and leaves the table
+  // empty if the stream is malformed
+  bool Load(std::istream& is);
+  // Human-readable dump, one destination per line
+  void Print(std::ostream& os) const;
+  void Clear();
+
 private:
-  std::unordered_map<uint32_t, std::vector<NextHopEntry>> m_tbl;
-  std::unordered_map<uint32_t, LocalStats> m_stats;
+  struct RowInfo {
+    uint32_t version = 0;   // bumped whenever the row changes
+    uint32_t nbVersion = 0; // neighbor set version last reconciled against (0: never)
+    uint32_t count = 0;     // present next hops
+  };
+
+  int32_t FindRow(Ipv4Address dest) const;
+  uint32_t GetRow(Ipv4Address dest);
+  int32_t FindCol(Ipv4Address nh) const;
+  uint32_t GetCol(Ipv4Address nh);
+  void Grow(uint32_t stride);
+  double* Row(uint32_t r) { return &m_p[static_cast<size_t>(r) * m_stride]; }
+  const double* Row(uint32_t r) const { return &m_p[static_cast<size_t>(r) * m_stride]; }
+  uint8_t* Mask(uint32_t r) { return &m_present[static_cast<size_t>(r) * m_stride]; }
+  const uint8_t* Mask(uint32_t r) const { return &m_present[static_cast<size_t>(r) * m_stride]; }
+  void Normalize(uint32_t r);
+  void BuildAlias(uint32_t r, AliasTable& t) const;
 
-  static uint32_t Key(Ipv4Address a) { return a.Get(); }
-  void Normalize(std::vector<NextHopEntry>& v) const;
+  std::unordered_map<uint32_t, uint32_t> m_rowIndex; // destination -> row
+  std::unordered_map<uint32_t, uint32_t> m_colIndex; // next hop -> column
+  std::vector<Ipv4Address> m_colAddr;                // column -> next hop
+  std::vector<uint32_t> m_freeCols;                  // columns of removed next hops
+  uint32_t m_stride = 0;                             // allocated columns per row
+  std::vector<double> m_p;                           // [row * m_stride + col]
+  std::vector<uint8_t> m_present;                    // [row * m_stride + col]
+  std::vector<RowInfo> m_rows;
+  std::vector<LocalStats> m_stats; // per row, wcount == 0 until the first RTT
+  mutable std::vector<std::vector<AliasTable>> m_samplers; // per row, one per beta in use
 };
 
 } // namespace ns3
@@ -0,0 +1,429 @@
+#include "ns3/ant-headers.h"
+#include "ns3/ant-neighbor-table.h"
+#include "ns3/antnet-helper.h"
+#include "ns3/antnet-routing-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/pheromone-table.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/test.h"
+#include "ns3/udp-l4-protocol.h"
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace ns3 {
+
+// n nodes running AntNet on one 10.0.0.0/24 SimpleChannel with a 1 ms delay
+static NodeContainer CreateAntNetLan(uint32_t n, const AntNetHelper& antnet) {
+  NodeContainer nodes;
+  nodes.Create(n);
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+  NetDeviceContainer devices = simple.Install(nodes);
+  InternetStackHelper internet;
+  internet.SetRoutingHelper(antnet);
+  internet.Install(nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.0.0.0", "255.255.255.0");
+  ipv4.Assign(devices);
+  return nodes;
+}
+
+// Alias sampling must draw next hops with probability p^beta / sum(p^beta)
+class AntNetAliasSamplingTest : public TestCase
+{
+public:
+  AntNetAliasSamplingTest() : TestCase("Alias sampling follows the pheromone distribution") {}
+
+private:
+  void DoRun() override;
+};
+
+void AntNetAliasSamplingTest::DoRun() {
+  Ipv4Address dest("10.0.9.1");
+  std::vector<Ipv4Address> nbs = {Ipv4Address("10.0.0.2"), Ipv4Address("10.0.0.3"),
+                                  Ipv4Address("10.0.0.4"), Ipv4Address("10.0.0.5")};
+  PheromoneTable ph;
+  ph.EnsureDest(dest, nbs);
+  ph.Reinforce(dest, nbs[1], 0.8, 0.5, nbs);
+  ph.Reinforce(dest, nbs[3], 0.4, 0.5, nbs);
+
+  for (double beta : {1.0, 1.3}) {
+    std::map<uint32_t, double> expected;
+    double sum = 0.0;
+    for (auto const& e : ph.GetBucket(dest)) {
+      expected[e.nh.Get()] = std::pow(e.p, beta);
+      sum += std::pow(e.p, beta);
+    }
+    // Stratified draws: every slot of the alias table is hit in proportion
+    const uint32_t n = 100000;
+    std::map<uint32_t, uint32_t> hits;
+    for (uint32_t k = 0; k < n; ++k) {
+      hits[ph.SampleNextHopCached(dest, beta, (k + 0.5) / n).Get()]++;
+    }
+    for (auto const& nb : nbs) {
+      NS_TEST_EXPECT_MSG_EQ_TOL(static_cast<double>(hits[nb.Get()]) / n,
+                                expected[nb.Get()] / sum, 0.001,
+                                "Wrong frequency of " << nb << " for beta " << beta);
+    }
+  }
+
+  // A change of the bucket rebuilds the cached table
+  ph.Reinforce(dest, nbs[0], 1.0, 1.0, nbs);
+  NS_TEST_EXPECT_MSG_EQ(ph.SampleNextHopCached(dest, 1.0, 0.99), nbs[0], "Stale alias table");
+  NS_TEST_EXPECT_MSG_EQ(ph.SampleNextHopCached(Ipv4Address("10.0.9.2"), 1.0, 0.5), Ipv4Address(),
+                        "Next hop for an unknown destination");
+}
+
+// Data flows keep their next hop across small pheromone updates, are keyed
+// on their ports, and are not pinned when there is no route
+class AntNetFlowPinningTest : public TestCase
+{
+public:
+  AntNetFlowPinningTest() : TestCase("Flow pinning") {}
+
+private:
+  void DoRun() override;
+  Ptr<Ipv4Route> Route(uint16_t sport);
+  void CheckNoRoute();
+  void Pin();
+  void CheckPins();
+
+  static const uint16_t N_FLOWS = 32;
+  Ptr<AntNetRoutingProtocol> m_agent;
+  Ipv4Address m_src;
+  Ipv4Address m_dst;
+  std::vector<Ipv4Address> m_gateways;
+  std::vector<double> m_mass;
+  uint32_t m_version = 0;
+};
+
+Ptr<Ipv4Route> AntNetFlowPinningTest::Route(uint16_t sport) {
+  Ptr<Packet> p = Create<Packet>(100);
+  TcpHeader tcp;
+  tcp.SetSourcePort(sport);
+  tcp.SetDestinationPort(80);
+  p->AddHeader(tcp);
+  Ipv4Header header;
+  header.SetSource(m_src);
+  header.SetDestination(m_dst);
+  header.SetProtocol(TcpL4Protocol::PROT_NUMBER);
+  Socket::SocketErrno err;
+  return m_agent->RouteOutput(p, header, nullptr, err);
+}
+
+void AntNetFlowPinningTest::CheckNoRoute() {
+  NS_TEST_EXPECT_MSG_EQ(Route(1000), nullptr, "Route without neighbors");
+  NS_TEST_EXPECT_MSG_EQ(m_agent->GetNPinnedFlows(), 0, "Flow pinned without a route");
+}
+
+void AntNetFlowPinningTest::Pin() {
+  const PheromoneTable &ph = m_agent->GetPheromoneTable();
+  std::set<Ipv4Address> distinct;
+  for (uint16_t i = 0; i < N_FLOWS; ++i) {
+    Ptr<Ipv4Route> rt = Route(1000 + i);
+    NS_TEST_ASSERT_MSG_NE(rt, nullptr, "No route with neighbors");
+    m_gateways.push_back(rt->GetGateway());
+    m_mass.push_back(ph.GetProbability(m_dst, rt->GetGateway()));
+    distinct.insert(rt->GetGateway());
+  }
+  for (uint16_t i = 0; i < N_FLOWS; ++i) {
+    NS_TEST_EXPECT_MSG_EQ(Route(1000 + i)->GetGateway(), m_gateways[i],
+                          "Flow " << i << " not pinned");
+  }
+  NS_TEST_EXPECT_MSG_EQ(m_agent->GetNPinnedFlows(), N_FLOWS, "Flows sharing a pin");
+  NS_TEST_EXPECT_MSG_GT(distinct.size(), 1, "Flows with different ports not spread");
+  m_version = ph.GetVersion(m_dst);
+}
+
+void AntNetFlowPinningTest::CheckPins() {
+  const PheromoneTable &ph = m_agent->GetPheromoneTable();
+  NS_TEST_ASSERT_MSG_NE(ph.GetVersion(m_dst), m_version, "No reinforcement");
+  uint32_t kept = 0;
+  for (uint16_t i = 0; i < N_FLOWS; ++i) {
+    if (ph.GetProbability(m_dst, m_gateways[i]) < 0.5 * m_mass[i]) continue;
+    NS_TEST_EXPECT_MSG_EQ(Route(1000 + i)->GetGateway(), m_gateways[i],
+                          "Flow " << i << " repinned after a small update");
+    kept++;
+  }
+  NS_TEST_EXPECT_MSG_GT(kept, 0, "No pin survived");
+}
+
+void AntNetFlowPinningTest::DoRun() {
+  AntNetHelper antnet;
+  antnet.Set("FlowPinTime", TimeValue(Seconds(100)));
+  NodeContainer nodes = CreateAntNetLan(4, antnet);
+  m_agent = nodes.Get(0)->GetObject<AntNetRoutingProtocol>();
+  m_src = Ipv4Address("10.0.0.1");
+  m_dst = Ipv4Address("10.0.0.4");
+
+  // Hellos start at 1 s and ants at 5 s
+  Simulator::Schedule(Seconds(0.5), &AntNetFlowPinningTest::CheckNoRoute, this);
+  Simulator::Schedule(Seconds(2.5), &AntNetFlowPinningTest::Pin, this);
+  Simulator::Schedule(Seconds(9.5), &AntNetFlowPinningTest::CheckPins, this);
+  Simulator::Stop(Seconds(10));
+  Simulator::Run();
+  Simulator::Destroy();
+}
+
+// AntHeader round trip, full paths, and rejection of oversized paths
+class AntNetHeaderTest : public TestCase
+{
+public:
+  AntNetHeaderTest() : TestCase("AntHeader serialization") {}
+
+private:
+  void DoRun() override;
+};
+
+void AntNetHeaderTest::DoRun() {
+  AntHeader h;
+  h.SetType(ANT_BACKWARD);
+  h.SetSrc(Ipv4Address("10.0.0.1"));
+  h.SetDst(Ipv4Address("10.0.3.7"));
+  h.SetId(0xdeadbeef);
+  h.SetLaunchTime(NanoSeconds(1234567890123));
+  for (uint32_t k = 0; k < 5; ++k) h.PushHop(Ipv4Address(0x0a000100 + k));
+
+  Ptr<Packet> p = Create<Packet>(10);
+  p->AddHeader(h);
+  NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 10 + h.GetSerializedSize(), "Wrong serialized size");
+  AntHeader r;
+  NS_TEST_ASSERT_MSG_EQ(p->RemoveHeader(r), h.GetSerializedSize(), "Wrong deserialized size");
+  NS_TEST_EXPECT_MSG_EQ(r.GetType(), ANT_BACKWARD, "Wrong type");
+  NS_TEST_EXPECT_MSG_EQ(r.GetSrc(), h.GetSrc(), "Wrong source");
+  NS_TEST_EXPECT_MSG_EQ(r.GetDst(), h.GetDst(), "Wrong destination");
+  NS_TEST_EXPECT_MSG_EQ(r.GetId(), h.GetId(), "Wrong id");
+  NS_TEST_EXPECT_MSG_EQ(r.GetLaunchTime(), h.GetLaunchTime(), "Wrong launch time");
+  NS_TEST_EXPECT_MSG_EQ((r.GetPath() == h.GetPath()), true, "Wrong path");
+  NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 10, "Payload changed");
+
+  // A full path still round-trips, and one more hop is refused
+  AntHeader full;
+  for (uint32_t k = 0; k < AntHeader::MAX_PATH; ++k) {
+    NS_TEST_ASSERT_MSG_EQ(full.PushHop(Ipv4Address(0x0a000200 + k)), true,
+                          "Hop " << k << " refused");
+  }
+  NS_TEST_EXPECT_MSG_EQ(full.PushHop(Ipv4Address("10.0.9.9")), false, "Path grew past MAX_PATH");
+  p = Create<Packet>();
+  p->AddHeader(full);
+  NS_TEST_ASSERT_MSG_EQ(p->RemoveHeader(r), full.GetSerializedSize(), "Full path not deserialized");
+  NS_TEST_EXPECT_MSG_EQ(r.GetPathLength(), AntHeader::MAX_PATH, "Full path truncated");
+  NS_TEST_EXPECT_MSG_EQ(r.GetHop(AntHeader::MAX_PATH - 1), full.GetHop(AntHeader::MAX_PATH - 1),
+                        "Wrong last hop");
+
+  // A path longer than MAX_PATH on the wire is rejected, not truncated
+  const uint32_t len = AntHeader::MAX_PATH + 1;
+  std::vector<uint8_t> wire(1 + 4 + 8 + 4 + 4 + 1 + 4 * len, 0);
+  wire[0] = ANT_FORWARD;
+  wire[21] = len;
+  p = Create<Packet>(wire.data(), wire.size());
+  NS_TEST_EXPECT_MSG_EQ(p->RemoveHeader(r), 0, "Oversized path accepted");
+  NS_TEST_EXPECT_MSG_EQ(p->GetSize(), wire.size(), "Bytes of a rejected header consumed");
+}
+
+// Neighbors expire once their deadline has passed; refreshing pushes it back
+class AntNetNeighborExpiryTest : public TestCase
+{
+public:
+  AntNetNeighborExpiryTest() : TestCase("AntNeighborTable expires stale neighbors") {}
+
+private:
+  void DoRun() override;
+};
+
+void AntNetNeighborExpiryTest::DoRun() {
+  AntNeighborTable t;
+  Ipv4Address a("10.0.0.2"), b("10.0.0.3"), c("10.0.0.4");
+  Time timeout = Seconds(3);
+  NS_TEST_EXPECT_MSG_EQ(t.Refresh(a, Seconds(0), timeout), true, "New neighbor not reported");
+  NS_TEST_EXPECT_MSG_EQ(t.Refresh(b, Seconds(1), timeout), true, "New neighbor not reported");
+  NS_TEST_EXPECT_MSG_EQ(t.GetN(), 2, "Wrong neighbor count");
+  uint32_t version = t.GetVersion();
+
+  // Refreshing a known neighbor does not change the set
+  NS_TEST_EXPECT_MSG_EQ(t.Refresh(a, Seconds(2), timeout), false, "Known neighbor reported new");
+  NS_TEST_EXPECT_MSG_EQ(t.GetVersion(), version, "Refresh changed the version");
+
+  // The deadline itself is still alive; a's first deadline is stale
+  NS_TEST_EXPECT_MSG_EQ(t.Purge(Seconds(4)).empty(), true, "Neighbor expired at its deadline");
+  std::vector<Ipv4Address> dead = t.Purge(Seconds(4.5));
+  NS_TEST_ASSERT_MSG_EQ(dead.size(), 1, "Wrong number of expired neighbors");
+  NS_TEST_EXPECT_MSG_EQ(dead[0], b, "Wrong neighbor expired");
+  NS_TEST_EXPECT_MSG_EQ(t.IsNeighbor(b), false, "Expired neighbor still listed");
+  NS_TEST_EXPECT_MSG_EQ(t.GetIndex(b), -1, "Expired neighbor still indexed");
+  NS_TEST_EXPECT_MSG_EQ(t.IsNeighbor(a), true, "Refreshed neighbor expired");
+  NS_TEST_EXPECT_MSG_EQ(t.GetVersion(), version + 1, "Expiry did not bump the version");
+  NS_TEST_ASSERT_MSG_EQ(t.GetList().size(), 1, "Wrong list size");
+  NS_TEST_EXPECT_MSG_EQ(t.GetList()[0], a, "Wrong neighbor listed");
+
+  // The freed slot is reused by the next neighbor
+  int32_t slotA = t.GetIndex(a);
+  NS_TEST_EXPECT_MSG_EQ(t.Refresh(c, Seconds(5), timeout), true, "New neighbor not reported");
+  NS_TEST_EXPECT_MSG_NE(t.GetIndex(c), slotA, "Slot shared by two neighbors");
+  NS_TEST_EXPECT_MSG_EQ(t.Purge(Seconds(5.5)).size(), 1, "Refreshed neighbor not expired");
+  NS_TEST_EXPECT_MSG_EQ(t.Purge(Seconds(9)).size(), 1, "Last neighbor not expired");
+  NS_TEST_EXPECT_MSG_EQ(t.IsEmpty(), true, "Table not empty");
+  NS_TEST_EXPECT_MSG_EQ(t.GetList().empty(), true, "List not empty");
+}
+
+// A Save() image restores every bucket and its delay statistics; a damaged
+// image is refused and leaves the table empty
+class AntNetPheromoneSnapshotTest : public TestCase
+{
+public:
+  AntNetPheromoneSnapshotTest() : TestCase("PheromoneTable Save/Load round trip") {}
+
+private:
+  void DoRun() override;
+};
+
+void AntNetPheromoneSnapshotTest::DoRun() {
+  std::vector<Ipv4Address> nbs = {Ipv4Address("10.0.0.2"), Ipv4Address("10.0.0.3"),
+                                  Ipv4Address("10.0.0.4")};
+  Ipv4Address d1("10.0.1.1"), d2("10.0.2.1");
+  PheromoneTable t;
+  t.EnsureDest(d1, nbs);
+  t.EnsureDest(d2, {nbs[0], nbs[2]});
+  t.Reinforce(d1, nbs[1], 0.6, 1.0, nbs);
+  t.Reinforce(d2, nbs[2], 0.3, 1.0, nbs);
+  t.ObserveRtt(d1, 0.020, 0.1);
+  t.ObserveRtt(d1, 0.035, 0.1);
+
+  std::stringstream ss;
+  t.Save(ss);
+  std::string image = ss.str();
+  PheromoneTable r;
+  NS_TEST_ASSERT_MSG_EQ(r.Load(ss), true, "Valid image refused");
+  NS_TEST_ASSERT_MSG_EQ((r.GetDestinations() == t.GetDestinations()), true, "Wrong destinations");
+  for (Ipv4Address d : {d1, d2}) {
+    std::vector<NextHopEntry> a = t.GetBucket(d), b = r.GetBucket(d);
+    NS_TEST_ASSERT_MSG_EQ(b.size(), a.size(), "Wrong bucket size for " << d);
+    for (size_t k = 0; k < a.size(); ++k) {
+      NS_TEST_EXPECT_MSG_EQ(b[k].nh, a[k].nh, "Wrong next hop for " << d);
+      NS_TEST_EXPECT_MSG_EQ(b[k].p, a[k].p, "Wrong mass for " << d << " via " << a[k].nh);
+    }
+  }
+  const LocalStats* st = r.GetStats(d1);
+  NS_TEST_ASSERT_MSG_NE(st, nullptr, "Delay statistics lost");
+  NS_TEST_EXPECT_MSG_EQ(st->mu, t.GetStats(d1)->mu, "Wrong mean");
+  NS_TEST_EXPECT_MSG_EQ(st->sigma2, t.GetStats(d1)->sigma2, "Wrong variance");
+  NS_TEST_EXPECT_MSG_EQ(st->wbest, t.GetStats(d1)->wbest, "Wrong best RTT");
+  NS_TEST_EXPECT_MSG_EQ(st->wcount, t.GetStats(d1)->wcount, "Wrong sample count");
+  NS_TEST_EXPECT_MSG_EQ(r.GetStats(d2), nullptr, "Statistics without samples");
+
+  // A truncated image and a wrong magic are both refused
+  std::stringstream truncated(image.substr(0, image.size() - 4));
+  NS_TEST_EXPECT_MSG_EQ(r.Load(truncated), false, "Truncated image accepted");
+  NS_TEST_EXPECT_MSG_EQ(r.GetDestinations().empty(), true, "Truncated image left entries");
+  std::string bad = image;
+  bad[0] ^= 0xff;
+  std::stringstream badMagic(bad);
+  NS_TEST_EXPECT_MSG_EQ(r.Load(badMagic), false, "Wrong magic accepted");
+  NS_TEST_EXPECT_MSG_EQ(r.GetDestinations().empty(), true, "Wrong magic left entries");
+}
+
+// Every trace source fires once per matching Stats counter increment, and only
+// data lookups make a node launch ants
+class AntNetTraceStatsTest : public TestCase
+{
+public:
+  AntNetTraceStatsTest() : TestCase("Traces agree with the Stats counters") {}
+
+private:
+  void DoRun() override;
+  void SendData();
+  void Launch(const AntHeader& h, Ipv4Address nh) { m_launches[h.GetSrc()]++; }
+  void Relay(const AntHeader& h, Ipv4Address nh) { m_relays++; }
+  void Drop(const AntHeader& h, AntNetRoutingProtocol::AntDropReason reason) { m_drops++; }
+  void Reinforce(Ipv4Address dest, Ipv4Address via, Time rtt, double r) {
+    m_reinforcements++;
+    m_reinforcementSum += r;
+  }
+  void NextHop(Ipv4Address dest, Ipv4Address nh) { m_nextHops++; }
+
+  Ptr<AntNetRoutingProtocol> m_agent;
+  std::map<Ipv4Address, uint64_t> m_launches;
+  uint64_t m_relays = 0;
+  uint64_t m_drops = 0;
+  uint64_t m_reinforcements = 0;
+  double m_reinforcementSum = 0.0;
+  uint64_t m_nextHops = 0;
+};
+
+void AntNetTraceStatsTest::SendData() {
+  Ptr<Packet> p = Create<Packet>(100);
+  Ipv4Header header;
+  header.SetSource(Ipv4Address("10.0.0.1"));
+  header.SetDestination(Ipv4Address("10.0.0.4"));
+  header.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+  Socket::SocketErrno err;
+  m_agent->RouteOutput(p, header, nullptr, err);
+}
+
+void AntNetTraceStatsTest::DoRun() {
+  AntNetHelper antnet;
+  NodeContainer nodes = CreateAntNetLan(4, antnet);
+  m_agent = nodes.Get(0)->GetObject<AntNetRoutingProtocol>();
+  for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+    Ptr<AntNetRoutingProtocol> agent = nodes.Get(i)->GetObject<AntNetRoutingProtocol>();
+    agent->TraceConnectWithoutContext("ForwardAntLaunch",
+                                      MakeCallback(&AntNetTraceStatsTest::Launch, this));
+    agent->TraceConnectWithoutContext("AntRelay", MakeCallback(&AntNetTraceStatsTest::Relay, this));
+    agent->TraceConnectWithoutContext("AntDrop", MakeCallback(&AntNetTraceStatsTest::Drop, this));
+    agent->TraceConnectWithoutContext("Reinforce",
+                                      MakeCallback(&AntNetTraceStatsTest::Reinforce, this));
+    agent->TraceConnectWithoutContext("NextHop",
+                                      MakeCallback(&AntNetTraceStatsTest::NextHop, this));
+  }
+  for (double t = 2.0; t < 10.0; t += 0.5) {
+    Simulator::Schedule(Seconds(t), &AntNetTraceStatsTest::SendData, this);
+  }
+  Simulator::Stop(Seconds(10));
+  Simulator::Run();
+
+  AntNetRoutingProtocol::Stats st = AntNetHelper::GetStats(nodes);
+  uint64_t launches = 0;
+  for (auto const& kv : m_launches) launches += kv.second;
+  NS_TEST_EXPECT_MSG_GT(st.fwdLaunched, 0, "No forward ant launched");
+  NS_TEST_EXPECT_MSG_GT(st.reinforcements, 0, "No reinforcement");
+  NS_TEST_EXPECT_MSG_EQ(launches, st.fwdLaunched, "ForwardAntLaunch disagrees with fwdLaunched");
+  NS_TEST_EXPECT_MSG_EQ(m_relays, st.fwdRelayed + st.bwdRelayed, "AntRelay disagrees with relays");
+  NS_TEST_EXPECT_MSG_EQ(m_drops, st.dropHopLimit + st.dropNoNextHop,
+                        "AntDrop disagrees with drops");
+  NS_TEST_EXPECT_MSG_EQ(m_reinforcements, st.reinforcements, "Reinforce disagrees with Stats");
+  NS_TEST_EXPECT_MSG_EQ_TOL(m_reinforcementSum, st.reinforcementSum, 1e-9,
+                            "Reinforce rewards disagree with reinforcementSum");
+  NS_TEST_EXPECT_MSG_EQ(m_nextHops, st.dataRouted, "NextHop disagrees with dataRouted");
+  NS_TEST_EXPECT_MSG_EQ(st.dataRouted + st.dataNoRoute, 16, "Data lookups miscounted");
+  // Ants and hellos are control traffic, so only the data source launches ants
+  NS_TEST_EXPECT_MSG_EQ(m_launches.size(), 1, "Control traffic made a node launch ants");
+  NS_TEST_EXPECT_MSG_EQ(m_launches[Ipv4Address("10.0.0.1")], launches, "Ants from the wrong node");
+  Simulator::Destroy();
+}
+
+class AntNetTestSuite : public TestSuite
+{
+public:
+  AntNetTestSuite();
+};
+
+AntNetTestSuite::AntNetTestSuite() : TestSuite("antnet", Type::UNIT) {
+  AddTestCase(new AntNetAliasSamplingTest, TestCase::Duration::QUICK);
+  AddTestCase(new AntNetFlowPinningTest, TestCase::Duration::QUICK);
+  AddTestCase(new AntNetHeaderTest, TestCase::Duration::QUICK);
+  AddTestCase(new AntNetNeighborExpiryTest, TestCase::Duration::QUICK);
+  AddTestCase(new AntNetPheromoneSnapshotTest, TestCase::Duration::QUICK);
+  AddTestCase(new AntNetTraceStatsTest, TestCase::Duration::QUICK);
+}
+
+static AntNetTestSuite g_antNetTestSuite; // Static variable for test initialization
+
+} // namespace ns3
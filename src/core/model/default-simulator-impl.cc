@@ -52,6 +52,13 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_unscheduledEvents = 0;
     m_eventCount = 0;
     m_eventsWithContextEmpty = true;
+    m_ring = std::make_unique<RingSlot[]>(EVENT_RING_SIZE);
+    for (uint64_t i = 0; i < EVENT_RING_SIZE; ++i)
+    {
+        m_ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    m_ringHead.store(0, std::memory_order_relaxed);
+    m_ringTail = 0;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -145,33 +152,101 @@ DefaultSimulatorImpl::IsFinished() const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    bool overflowEmpty = m_eventsWithContextEmpty.load(std::memory_order_acquire);
+    if (overflowEmpty && m_ringHead.load(std::memory_order_acquire) == m_ringTail)
+    {
+        return;
+    }
+    if (overflowEmpty)
     {
+        DrainEventsWithContext(0);
         return;
     }
 
     // swap queues
     EventsWithContext eventsWithContext;
+    uint64_t limit;
     {
         std::unique_lock lock{m_eventsWithContextMutex};
         m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        // Every ring entry claimed before the overflow events we just took
+        // must be inserted first to preserve per-thread ordering
+        limit = m_ringHead.load(std::memory_order_acquire);
+        m_eventsWithContextEmpty.store(true, std::memory_order_release);
     }
-    while (!eventsWithContext.empty())
+    DrainEventsWithContext(limit);
+    for (const auto& event : eventsWithContext)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
-        Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
-        ev.key.m_uid = m_uid;
-        m_uid++;
-        m_unscheduledEvents++;
-        m_events->Insert(ev);
+        InsertEventWithContext(event);
+    }
+}
+
+void
+DefaultSimulatorImpl::DrainEventsWithContext(uint64_t limit)
+{
+    while (limit == 0 || m_ringTail < limit)
+    {
+        RingSlot& slot = m_ring[m_ringTail & (EVENT_RING_SIZE - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != m_ringTail + 1)
+        {
+            if (limit == 0)
+            {
+                break;
+            }
+            // Claimed but not yet published: the producer is about to write it
+            std::this_thread::yield();
+            continue;
+        }
+        InsertEventWithContext(slot.ev);
+        slot.seq.store(m_ringTail + EVENT_RING_SIZE, std::memory_order_release);
+        ++m_ringTail;
     }
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext(const EventWithContext& event)
+{
+    Scheduler::Event ev;
+    ev.impl = event.event;
+    ev.key.m_ts = m_currentTs + event.timestamp;
+    ev.key.m_context = event.context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
+bool
+DefaultSimulatorImpl::PushEventWithContext(const EventWithContext& ev)
+{
+    uint64_t pos = m_ringHead.load(std::memory_order_relaxed);
+    RingSlot* slot;
+    while (true)
+    {
+        slot = &m_ring[pos & (EVENT_RING_SIZE - 1)];
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(seq - pos);
+        if (diff == 0)
+        {
+            if (m_ringHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            pos = m_ringHead.load(std::memory_order_relaxed);
+        }
+    }
+    slot->ev = ev;
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
 void
 DefaultSimulatorImpl::Run()
 {
@@ -253,10 +328,16 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
+        // Lock-free fast path; fall back to the locked list only when the
+        // ring is full, and stay there until the main thread drained it
+        if (m_eventsWithContextEmpty.load(std::memory_order_acquire) && PushEventWithContext(ev))
+        {
+            return;
+        }
         {
             std::unique_lock lock{m_eventsWithContextMutex};
             m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
+            m_eventsWithContextEmpty.store(false, std::memory_order_release);
         }
     }
 }
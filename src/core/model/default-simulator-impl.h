@@ -11,7 +11,9 @@
 
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -86,15 +88,71 @@ class DefaultSimulatorImpl : public SimulatorImpl
         EventImpl* event;
     };
 
+    /**
+     * Try to append an event from another thread to the lock-free ring.
+     *
+     * @param [in] ev The event.
+     * @returns \c false if the ring is full.
+     */
+    bool PushEventWithContext(const EventWithContext& ev);
+    /**
+     * Move ring entries into the main event queue.
+     *
+     * @param [in] limit Ring position to drain up to, waiting for entries
+     *             claimed but not yet published; if zero, stop at the first
+     *             unpublished entry instead.
+     */
+    void DrainEventsWithContext(uint64_t limit);
+    /**
+     * Insert an event from another thread into the main event queue.
+     *
+     * @param [in] event The event.
+     */
+    void InsertEventWithContext(const EventWithContext& event);
+
+    /**
+     * Number of slots in the ring of events from other threads.
+     * Must be a power of two.
+     */
+    static constexpr uint64_t EVENT_RING_SIZE = 1024;
+
+    /**
+     * Slot of the bounded multi-producer, single-consumer ring of events
+     * from other threads.
+     *
+     * A producer claims position \c p by advancing m_ringHead, writes the
+     * event and then publishes it by setting \c seq to \c p+1.  The main
+     * thread consumes position \c p once \c seq equals \c p+1, and hands the
+     * slot back by setting \c seq to \c p+EVENT_RING_SIZE.
+     */
+    struct RingSlot
+    {
+        /** Publication sequence number. */
+        std::atomic<uint64_t> seq;
+        /** The event. */
+        EventWithContext ev;
+    };
+
+    /** The ring of events from other threads. */
+    std::unique_ptr<RingSlot[]> m_ring;
+    /** Next ring position claimed by a producer. */
+    alignas(64) std::atomic<uint64_t> m_ringHead;
+    /** Next ring position consumed by the main thread. */
+    alignas(64) uint64_t m_ringTail;
+
     /** Container type for the events from a different context. */
     typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
+    /**
+     * Overflow container of events from a different context,
+     * used only while the ring is full.
+     */
     EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * Flag \c true if the overflow container is empty.  While it is not,
+     * producers keep appending to it so that events from one thread are
+     * never reordered.
      */
-    bool m_eventsWithContextEmpty;
+    std::atomic<bool> m_eventsWithContextEmpty;
     /** Mutex to control access to the list of events with context. */
     std::mutex m_eventsWithContextMutex;
 
@@ -10,6 +10,11 @@
 
 #include "log.h"
 
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+
 /**
  * @file
  * @ingroup events
@@ -21,6 +26,277 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Size class granularity of the EventImpl pools, in bytes. */
+constexpr std::size_t EVENT_POOL_GRANULE = 16;
+/** Number of EventImpl size classes. */
+constexpr std::size_t EVENT_POOL_CLASSES = 16;
+/** Size of the chunks carved into blocks, in bytes. */
+constexpr std::size_t EVENT_POOL_CHUNK = 64 * 1024;
+/**
+ * Bytes a thread may keep in the free list of one size class; beyond that
+ * a chunk's worth of blocks is handed to the shared pool.
+ */
+constexpr std::size_t EVENT_POOL_MAX_FREE = 2 * EVENT_POOL_CHUNK;
+
+/** A free block, linked into the free list of its size class. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< The next free block.
+};
+
+/** Free lists, indexed by size class. */
+typedef std::array<FreeBlock*, EVENT_POOL_CLASSES> FreeLists;
+
+/**
+ * State shared by all threads: the free blocks released by threads which
+ * have exited or held too many, and the statistics of threads which have
+ * exited.
+ *
+ * Chunks are never returned to the heap since blocks carved from them may
+ * be freed by any thread at any time, including during static destruction.
+ */
+struct EventPoolShared
+{
+    std::mutex mutex;             //!< Protects the other members.
+    FreeLists orphans{};          //!< Free blocks released by threads.
+    EventImpl::PoolStats stats{}; //!< Statistics of exited threads.
+};
+
+/**
+ * Get the shared pool state.
+ * @returns The shared state, which is never destroyed.
+ */
+EventPoolShared&
+GetEventPoolShared()
+{
+    static auto shared = new EventPoolShared;
+    return *shared;
+}
+
+/**
+ * Flag \c true once the pool of this thread has been destroyed, which
+ * happens before static destruction on the main thread.
+ */
+thread_local bool g_eventPoolDead = false;
+
+/** Per-thread EventImpl pool. */
+class EventPool
+{
+  public:
+    ~EventPool()
+    {
+        g_eventPoolDead = true;
+        auto& shared = GetEventPoolShared();
+        std::unique_lock lock{shared.mutex};
+        for (std::size_t i = 0; i < EVENT_POOL_CLASSES; ++i)
+        {
+            while (m_free[i] != nullptr)
+            {
+                FreeBlock* b = m_free[i];
+                m_free[i] = b->next;
+                b->next = shared.orphans[i];
+                shared.orphans[i] = b;
+            }
+        }
+        shared.stats.allocations += m_stats.allocations;
+        shared.stats.hits += m_stats.hits;
+        shared.stats.oversize += m_stats.oversize;
+        shared.stats.recycledBytes += m_stats.recycledBytes;
+        shared.stats.chunkBytes += m_stats.chunkBytes;
+    }
+
+    /**
+     * Allocate a block.
+     * @param [in] size The requested size.
+     * @returns The block.
+     */
+    void* Allocate(std::size_t size)
+    {
+        ++m_stats.allocations;
+        std::size_t cls = (size - 1) / EVENT_POOL_GRANULE;
+        if (cls >= EVENT_POOL_CLASSES)
+        {
+            ++m_stats.oversize;
+            return ::operator new(size);
+        }
+        FreeBlock* b = m_free[cls];
+        if (b != nullptr)
+        {
+            ++m_stats.hits;
+            m_stats.recycledBytes += size;
+            m_free[cls] = b->next;
+            --m_count[cls];
+            return b;
+        }
+        return Refill(cls);
+    }
+
+    /**
+     * Free a block.
+     * @param [in] p The block.
+     * @param [in] size The size it was allocated with.
+     */
+    void Deallocate(void* p, std::size_t size)
+    {
+        std::size_t cls = (size - 1) / EVENT_POOL_GRANULE;
+        if (cls >= EVENT_POOL_CLASSES)
+        {
+            ::operator delete(p);
+            return;
+        }
+        auto b = static_cast<FreeBlock*>(p);
+        b->next = m_free[cls];
+        m_free[cls] = b;
+        // Blocks allocated by another thread would otherwise pile up here
+        // while that thread keeps carving new chunks
+        if (++m_count[cls] * BlockSize(cls) > EVENT_POOL_MAX_FREE)
+        {
+            Release(cls);
+        }
+    }
+
+    EventImpl::PoolStats m_stats{}; //!< Statistics of this thread.
+
+  private:
+    /**
+     * Get the block size of a size class.
+     * @param [in] cls The size class.
+     * @returns The block size, in bytes.
+     */
+    static std::size_t BlockSize(std::size_t cls)
+    {
+        return (cls + 1) * EVENT_POOL_GRANULE;
+    }
+
+    /**
+     * Refill an empty free list with up to a chunk's worth of blocks
+     * released to the shared pool, otherwise from a new chunk.
+     * @param [in] cls The size class.
+     * @returns A block of size class \p cls.
+     */
+    void* Refill(std::size_t cls)
+    {
+        std::size_t batch = EVENT_POOL_CHUNK / BlockSize(cls);
+        auto& shared = GetEventPoolShared();
+        {
+            std::unique_lock lock{shared.mutex};
+            while (shared.orphans[cls] != nullptr && m_count[cls] < batch)
+            {
+                FreeBlock* b = shared.orphans[cls];
+                shared.orphans[cls] = b->next;
+                b->next = m_free[cls];
+                m_free[cls] = b;
+                ++m_count[cls];
+            }
+        }
+        if (m_free[cls] == nullptr)
+        {
+            std::size_t blockSize = BlockSize(cls);
+            auto chunk = static_cast<char*>(::operator new(EVENT_POOL_CHUNK));
+            m_stats.chunkBytes += EVENT_POOL_CHUNK;
+            for (std::size_t off = 0; off + blockSize <= EVENT_POOL_CHUNK; off += blockSize)
+            {
+                auto b = reinterpret_cast<FreeBlock*>(chunk + off);
+                b->next = m_free[cls];
+                m_free[cls] = b;
+                ++m_count[cls];
+            }
+        }
+        FreeBlock* b = m_free[cls];
+        m_free[cls] = b->next;
+        --m_count[cls];
+        return b;
+    }
+
+    /**
+     * Hand a chunk's worth of blocks from a full free list to the shared pool.
+     * @param [in] cls The size class.
+     */
+    void Release(std::size_t cls)
+    {
+        std::size_t batch = EVENT_POOL_CHUNK / BlockSize(cls);
+        FreeBlock* head = m_free[cls];
+        FreeBlock* tail = head;
+        for (std::size_t i = 1; i < batch; ++i)
+        {
+            tail = tail->next;
+        }
+        m_free[cls] = tail->next;
+        m_count[cls] -= batch;
+        auto& shared = GetEventPoolShared();
+        std::unique_lock lock{shared.mutex};
+        tail->next = shared.orphans[cls];
+        shared.orphans[cls] = head;
+    }
+
+    FreeLists m_free{};                                    //!< Free lists of this thread.
+    std::array<std::size_t, EVENT_POOL_CLASSES> m_count{}; //!< Blocks in each free list.
+};
+
+/** The pool of this thread. */
+thread_local EventPool g_eventPool;
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    if (g_eventPoolDead)
+    {
+        // Round up, since the block may end up recycled in its size class
+        std::size_t cls = (size - 1) / EVENT_POOL_GRANULE;
+        return ::operator new((cls + 1) * EVENT_POOL_GRANULE);
+    }
+    return g_eventPool.Allocate(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    if (g_eventPoolDead)
+    {
+        std::size_t cls = (size - 1) / EVENT_POOL_GRANULE;
+        if (cls >= EVENT_POOL_CLASSES)
+        {
+            ::operator delete(p);
+            return;
+        }
+        auto& shared = GetEventPoolShared();
+        std::unique_lock lock{shared.mutex};
+        auto b = static_cast<FreeBlock*>(p);
+        b->next = shared.orphans[cls];
+        shared.orphans[cls] = b;
+        return;
+    }
+    g_eventPool.Deallocate(p, size);
+}
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats()
+{
+    PoolStats stats = g_eventPool.m_stats;
+    auto& shared = GetEventPoolShared();
+    std::unique_lock lock{shared.mutex};
+    stats.allocations += shared.stats.allocations;
+    stats.hits += shared.stats.hits;
+    stats.oversize += shared.stats.oversize;
+    stats.recycledBytes += shared.stats.recycledBytes;
+    stats.chunkBytes += shared.stats.chunkBytes;
+    return stats;
+}
+
+void
+EventImpl::ResetPoolStats()
+{
+    g_eventPool.m_stats = {};
+    auto& shared = GetEventPoolShared();
+    std::unique_lock lock{shared.mutex};
+    shared.stats = {};
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
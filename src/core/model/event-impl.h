@@ -10,6 +10,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -30,10 +31,57 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Instances are allocated from per-thread pools of fixed size blocks,
+ * one pool per 16 byte size class up to 256 bytes, so that scheduling
+ * an event does not normally go through the general purpose heap.
+ * Freed blocks are recycled by the thread which frees them; once a
+ * thread holds more than 128 KiB of free blocks of one size class, the
+ * excess goes to a shared pool from which other threads refill.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
   public:
+    /** Statistics of the EventImpl allocator. */
+    struct PoolStats
+    {
+        uint64_t allocations;   //!< Number of EventImpl allocations.
+        uint64_t hits;          //!< Allocations served by recycling a freed block.
+        uint64_t oversize;      //!< Allocations too large for the pools.
+        uint64_t recycledBytes; //!< Bytes served by recycled blocks instead of the heap.
+        uint64_t chunkBytes;    //!< Bytes obtained from the heap for pool chunks.
+    };
+
+    /**
+     * Get the allocator statistics, for the calling thread and all threads
+     * which have exited, since the last ResetPoolStats().  Other threads
+     * which are still running are not included.
+     *
+     * @returns The statistics.
+     */
+    static PoolStats GetPoolStats();
+    /**
+     * Reset the allocator statistics of the calling thread and those
+     * collected from threads which have exited.  Other threads which are
+     * still running keep theirs.
+     */
+    static void ResetPoolStats();
+
+    /**
+     * Allocate an EventImpl from the pool of the calling thread.
+     *
+     * @param [in] size The size of the object.
+     * @returns The storage.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Return an EventImpl to the pool of the calling thread.
+     *
+     * @param [in] p The storage.
+     * @param [in] size The size of the object.
+     */
+    static void operator delete(void* p, std::size_t size);
+
     /** Default constructor. */
     EventImpl();
     /** Destructor. */
@@ -0,0 +1,299 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * @file
+ * @ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "Largest bucket which is sorted into the bottom rather than "
+                          "spread over a new rung.",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "Maximum number of rungs in the ladder.",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxBuckets",
+                          "Maximum number of buckets in a rung.",
+                          UintegerValue(1 << 16),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxBuckets),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(0),
+      m_topMax(0),
+      m_nRungs(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        if (m_top.empty())
+        {
+            m_topMin = m_topMax = ts;
+        }
+        else
+        {
+            m_topMin = std::min(m_topMin, ts);
+            m_topMax = std::max(m_topMax, ts);
+        }
+        m_top.push_back(ev);
+        if (m_bottom.empty())
+        {
+            Refill();
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= rung.CurrentStart())
+        {
+            rung.m_bucket[rung.Index(ts)].push_back(ev);
+            ++rung.m_count;
+            if (m_bottom.empty())
+            {
+                Refill();
+            }
+            return;
+        }
+    }
+    InsertBottom(ev);
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    auto it = std::upper_bound(m_bottom.begin(), m_bottom.end(), ev);
+    m_bottom.insert(it, ev);
+
+    // Many insertions straight into the bottom, typically a burst of events
+    // in the very near future: spread them over a rung again
+    if (m_bottom.size() > 4 * m_threshold && m_nRungs < m_maxRungs &&
+        m_bottom.front().key.m_ts != m_bottom.back().key.m_ts)
+    {
+        NS_LOG_LOGIC("spawn rung from bottom of " << m_bottom.size() << " events");
+        uint64_t min = m_bottom.front().key.m_ts;
+        uint64_t max = m_bottom.back().key.m_ts;
+        m_scratch.assign(m_bottom.begin(), m_bottom.end());
+        m_bottom.clear();
+        SpawnRung(m_scratch, min, max);
+        Refill();
+    }
+}
+
+void
+LadderScheduler::SpawnRung(Bucket& events, uint64_t min, uint64_t max)
+{
+    NS_LOG_FUNCTION(this << events.size() << min << max);
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    auto n = static_cast<uint32_t>(std::min<std::size_t>(events.size(), m_maxBuckets));
+    rung.m_start = min;
+    rung.m_width = (max - min) / n + 1;
+    rung.m_nBuckets = n;
+    rung.m_current = 0;
+    rung.m_count = events.size();
+    if (rung.m_bucket.size() < n)
+    {
+        rung.m_bucket.resize(n);
+    }
+    for (const auto& ev : events)
+    {
+        rung.m_bucket[rung.Index(ev.key.m_ts)].push_back(ev);
+    }
+    events.clear();
+}
+
+void
+LadderScheduler::FillBottom(Bucket& events)
+{
+    NS_LOG_FUNCTION(this << events.size());
+    NS_ASSERT(m_bottom.empty());
+    std::sort(events.begin(), events.end());
+    m_bottom.assign(events.begin(), events.end());
+    events.clear();
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+    while (m_bottom.empty())
+    {
+        if (m_nRungs > 0)
+        {
+            Rung& rung = m_rungs[m_nRungs - 1];
+            if (rung.m_count == 0)
+            {
+                --m_nRungs;
+                continue;
+            }
+            while (rung.m_bucket[rung.m_current].empty())
+            {
+                ++rung.m_current;
+            }
+            m_scratch.swap(rung.m_bucket[rung.m_current]);
+            ++rung.m_current;
+            rung.m_count -= m_scratch.size();
+            if (rung.m_count == 0)
+            {
+                // Retire the rung now: its last bucket may extend past
+                // CurrentStart(), which would then be wrong
+                --m_nRungs;
+            }
+        }
+        else if (!m_top.empty())
+        {
+            m_scratch.swap(m_top);
+            m_topStart = m_topMax + 1;
+        }
+        else
+        {
+            return;
+        }
+
+        uint64_t min = m_scratch.front().key.m_ts;
+        uint64_t max = min;
+        for (const auto& ev : m_scratch)
+        {
+            min = std::min(min, ev.key.m_ts);
+            max = std::max(max, ev.key.m_ts);
+        }
+        if (m_scratch.size() > m_threshold && m_nRungs < m_maxRungs && min != max)
+        {
+            SpawnRung(m_scratch, min, max);
+        }
+        else
+        {
+            FillBottom(m_scratch);
+        }
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_bottom.empty();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom.front();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Event ev = m_bottom.front();
+    m_bottom.pop_front();
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+    NS_LOG_DEBUG("remove " << ev.impl << ", time=" << ev.key.m_ts << ", uid=" << ev.key.m_uid);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    Bucket* bucket = nullptr;
+    Rung* rung = nullptr;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_nRungs; ++i)
+        {
+            if (ts >= m_rungs[i].CurrentStart())
+            {
+                rung = &m_rungs[i];
+                bucket = &rung->m_bucket[rung->Index(ts)];
+                break;
+            }
+        }
+    }
+
+    if (bucket == nullptr)
+    {
+        auto it = std::lower_bound(m_bottom.begin(), m_bottom.end(), ev);
+        NS_ASSERT(it != m_bottom.end() && *it == ev);
+        m_bottom.erase(it);
+    }
+    else
+    {
+        auto it = std::find(bucket->begin(), bucket->end(), ev);
+        NS_ASSERT(it != bucket->end());
+        *it = bucket->back();
+        bucket->pop_back();
+        if (rung != nullptr)
+        {
+            --rung->m_count;
+        }
+    }
+
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+}
+
+} // namespace ns3
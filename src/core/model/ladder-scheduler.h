@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup scheduler
+ * @brief a ladder queue event scheduler
+ *
+ * This class implements the Ladder Queue of Tang, Goh and Thng
+ * (ACM TOMACS 15(3), 2005), which is designed to keep constant
+ * amortized cost under skewed and changing event time distributions.
+ *
+ * Events are kept in three tiers:
+ *
+ * - \b Top: an unsorted vector of the events furthest in the future,
+ *   with all timestamps at or after a moving threshold.  Inserting
+ *   there is a \c push_back.
+ * - \b Ladder: a stack of up to \c MaxRungs rungs, each an array of
+ *   buckets of equal width.  When the near future runs out, the top is
+ *   spread over a new rung with as many buckets as events, so its
+ *   bucket width adapts to the current event density.  A bucket holding
+ *   more than \c Threshold events is spread over a finer rung instead of
+ *   being sorted.
+ * - \b Bottom: a short sorted deque, from which events are removed at
+ *   the front.  Events scheduled for the current time are inserted near
+ *   its front.  If direct insertions make it grow beyond a few times
+ *   \c Threshold it is turned back into a rung.
+ *
+ * Each event is moved from one tier to the next a bounded number of times,
+ * and only buckets of at most \c Threshold events are ever sorted.
+ *
+ * @par Time Complexity
+ *
+ * Operation    | Amortized %Time  | Reason
+ * :----------- | :--------------- | :-----
+ * Insert()     | Constant         | Append to the top or a bucket
+ * IsEmpty()    | Constant         | `std::deque::empty()`
+ * PeekNext()   | Constant         | `std::deque::front()`
+ * Remove()     | Linear in bucket | Search in a single bucket
+ * RemoveNext() | Constant         | Amortized transfers between tiers
+ *
+ * @par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x `sizeof (*)` per bucket      | `std::vector` per bucket, reused
+ * Per Event | 0                                | Events stored in containers directly
+ *
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Events in one bucket, unsorted. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /**
+     * One rung of the ladder.
+     *
+     * Bucket \c i covers timestamps from
+     * <tt>m_start + i * m_width</tt> to the start of bucket \c i+1;
+     * the last bucket extends to the start of the parent bucket's successor.
+     */
+    struct Rung
+    {
+        uint64_t m_start;             //!< Timestamp of the start of the first bucket.
+        uint64_t m_width;             //!< Bucket width.
+        uint32_t m_nBuckets;          //!< Number of buckets in use.
+        uint32_t m_current;           //!< First bucket which may be non-empty.
+        uint64_t m_count;             //!< Number of events in this rung.
+        std::vector<Bucket> m_bucket; //!< The buckets; may be larger than m_nBuckets.
+
+        /**
+         * Get the start of the current bucket.  Events at or after
+         * this timestamp, and before the end of the rung, belong here.
+         * @returns The start of the current bucket.
+         */
+        uint64_t CurrentStart() const
+        {
+            return m_start + m_current * m_width;
+        }
+
+        /**
+         * Get the bucket index for a timestamp.
+         * @param [in] ts The timestamp, at or after CurrentStart().
+         * @returns The bucket index.
+         */
+        uint32_t Index(uint64_t ts) const
+        {
+            uint64_t i = (ts - m_start) / m_width;
+            return i < m_nBuckets ? static_cast<uint32_t>(i) : m_nBuckets - 1;
+        }
+    };
+
+    /**
+     * Spread events over a new rung at the bottom of the ladder.
+     *
+     * @param [in,out] events The events, which are moved out.
+     * @param [in] min The earliest timestamp in \p events.
+     * @param [in] max The latest timestamp in \p events.
+     */
+    void SpawnRung(Bucket& events, uint64_t min, uint64_t max);
+    /**
+     * Sort events into the (empty) bottom.
+     *
+     * @param [in,out] events The events, which are moved out.
+     */
+    void FillBottom(Bucket& events);
+    /** Refill the bottom from the ladder or the top, if it is empty. */
+    void Refill();
+    /**
+     * Insert an event into the bottom, keeping it sorted.
+     * @param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+
+    /** Events at or after m_topStart, unsorted. */
+    Bucket m_top;
+    /** Timestamps at or after this go to the top. */
+    uint64_t m_topStart;
+    /** Earliest timestamp in the top. */
+    uint64_t m_topMin;
+    /** Latest timestamp in the top. */
+    uint64_t m_topMax;
+    /** The rungs; the first m_nRungs are in use, the rest are kept for reuse. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** The bottom, sorted in increasing order. */
+    std::deque<Scheduler::Event> m_bottom;
+    /** Scratch space for events in transit between tiers. */
+    Bucket m_scratch;
+
+    /** Largest bucket which is sorted rather than spread over a new rung. */
+    uint32_t m_threshold;
+    /** Maximum number of rungs. */
+    uint32_t m_maxRungs;
+    /** Maximum number of buckets in a rung. */
+    uint32_t m_maxBuckets;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
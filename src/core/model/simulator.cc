@@ -147,6 +147,14 @@ Simulator::Destroy()
     (*pimpl)->Destroy();
     (*pimpl)->Unref();
     *pimpl = nullptr;
+
+    EventImpl::PoolStats pool = EventImpl::GetPoolStats();
+    NS_LOG_INFO("event allocations " << pool.allocations << ", recycled " << pool.hits << " ("
+                                     << (pool.allocations ? 100.0 * pool.hits / pool.allocations : 0)
+                                     << "%), oversize " << pool.oversize << ", bytes recycled "
+                                     << pool.recycledBytes << ", pool chunk bytes "
+                                     << pool.chunkBytes);
+    EventImpl::ResetPoolStats();
 }
 
 void
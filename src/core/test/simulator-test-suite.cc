@@ -6,12 +6,23 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/calendar-scheduler.h"
+#include "ns3/event-impl.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 using namespace ns3;
 
@@ -640,6 +651,307 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * @ingroup simulator-tests
+ *
+ * @brief Check that EventImpl storage is recycled by the event pool.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Reschedule itself until \p n reaches zero.
+     * @param [in] n The number of events left.
+     */
+    void Chain(uint32_t n);
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check EventImpl pool recycling")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Chain(uint32_t n)
+{
+    if (n > 0)
+    {
+        Simulator::Schedule(NanoSeconds(1), &SimulatorEventPoolTestCase::Chain, this, n - 1);
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    EventImpl::ResetPoolStats();
+    Simulator::Schedule(NanoSeconds(1), &SimulatorEventPoolTestCase::Chain, this, 999);
+    Simulator::Run();
+
+    EventImpl::PoolStats stats = EventImpl::GetPoolStats();
+    NS_TEST_EXPECT_MSG_EQ(stats.allocations, 1000, "One allocation per event");
+    NS_TEST_EXPECT_MSG_EQ(stats.oversize, 0, "Events should fit in the pool");
+    // Each event is freed just before the next one is allocated, apart from
+    // the first few which may need fresh chunks
+    NS_TEST_EXPECT_MSG_GT(stats.hits, 990, "Freed events should be recycled");
+
+    Simulator::Destroy();
+    stats = EventImpl::GetPoolStats();
+    NS_TEST_EXPECT_MSG_EQ(stats.allocations, 0, "Statistics are reset by Destroy");
+}
+
+/**
+ * @ingroup simulator-tests
+ *
+ * @brief Check that a thread which only allocates events reuses the
+ * blocks another thread frees, instead of carving new chunks forever.
+ */
+class SimulatorEventPoolHandoffTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolHandoffTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Allocate batches of events and hand them to the main thread. */
+    void Producer();
+
+    std::mutex m_mutex;              //!< Protects m_batch and m_done.
+    std::condition_variable m_cv;    //!< Signals a handoff.
+    std::vector<EventImpl*> m_batch; //!< Events handed to the main thread.
+    bool m_done{false};              //!< The producer has finished.
+    uint64_t m_chunkBytes{0};        //!< Chunk bytes taken by the producer.
+};
+
+SimulatorEventPoolHandoffTestCase::SimulatorEventPoolHandoffTestCase()
+    : TestCase("Check EventImpl blocks freed by another thread are reused")
+{
+}
+
+void
+SimulatorEventPoolHandoffTestCase::Producer()
+{
+    EventImpl::ResetPoolStats();
+    for (uint32_t round = 0; round < 100; ++round)
+    {
+        std::vector<EventImpl*> batch;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            batch.push_back(MakeEvent([]() {}));
+        }
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this]() { return m_batch.empty(); });
+        m_batch.swap(batch);
+        m_cv.notify_all();
+    }
+    m_chunkBytes = EventImpl::GetPoolStats().chunkBytes;
+    std::unique_lock lock{m_mutex};
+    m_cv.wait(lock, [this]() { return m_batch.empty(); });
+    m_done = true;
+    m_cv.notify_all();
+}
+
+void
+SimulatorEventPoolHandoffTestCase::DoRun()
+{
+    std::thread producer(&SimulatorEventPoolHandoffTestCase::Producer, this);
+    while (true)
+    {
+        std::vector<EventImpl*> batch;
+        {
+            std::unique_lock lock{m_mutex};
+            m_cv.wait(lock, [this]() { return !m_batch.empty() || m_done; });
+            if (m_batch.empty())
+            {
+                break;
+            }
+            batch.swap(m_batch);
+            m_cv.notify_all();
+        }
+        for (auto ev : batch)
+        {
+            ev->Unref();
+        }
+    }
+    producer.join();
+
+    // 100000 events take several MiB; the producer should only need chunks
+    // for the events in flight and those held by the freeing thread
+    NS_TEST_EXPECT_MSG_LT(m_chunkBytes, 1024 * 1024, "Freed events should return to the producer");
+}
+
+/**
+ * @ingroup simulator-tests
+ *
+ * @brief Check LadderScheduler against MapScheduler under a random load.
+ *
+ * Thousands of events, many with equal timestamps, are inserted,
+ * removed by Remove() and dequeued in the order a simulator would,
+ * including bursts into the bottom which are spread over a rung again.
+ * Every dequeued event must match the one MapScheduler returns.
+ */
+class LadderSchedulerStressTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * @param [in] threshold The LadderScheduler Threshold attribute.
+     * @param [in] maxRungs The LadderScheduler MaxRungs attribute.
+     */
+    LadderSchedulerStressTestCase(uint32_t threshold, uint32_t maxRungs);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Insert an event into both schedulers.
+     * @param [in] ts The event timestamp.
+     */
+    void Insert(uint64_t ts);
+    /** Remove the next event from both schedulers and compare them. */
+    void RemoveNext();
+    /**
+     * Remove a random pending event from both schedulers.
+     */
+    void RemoveRandom();
+
+    uint32_t m_threshold;             //!< LadderScheduler Threshold.
+    uint32_t m_maxRungs;              //!< LadderScheduler MaxRungs.
+    Ptr<Scheduler> m_ladder;          //!< The scheduler under test.
+    Ptr<Scheduler> m_map;             //!< The reference scheduler.
+    Ptr<UniformRandomVariable> m_rng; //!< Timestamps and operations.
+    std::vector<Scheduler::Event> m_pending;      //!< Events not yet removed.
+    std::unordered_map<uint32_t, size_t> m_index; //!< Uid to index in m_pending.
+    uint64_t m_now;                               //!< Timestamp of the last dequeued event.
+    uint32_t m_uid;                               //!< Next event uid.
+};
+
+LadderSchedulerStressTestCase::LadderSchedulerStressTestCase(uint32_t threshold, uint32_t maxRungs)
+    : TestCase("Check LadderScheduler against MapScheduler, Threshold=" +
+               std::to_string(threshold) + " MaxRungs=" + std::to_string(maxRungs)),
+      m_threshold(threshold),
+      m_maxRungs(maxRungs),
+      m_now(0),
+      m_uid(1)
+{
+}
+
+void
+LadderSchedulerStressTestCase::Insert(uint64_t ts)
+{
+    Scheduler::Event ev;
+    ev.impl = nullptr;
+    ev.key.m_ts = ts;
+    ev.key.m_uid = m_uid++;
+    ev.key.m_context = 0;
+    m_ladder->Insert(ev);
+    m_map->Insert(ev);
+    m_index[ev.key.m_uid] = m_pending.size();
+    m_pending.push_back(ev);
+}
+
+void
+LadderSchedulerStressTestCase::RemoveNext()
+{
+    Scheduler::Event a = m_ladder->RemoveNext();
+    Scheduler::Event b = m_map->RemoveNext();
+    NS_TEST_EXPECT_MSG_EQ(a.key.m_uid, b.key.m_uid, "Wrong event dequeued at " << b.key.m_ts);
+    NS_TEST_EXPECT_MSG_EQ(a.key.m_ts, b.key.m_ts, "Wrong timestamp");
+    m_now = a.key.m_ts;
+    size_t i = m_index[a.key.m_uid];
+    m_index[m_pending.back().key.m_uid] = i;
+    m_pending[i] = m_pending.back();
+    m_pending.pop_back();
+    m_index.erase(a.key.m_uid);
+}
+
+void
+LadderSchedulerStressTestCase::RemoveRandom()
+{
+    size_t i = m_rng->GetInteger(0, m_pending.size() - 1);
+    Scheduler::Event ev = m_pending[i];
+    m_ladder->Remove(ev);
+    m_map->Remove(ev);
+    m_index[m_pending.back().key.m_uid] = i;
+    m_pending[i] = m_pending.back();
+    m_pending.pop_back();
+    m_index.erase(ev.key.m_uid);
+}
+
+void
+LadderSchedulerStressTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::LadderScheduler");
+    factory.Set("Threshold", UintegerValue(m_threshold));
+    factory.Set("MaxRungs", UintegerValue(m_maxRungs));
+    m_ladder = factory.Create<Scheduler>();
+    m_map = CreateObject<MapScheduler>();
+    m_rng = CreateObject<UniformRandomVariable>();
+    m_rng->SetStream(1);
+
+    // A large initial population, a fifth of it on a few shared timestamps,
+    // so the first rungs have crowded buckets to spread again
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        uint64_t ts = m_rng->GetValue() < 0.2 ? 1000 * m_rng->GetInteger(0, 9)
+                                              : m_rng->GetInteger(0, 1000000);
+        Insert(ts);
+    }
+
+    for (uint32_t step = 0; step < 40000; ++step)
+    {
+        double op = m_rng->GetValue();
+        if (op < 0.45 || m_pending.empty())
+        {
+            // Now, the near future or the far future
+            double when = m_rng->GetValue();
+            uint64_t delay = when < 0.2   ? 0
+                             : when < 0.6 ? m_rng->GetInteger(0, 10)
+                                          : m_rng->GetInteger(0, 10000000);
+            Insert(m_now + delay);
+        }
+        else if (op < 0.85)
+        {
+            RemoveNext();
+            if (IsStatusFailure())
+            {
+                return;
+            }
+        }
+        else
+        {
+            RemoveRandom();
+        }
+
+        // Now and then a burst just ahead of the current time, which lands
+        // in the bottom until it is spread over a new rung
+        if (step % 5000 == 4999)
+        {
+            for (uint32_t i = 0; i < 10 * m_threshold; ++i)
+            {
+                Insert(m_now + m_rng->GetInteger(0, 3));
+            }
+        }
+    }
+
+    while (!m_pending.empty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_ladder->IsEmpty(), false, "LadderScheduler ran out of events");
+        RemoveNext();
+        if (IsStatusFailure())
+        {
+            return;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_ladder->IsEmpty(), true, "LadderScheduler has extra events");
+    NS_TEST_EXPECT_MSG_EQ(m_map->IsEmpty(), true, "MapScheduler has extra events");
+}
+
 /**
  * @ingroup simulator-tests
  *
@@ -663,6 +975,12 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new LadderSchedulerStressTestCase(50, 8), TestCase::Duration::QUICK);
+        AddTestCase(new LadderSchedulerStressTestCase(4, 2), TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorEventPoolTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorEventPoolHandoffTestCase(), TestCase::Duration::QUICK);
     }
 };
 
@@ -13,6 +13,9 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace ns3
 {
 
@@ -24,6 +27,7 @@ Ipv4EndPointDemux::Ipv4EndPointDemux()
       m_portFirst(49152)
 {
     NS_LOG_FUNCTION(this);
+    m_ephemeralUsed.resize((m_portLast - m_portFirst) / 64 + 1, 0);
 }
 
 Ipv4EndPointDemux::~Ipv4EndPointDemux()
@@ -37,28 +41,158 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux()
     m_endPoints.clear();
 }
 
-bool
-Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+std::size_t
+Ipv4EndPointDemux::EndPointKeyHash::operator()(const EndPointKey& key) const
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    Ipv4AddressHash hashAddress;
+    std::size_t h = hashAddress(key.localAddress);
+    h ^= hashAddress(key.peerAddress) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= ((key.localPort << 16) | key.peerPort) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+Ipv4EndPointDemux::EndPointKey
+Ipv4EndPointDemux::GetKey(const Ipv4EndPoint* endPoint)
+{
+    return EndPointKey{endPoint->GetLocalAddress(),
+                       endPoint->GetLocalPort(),
+                       endPoint->GetPeerAddress(),
+                       endPoint->GetPeerPort()};
+}
+
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    EndPointRecord record;
+    record.key = GetKey(endPoint);
+    record.position = m_endPoints.insert(m_endPoints.end(), endPoint);
+    EndPoints& port = m_ports[record.key.localPort];
+    if (port.empty())
+    {
+        SetEphemeralPortUsed(record.key.localPort, true);
+    }
+    record.portPosition = port.insert(port.end(), endPoint);
+    EndPoints& tuple = m_tuples[record.key];
+    record.tuplePosition = tuple.insert(tuple.end(), endPoint);
+    m_records[endPoint] = record;
+    endPoint->SetChangeCallback(MakeCallback(&Ipv4EndPointDemux::ReIndex, this, endPoint));
+    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+}
+
+void
+Ipv4EndPointDemux::ReIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    EndPointRecord& record = m_records.at(endPoint);
+    EndPointKey key = GetKey(endPoint);
+    if (key == record.key)
     {
-        if ((*i)->GetLocalPort() == port)
+        return;
+    }
+    // the local port of an IPv4 endpoint never changes, so only its tuple moves
+    auto tuple = m_tuples.find(record.key);
+    tuple->second.erase(record.tuplePosition);
+    if (tuple->second.empty())
+    {
+        m_tuples.erase(tuple);
+    }
+    record.key = key;
+    EndPoints& newTuple = m_tuples[key];
+    record.tuplePosition = newTuple.insert(newTuple.end(), endPoint);
+}
+
+void
+Ipv4EndPointDemux::AddMatches(const EndPointKey& key,
+                              Ptr<Ipv4Interface> incomingInterface,
+                              EndPoints& endPoints) const
+{
+    auto tuple = m_tuples.find(key);
+    if (tuple == m_tuples.end())
+    {
+        return;
+    }
+    for (Ipv4EndPoint* endP : tuple->second)
+    {
+        NS_LOG_DEBUG("Looking at endpoint dport="
+                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+
+        if (!endP->IsRxEnabled())
         {
-            return true;
+            NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                              << " because endpoint can not receive packets");
+            continue;
+        }
+        if (endP->GetBoundNetDevice())
+        {
+            if (!incomingInterface || endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            {
+                NS_LOG_LOGIC("Skipping endpoint "
+                             << &endP << " because endpoint is bound to specific device and"
+                             << endP->GetBoundNetDevice() << " does not match packet device");
+                continue;
+            }
         }
+        endPoints.push_back(endP);
     }
-    return false;
+}
+
+void
+Ipv4EndPointDemux::SetEphemeralPortUsed(uint16_t port, bool used)
+{
+    if (port < m_portFirst || port > m_portLast)
+    {
+        return;
+    }
+    uint32_t index = port - m_portFirst;
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (used)
+    {
+        m_ephemeralUsed[index / 64] |= bit;
+    }
+    else
+    {
+        m_ephemeralUsed[index / 64] &= ~bit;
+    }
+}
+
+int32_t
+Ipv4EndPointDemux::FindFreeEphemeralPort(uint32_t from, uint32_t to) const
+{
+    uint32_t index = from;
+    while (index < to)
+    {
+        uint64_t free = ~m_ephemeralUsed[index / 64] >> (index % 64);
+        if (free != 0)
+        {
+            index += std::countr_zero(free);
+            return index < to ? index : -1;
+        }
+        index = (index / 64 + 1) * 64;
+    }
+    return -1;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.contains(port);
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_ports.find(port);
+    if (endPoints == m_ports.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (Ipv4EndPoint* endP : endPoints->second)
+    {
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -77,8 +211,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -93,8 +226,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -116,8 +248,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -129,22 +260,21 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto tuple = m_tuples.find(EndPointKey{localAddress, localPort, peerAddress, peerPort});
+    if (tuple != m_tuples.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv4EndPoint* endP : tuple->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
-
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -152,15 +282,27 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto record = m_records.find(endPoint);
+    if (record == m_records.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    m_endPoints.erase(record->second.position);
+    auto port = m_ports.find(record->second.key.localPort);
+    port->second.erase(record->second.portPosition);
+    if (port->second.empty())
+    {
+        m_ports.erase(port);
+        SetEphemeralPortUsed(record->second.key.localPort, false);
+    }
+    auto tuple = m_tuples.find(record->second.key);
+    tuple->second.erase(record->second.tuplePosition);
+    if (tuple->second.empty())
+    {
+        m_tuples.erase(tuple);
+    }
+    m_records.erase(record);
+    delete endPoint;
 }
 
 /*
@@ -200,132 +342,52 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (!m_ports.contains(dport))
     {
-        Ipv4EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
-
-        if (endP->GetLocalPort() != dport)
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
-        if (endP->GetBoundNetDevice())
-        {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
-            {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
-            }
-        }
-
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
-
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
-
-        if (endP->GetLocalAddress() == daddr)
-        {
-            // Case 1:
-            localAddressMatchesExact = true;
-        }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
-        {
-            // Case 2:
-            localAddressIsAny = true;
-        }
-        else
-        {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
-            {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
-
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
-                {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
-
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
-                    {
-                        localAddressIsSubnetAny = true;
-                    }
-                }
-            }
-
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
-            {
-                continue;
-            }
-        }
+        return retval1;
+    }
 
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
+    // The local address of an endpoint matches in 3 cases:
+    // 1) Exact local / destination address match
+    // 2) Local endpoint bound to Any -> matches anything
+    // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
+    // x.y.z.255 in a /24 net) and direct destination match.
+    // The last two are wildcards, looked up at each of their addresses.
+    std::vector<Ipv4Address> wildcards;
+    if (daddr != Ipv4Address::GetAny())
+    {
+        wildcards.push_back(Ipv4Address::GetAny());
+    }
+    for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses(); i++)
+    {
+        Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
 
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+        if (addrNetpart != daddr && addrNetpart != Ipv4Address::GetAny() &&
+            daddr.CombineMask(addr.GetMask()) == addrNetpart &&
+            std::find(wildcards.begin(), wildcards.end(), addrNetpart) == wildcards.end())
         {
-            continue;
+            NS_LOG_LOGIC("Looking for SubnetDirectedAny endpoints "
+                         << addrNetpart << "/" << addr.GetMask().GetPrefixLength());
+            wildcards.push_back(addrNetpart);
         }
+    }
 
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
-
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
-        }
+    // All 4 match - this is the case of an open TCP connection, for example.
+    AddMatches(EndPointKey{daddr, dport, saddr, sport}, incomingInterface, retval4);
+    // All but local address - no idea what this case could be.
+    for (const auto& wildcard : wildcards)
+    {
+        AddMatches(EndPointKey{wildcard, dport, saddr, sport}, incomingInterface, retval3);
+    }
+    // Only local port and local address matches exactly - Not yet opened connection
+    AddMatches(EndPointKey{daddr, dport, Ipv4Address::GetAny(), 0}, incomingInterface, retval2);
+    // Only local port matches exactly - Endpoint open to "any" connection
+    for (const auto& wildcard : wildcards)
+    {
+        AddMatches(EndPointKey{wildcard, dport, Ipv4Address::GetAny(), 0},
+                   incomingInterface,
+                   retval1);
     }
 
     // Here we find the most exact match
@@ -365,12 +427,13 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
     // function.
     uint32_t genericity = 3;
     Ipv4EndPoint* generic = nullptr;
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_ports.find(dport);
+    if (endPoints == m_ports.end())
+    {
+        return generic;
+    }
+    for (auto i = endPoints->second.begin(); i != endPoints->second.end(); i++)
     {
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
         if ((*i)->GetLocalAddress() == daddr && (*i)->GetPeerPort() == sport &&
             (*i)->GetPeerAddress() == saddr)
         {
@@ -398,24 +461,26 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 uint16_t
 Ipv4EndPointDemux::AllocateEphemeralPort()
 {
-    // Similar to counting up logic in netinet/in_pcb.c
+    // Similar to counting up logic in netinet/in_pcb.c: the first free port
+    // after the last allocated one, wrapping around the range
     NS_LOG_FUNCTION(this);
-    uint16_t port = m_ephemeral;
-    int count = m_portLast - m_portFirst;
-    do
+    uint32_t count = m_portLast - m_portFirst + 1;
+    uint32_t start = 0;
+    if (m_ephemeral >= m_portFirst && m_ephemeral < m_portLast)
     {
-        if (count-- < 0)
-        {
-            return 0;
-        }
-        ++port;
-        if (port < m_portFirst || port > m_portLast)
-        {
-            port = m_portFirst;
-        }
-    } while (LookupPortLocal(port));
-    m_ephemeral = port;
-    return port;
+        start = m_ephemeral + 1 - m_portFirst;
+    }
+    int32_t index = FindFreeEphemeralPort(start, count);
+    if (index < 0)
+    {
+        index = FindFreeEphemeralPort(0, start);
+    }
+    if (index < 0)
+    {
+        return 0;
+    }
+    m_ephemeral = m_portFirst + index;
+    return m_ephemeral;
 }
 
 } // namespace ns3
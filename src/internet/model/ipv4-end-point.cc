@@ -51,6 +51,10 @@ Ipv4EndPoint::SetLocalAddress(Ipv4Address address)
 {
     NS_LOG_FUNCTION(this << address);
     m_localAddr = address;
+    if (!m_changeCallback.IsNull())
+    {
+        m_changeCallback();
+    }
 }
 
 uint16_t
@@ -80,6 +84,10 @@ Ipv4EndPoint::SetPeer(Ipv4Address address, uint16_t port)
     NS_LOG_FUNCTION(this << address << port);
     m_peerAddr = address;
     m_peerPort = port;
+    if (!m_changeCallback.IsNull())
+    {
+        m_changeCallback();
+    }
 }
 
 void
@@ -119,6 +127,13 @@ Ipv4EndPoint::SetDestroyCallback(Callback<void> callback)
     m_destroyCallback = callback;
 }
 
+void
+Ipv4EndPoint::SetChangeCallback(Callback<void> callback)
+{
+    NS_LOG_FUNCTION(this << &callback);
+    m_changeCallback = callback;
+}
+
 void
 Ipv4EndPoint::ForwardUp(Ptr<Packet> p,
                         const Ipv4Header& header,
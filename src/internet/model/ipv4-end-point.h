@@ -133,6 +133,14 @@ class Ipv4EndPoint
      * @param callback callback function
      */
     void SetDestroyCallback(Callback<void> callback);
+    /**
+     * @brief Set the callback invoked when the addresses or ports change.
+     *
+     * The endpoint demux uses it to keep its lookup tables up to date.
+     *
+     * @param callback callback function
+     */
+    void SetChangeCallback(Callback<void> callback);
 
     /**
      * @brief Forward the packet to the upper level.
@@ -220,6 +228,11 @@ class Ipv4EndPoint
      */
     Callback<void> m_destroyCallback;
 
+    /**
+     * @brief The change callback.
+     */
+    Callback<void> m_changeCallback;
+
     /**
      * @brief true if the endpoint can receive packets.
      */
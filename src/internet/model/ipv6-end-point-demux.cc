@@ -12,6 +12,8 @@
 
 #include "ns3/log.h"
 
+#include <bit>
+
 namespace ns3
 {
 
@@ -23,6 +25,7 @@ Ipv6EndPointDemux::Ipv6EndPointDemux()
       m_portLast(65535)
 {
     NS_LOG_FUNCTION(this);
+    m_ephemeralUsed.resize((m_portLast - m_portFirst) / 64 + 1, 0);
 }
 
 Ipv6EndPointDemux::~Ipv6EndPointDemux()
@@ -36,28 +39,173 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux()
     m_endPoints.clear();
 }
 
-bool
-Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+std::size_t
+Ipv6EndPointDemux::EndPointKeyHash::operator()(const EndPointKey& key) const
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    Ipv6AddressHash hashAddress;
+    std::size_t h = hashAddress(key.localAddress);
+    h ^= hashAddress(key.peerAddress) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= ((key.localPort << 16) | key.peerPort) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+Ipv6EndPointDemux::EndPointKey
+Ipv6EndPointDemux::GetKey(const Ipv6EndPoint* endPoint)
+{
+    return EndPointKey{endPoint->GetLocalAddress(),
+                       endPoint->GetLocalPort(),
+                       endPoint->GetPeerAddress(),
+                       endPoint->GetPeerPort()};
+}
+
+void
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    EndPointRecord record;
+    record.key = GetKey(endPoint);
+    record.position = m_endPoints.insert(m_endPoints.end(), endPoint);
+    EndPoints& port = m_ports[record.key.localPort];
+    if (port.empty())
+    {
+        SetEphemeralPortUsed(record.key.localPort, true);
+    }
+    record.portPosition = port.insert(port.end(), endPoint);
+    EndPoints& tuple = m_tuples[record.key];
+    record.tuplePosition = tuple.insert(tuple.end(), endPoint);
+    m_records[endPoint] = record;
+    endPoint->SetChangeCallback(MakeCallback(&Ipv6EndPointDemux::ReIndex, this, endPoint));
+    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+}
+
+void
+Ipv6EndPointDemux::ReIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    EndPointRecord& record = m_records.at(endPoint);
+    EndPointKey key = GetKey(endPoint);
+    if (key == record.key)
+    {
+        return;
+    }
+    if (key.localPort != record.key.localPort)
     {
-        if ((*i)->GetLocalPort() == port)
+        auto port = m_ports.find(record.key.localPort);
+        port->second.erase(record.portPosition);
+        if (port->second.empty())
         {
-            return true;
+            m_ports.erase(port);
+            SetEphemeralPortUsed(record.key.localPort, false);
         }
+        EndPoints& newPort = m_ports[key.localPort];
+        if (newPort.empty())
+        {
+            SetEphemeralPortUsed(key.localPort, true);
+        }
+        record.portPosition = newPort.insert(newPort.end(), endPoint);
     }
-    return false;
+    auto tuple = m_tuples.find(record.key);
+    tuple->second.erase(record.tuplePosition);
+    if (tuple->second.empty())
+    {
+        m_tuples.erase(tuple);
+    }
+    record.key = key;
+    EndPoints& newTuple = m_tuples[key];
+    record.tuplePosition = newTuple.insert(newTuple.end(), endPoint);
+}
+
+void
+Ipv6EndPointDemux::AddMatches(const EndPointKey& key,
+                              Ptr<Ipv6Interface> incomingInterface,
+                              EndPoints& endPoints) const
+{
+    auto tuple = m_tuples.find(key);
+    if (tuple == m_tuples.end())
+    {
+        return;
+    }
+    for (Ipv6EndPoint* endP : tuple->second)
+    {
+        NS_LOG_DEBUG("Looking at endpoint dport="
+                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+
+        if (!endP->IsRxEnabled())
+        {
+            NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                              << " because endpoint can not receive packets");
+            continue;
+        }
+        if (endP->GetBoundNetDevice())
+        {
+            if (!incomingInterface || endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            {
+                NS_LOG_LOGIC("Skipping endpoint "
+                             << &endP << " because endpoint is bound to specific device and"
+                             << endP->GetBoundNetDevice() << " does not match packet device");
+                continue;
+            }
+        }
+        endPoints.push_back(endP);
+    }
+}
+
+void
+Ipv6EndPointDemux::SetEphemeralPortUsed(uint16_t port, bool used)
+{
+    if (port < m_portFirst || port > m_portLast)
+    {
+        return;
+    }
+    uint32_t index = port - m_portFirst;
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (used)
+    {
+        m_ephemeralUsed[index / 64] |= bit;
+    }
+    else
+    {
+        m_ephemeralUsed[index / 64] &= ~bit;
+    }
+}
+
+int32_t
+Ipv6EndPointDemux::FindFreeEphemeralPort(uint32_t from, uint32_t to) const
+{
+    uint32_t index = from;
+    while (index < to)
+    {
+        uint64_t free = ~m_ephemeralUsed[index / 64] >> (index % 64);
+        if (free != 0)
+        {
+            index += std::countr_zero(free);
+            return index < to ? index : -1;
+        }
+        index = (index / 64 + 1) * 64;
+    }
+    return -1;
+}
+
+bool
+Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.contains(port);
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_ports.find(port);
+    if (endPoints == m_ports.end())
+    {
+        return false;
+    }
+    for (Ipv6EndPoint* endP : endPoints->second)
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -76,8 +224,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -92,8 +239,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -115,8 +261,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -128,22 +273,21 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto tuple = m_tuples.find(EndPointKey{localAddress, localPort, peerAddress, peerPort});
+    if (tuple != m_tuples.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv6EndPoint* endP : tuple->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
-
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-
+    Insert(endPoint);
     return endPoint;
 }
 
@@ -151,15 +295,27 @@ void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto record = m_records.find(endPoint);
+    if (record == m_records.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
+    }
+    m_endPoints.erase(record->second.position);
+    auto port = m_ports.find(record->second.key.localPort);
+    port->second.erase(record->second.portPosition);
+    if (port->second.empty())
+    {
+        m_ports.erase(port);
+        SetEphemeralPortUsed(record->second.key.localPort, false);
     }
+    auto tuple = m_tuples.find(record->second.key);
+    tuple->second.erase(record->second.tuplePosition);
+    if (tuple->second.empty())
+    {
+        m_tuples.erase(tuple);
+    }
+    m_records.erase(record);
+    delete endPoint;
 }
 
 /*
@@ -182,95 +338,19 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
     EndPoints retval4; /* Exact match on all 4 */
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (!m_ports.contains(dport))
     {
-        Ipv6EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
-
-        if (endP->GetLocalPort() != dport)
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
-
-        if (endP->GetBoundNetDevice())
-        {
-            if (!incomingInterface)
-            {
-                continue;
-            }
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
-            {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
-            }
-        }
-
-        /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-        NS_LOG_DEBUG("dest addr " << daddr);
-
-        bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
-        bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
-        bool localAddressMatchesAllRouters =
-            endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
-
-        /* if no match here, keep looking */
-        if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-            continue;
-        }
-        bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
-
-        /* If remote does not match either with exact or wildcard,i
-           skip this one */
-        if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
-
-        /* Now figure out which return list to add this one to */
-        if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
-            remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-            retval1.push_back(endP);
-        }
-        if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
-            remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All but local address */
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All 4 match */
-            retval4.push_back(endP);
-        }
+        return retval1;
     }
 
+    /* The local address of an endpoint matches if it is the destination
+       address or the wildcard, and so does its remote address and port */
+    Ipv6Address any = Ipv6Address::GetAny();
+    AddMatches(EndPointKey{daddr, dport, saddr, sport}, incomingInterface, retval4);
+    AddMatches(EndPointKey{any, dport, saddr, sport}, incomingInterface, retval3);
+    AddMatches(EndPointKey{daddr, dport, any, 0}, incomingInterface, retval2);
+    AddMatches(EndPointKey{any, dport, any, 0}, incomingInterface, retval1);
+
     // Here we find the most exact match
     EndPoints retval;
     if (!retval4.empty())
@@ -301,16 +381,16 @@ Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src
 {
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
+    auto endPoints = m_ports.find(dport);
+    if (endPoints == m_ports.end())
+    {
+        return generic;
+    }
 
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    for (auto i = endPoints->second.begin(); i != endPoints->second.end(); i++)
     {
         uint32_t tmp = 0;
 
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-
         if ((*i)->GetLocalAddress() == dst && (*i)->GetPeerPort() == sport &&
             (*i)->GetPeerAddress() == src)
         {
@@ -340,23 +420,25 @@ Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src
 uint16_t
 Ipv6EndPointDemux::AllocateEphemeralPort()
 {
+    /* the first free port after the last allocated one, wrapping around the range */
     NS_LOG_FUNCTION(this);
-    uint16_t port = m_ephemeral;
-    int count = m_portLast - m_portFirst;
-    do
+    uint32_t count = m_portLast - m_portFirst + 1;
+    uint32_t start = 0;
+    if (m_ephemeral >= m_portFirst && m_ephemeral < m_portLast)
     {
-        if (count-- < 0)
-        {
-            return 0;
-        }
-        ++port;
-        if (port < m_portFirst || port > m_portLast)
-        {
-            port = m_portFirst;
-        }
-    } while (LookupPortLocal(port));
-    m_ephemeral = port;
-    return port;
+        start = m_ephemeral + 1 - m_portFirst;
+    }
+    int32_t index = FindFreeEphemeralPort(start, count);
+    if (index < 0)
+    {
+        index = FindFreeEphemeralPort(0, start);
+    }
+    if (index < 0)
+    {
+        return 0;
+    }
+    m_ephemeral = m_portFirst + index;
+    return m_ephemeral;
 }
 
 Ipv6EndPointDemux::EndPoints
@@ -15,6 +15,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -25,6 +27,12 @@ class Ipv6EndPoint;
  * @ingroup ipv6
  *
  * @brief Demultiplexer for end points.
+ *
+ * The endpoints are indexed by local port and by their four-tuple, where
+ * an unbound address or port is stored as the wildcard, so a lookup only
+ * looks at the few tuples a packet may match instead of at every endpoint.
+ * The endpoints tell the demux when their addresses or ports change, so that
+ * the index stays up to date.  The ephemeral ports in use are kept in a bitmap.
  */
 class Ipv6EndPointDemux
 {
@@ -150,6 +158,94 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    /**
+     * @brief The addresses and ports identifying an endpoint.
+     */
+    struct EndPointKey
+    {
+        Ipv6Address localAddress; //!< Local address
+        uint16_t localPort;       //!< Local port
+        Ipv6Address peerAddress;  //!< Peer address
+        uint16_t peerPort;        //!< Peer port
+
+        /**
+         * @param other the key to compare with
+         * @return true if the keys are equal
+         */
+        bool operator==(const EndPointKey& other) const = default;
+    };
+
+    /**
+     * @brief Hash of an EndPointKey.
+     */
+    struct EndPointKeyHash
+    {
+        /**
+         * @param key the key
+         * @return the hash of the key
+         */
+        std::size_t operator()(const EndPointKey& key) const;
+    };
+
+    /**
+     * @brief The positions of an endpoint in the containers of the demux.
+     */
+    struct EndPointRecord
+    {
+        EndPointKey key;          //!< Key under which the endpoint is indexed
+        EndPointsI position;      //!< Position in the list of all the endpoints
+        EndPointsI portPosition;  //!< Position in the list of the endpoints of the port
+        EndPointsI tuplePosition; //!< Position in the list of the endpoints of the key
+    };
+
+    /**
+     * @brief Get the current key of an endpoint.
+     * @param endPoint the endpoint
+     * @return the key of the endpoint
+     */
+    static EndPointKey GetKey(const Ipv6EndPoint* endPoint);
+
+    /**
+     * @brief Add an endpoint to the demux.
+     * @param endPoint the endpoint
+     */
+    void Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * @brief Move an endpoint whose addresses or ports changed to its new key.
+     * @param endPoint the endpoint
+     */
+    void ReIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * @brief Add the endpoints of a key which may receive a packet.
+     *
+     * The endpoints which do not receive packets, or which are bound to
+     * another device than the incoming one, are skipped.
+     *
+     * @param key the key
+     * @param incomingInterface the incoming interface
+     * @param endPoints the list to which the endpoints are added
+     */
+    void AddMatches(const EndPointKey& key,
+                    Ptr<Ipv6Interface> incomingInterface,
+                    EndPoints& endPoints) const;
+
+    /**
+     * @brief Mark a port as used or free in the bitmap of the ephemeral ports.
+     * @param port the port, ignored if it is not an ephemeral port
+     * @param used whether the port is used
+     */
+    void SetEphemeralPortUsed(uint16_t port, bool used);
+
+    /**
+     * @brief Find the first free ephemeral port in a range.
+     * @param from the index of the first port of the range in the bitmap
+     * @param to the index past the last port of the range in the bitmap
+     * @return the index of the free port in the bitmap, or -1 if there is none
+     */
+    int32_t FindFreeEphemeralPort(uint32_t from, uint32_t to) const;
+
     /**
      * @brief Allocate a ephemeral port.
      * @return a port
@@ -175,6 +271,26 @@ class Ipv6EndPointDemux
      * @brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * @brief The endpoints of each local port, in allocation order.
+     */
+    std::unordered_map<uint16_t, EndPoints> m_ports;
+
+    /**
+     * @brief The endpoints of each key.
+     */
+    std::unordered_map<EndPointKey, EndPoints, EndPointKeyHash> m_tuples;
+
+    /**
+     * @brief The positions of each endpoint.
+     */
+    std::unordered_map<Ipv6EndPoint*, EndPointRecord> m_records;
+
+    /**
+     * @brief Bitmap of the ephemeral ports in use.
+     */
+    std::vector<uint64_t> m_ephemeralUsed;
 };
 
 } /* namespace ns3 */
@@ -47,6 +47,10 @@ void
 Ipv6EndPoint::SetLocalAddress(Ipv6Address addr)
 {
     m_localAddr = addr;
+    if (!m_changeCallback.IsNull())
+    {
+        m_changeCallback();
+    }
 }
 
 uint16_t
@@ -59,6 +63,10 @@ void
 Ipv6EndPoint::SetLocalPort(uint16_t port)
 {
     m_localPort = port;
+    if (!m_changeCallback.IsNull())
+    {
+        m_changeCallback();
+    }
 }
 
 Ipv6Address
@@ -90,6 +98,10 @@ Ipv6EndPoint::SetPeer(Ipv6Address addr, uint16_t port)
 {
     m_peerAddr = addr;
     m_peerPort = port;
+    if (!m_changeCallback.IsNull())
+    {
+        m_changeCallback();
+    }
 }
 
 void
@@ -112,6 +124,12 @@ Ipv6EndPoint::SetDestroyCallback(Callback<void> callback)
     m_destroyCallback = callback;
 }
 
+void
+Ipv6EndPoint::SetChangeCallback(Callback<void> callback)
+{
+    m_changeCallback = callback;
+}
+
 void
 Ipv6EndPoint::ForwardUp(Ptr<Packet> p,
                         Ipv6Header header,
@@ -140,6 +140,14 @@ class Ipv6EndPoint
      * @param callback callback function
      */
     void SetDestroyCallback(Callback<void> callback);
+    /**
+     * @brief Set the callback invoked when the addresses or ports change.
+     *
+     * The endpoint demux uses it to keep its lookup tables up to date.
+     *
+     * @param callback callback function
+     */
+    void SetChangeCallback(Callback<void> callback);
 
     /**
      * @brief Forward the packet to the upper level.
@@ -224,6 +232,11 @@ class Ipv6EndPoint
      */
     Callback<void> m_destroyCallback;
 
+    /**
+     * @brief The change callback.
+     */
+    Callback<void> m_changeCallback;
+
     /**
      * @brief true if the endpoint can receive packets.
      */
@@ -11,6 +11,9 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace ns3
 {
 
@@ -160,8 +163,13 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
+    // Remove overlapped bytes from packet. The segments before the one which
+    // may contain headSeq end before it, so start from that one.
+    auto i = m_data.upper_bound(headSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
@@ -200,28 +208,23 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     // Insert packet into buffer
     NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
     m_data[headSeq] = p;
+    TcpOptionSack::SackBlock block = AddBlock(headSeq, tailSeq);
 
     if (headSeq > m_nextRxSeq)
     {
         // Generate a new SACK block
-        UpdateSackList(headSeq, tailSeq);
+        UpdateSackList(block.first, block.second);
     }
 
     NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
     m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    if (block.first == m_nextRxSeq)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        // The hole at the head is filled: the whole block is now in sequence
+        m_blocks.erase(block.first);
+        m_availBytes += block.second - block.first;
+        m_nextRxSeq = block.second;
         ClearSackList(m_nextRxSeq);
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -250,6 +253,10 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     current.first = head;
     current.second = tail;
 
+    // The block is the whole contiguous block of data containing the new
+    // segment (see AddBlock), so the blocks listed before are either inside it
+    // or disjoint from it.
+
     // The block "current" has been safely stored. Now we need to build the SACK
     // list, to be advertised. From RFC 2018:
     // (a) The first SACK block (i.e., the one immediately following the
@@ -276,53 +283,20 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     //     following SACK blocks in the SACK option may be listed in
     //     arbitrary order.
 
-    m_sackList.push_front(current);
-
-    // We have inserted the block at the beginning of the list. Now, we should
-    // check if any existing blocks overlap with that.
-    bool updated = false;
-    auto it = m_sackList.begin();
-    TcpOptionSack::SackBlock begin = *it;
-    TcpOptionSack::SackBlock merged;
-    ++it;
-
-    // Iterates until we examined all blocks in the list (maximum 4)
-    while (it != m_sackList.end())
+    // Remove the blocks merged into the new one, and put it at the beginning
+    for (auto it = m_sackList.begin(); it != m_sackList.end();)
     {
-        current = *it;
-
-        // This is a left merge:
-        // [current_first; current_second] [beg_first; beg_second]
-        if (begin.first == current.second)
-        {
-            NS_ASSERT(current.first < begin.second);
-            merged = TcpOptionSack::SackBlock(current.first, begin.second);
-            updated = true;
-        }
-        // while this is a right merge
-        // [begin_first; begin_second] [current_first; current_second]
-        else if (begin.second == current.first)
+        if (current.first <= it->first && it->second <= current.second)
         {
-            NS_ASSERT(begin.first < current.second);
-            merged = TcpOptionSack::SackBlock(begin.first, current.second);
-            updated = true;
+            it = m_sackList.erase(it);
         }
-
-        // If we have merged the blocks (and the result is in merged) we should
-        // delete the current block (it), the first block, and insert the merged
-        // one at the beginning.
-        if (updated)
+        else
         {
-            m_sackList.erase(it);
-            m_sackList.pop_front();
-            m_sackList.push_front(merged);
-            it = m_sackList.begin();
-            begin = *it;
-            updated = false;
+            NS_ASSERT(it->second < current.first || current.second < it->first);
+            ++it;
         }
-
-        ++it;
     }
+    m_sackList.push_front(current);
 
     // Since the maximum blocks that fits into a TCP header are 4, there's no
     // point on maintaining the others.
@@ -332,9 +306,38 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     }
 
     // Please note that, if a block b is discarded and then a block contiguous
-    // to b is received, only that new block (without the b part) is reported.
-    // This is perfectly fine for the RFC point (a), given that we do not report any
-    // overlapping blocks shortly after.
+    // to b is received, the new block is reported together with b, as it is
+    // part of the contiguous block of data containing the segment (RFC point (a)).
+}
+
+TcpOptionSack::SackBlock
+TcpRxBuffer::AddBlock(const SequenceNumber32& head, const SequenceNumber32& tail)
+{
+    NS_LOG_FUNCTION(this << head << tail);
+
+    SequenceNumber32 first = head;
+    SequenceNumber32 last = tail;
+
+    // Merge with the block before, if it reaches the range
+    auto it = m_blocks.upper_bound(first);
+    if (it != m_blocks.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->second >= first)
+        {
+            first = prev->first;
+            last = std::max(last, prev->second);
+            m_blocks.erase(prev);
+        }
+    }
+    // and with the blocks after, which start inside the range or right after it
+    while (it != m_blocks.end() && it->first <= last)
+    {
+        last = std::max(last, it->second);
+        it = m_blocks.erase(it);
+    }
+    m_blocks[first] = last;
+    return TcpOptionSack::SackBlock(first, last);
 }
 
 void
@@ -376,18 +379,27 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
-    NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    NS_ASSERT(!m_data.empty()); // At least we have something to extract
+    Ptr<Packet> outPkt;         // The packet that contains all the data to return
     BufIterator i;
     while (extractSize)
     { // Check the buffered data for delivery
         i = m_data.begin();
         NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
-        // Check if we send the whole pkt or just a partial
+        // Check if we send the whole pkt or just a partial. The first piece is
+        // returned as it is, so its payload is not copied; the buffer does not
+        // keep any other reference to the packets it stores.
         uint32_t pktSize = i->second->GetSize();
         if (pktSize <= extractSize)
         { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
+            if (!outPkt)
+            {
+                outPkt = i->second;
+            }
+            else
+            {
+                outPkt->AddAtEnd(i->second);
+            }
             m_data.erase(i);
             m_size -= pktSize;
             m_availBytes -= pktSize;
@@ -395,7 +407,14 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
+            if (!outPkt)
+            {
+                outPkt = i->second->CreateFragment(0, extractSize);
+            }
+            else
+            {
+                outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
+            }
             m_data[i->first + SequenceNumber32(extractSize)] =
                 i->second->CreateFragment(extractSize, pktSize - extractSize);
             m_data.erase(i);
@@ -404,7 +423,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
             extractSize = 0;
         }
     }
-    if (outPkt->GetSize() == 0)
+    if (!outPkt || outPkt->GetSize() == 0)
     {
         NS_LOG_LOGIC("Nothing extracted.");
         return nullptr;
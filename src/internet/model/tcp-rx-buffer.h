@@ -58,6 +58,12 @@ class Packet;
  * For more information about the SACK list, please check the documentation of
  * the method GetSackList.
  *
+ * Besides the segments, the buffer keeps the blocks of contiguous data received
+ * beyond NextRxSequence, so the holes are the gaps between them. Adding a segment
+ * merges it with the neighbouring blocks in logarithmic time, which gives both
+ * the new NextRxSequence when a hole is filled and the whole block to report
+ * first in the SACK list, without walking the buffered segments.
+ *
  * @see GetSackList
  * @see UpdateSackList
  */
@@ -209,6 +215,17 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
+    /**
+     * @brief Add a range of data to the blocks received beyond NextRxSequence
+     *
+     * The range is merged with the blocks it overlaps or touches.
+     *
+     * @param head sequence number of the first byte of the range
+     * @param tail sequence number of the byte after the range
+     * @return the block which contains the range after the merge
+     */
+    TcpOptionSack::SackBlock AddBlock(const SequenceNumber32& head, const SequenceNumber32& tail);
+
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
     /// container for data stored in the buffer
@@ -221,6 +238,8 @@ class TcpRxBuffer : public Object
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
     std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    /// Blocks of contiguous data not yet in sequence: first byte, byte after the block
+    std::map<SequenceNumber32, SequenceNumber32> m_blocks;
 };
 
 } // namespace ns3
@@ -156,13 +156,16 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
 
     if (!m_sentList.empty())
     {
+        m_sentIndex.erase(m_sentList.front()->m_startSeq);
         m_sentList.front()->m_startSeq = seq;
+        m_sentIndex[seq] = m_sentList.begin();
     }
 
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_sackSeen = false;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetScanHints();
 }
 
 bool
@@ -283,7 +286,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    m_sentIndex[item->m_startSeq] = m_sentList.insert(m_sentList.end(), item);
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -297,37 +300,34 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    auto indexed = m_sentIndex.find(seq);
+    if (indexed != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = indexed->second;
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -364,6 +364,30 @@ TcpTxBuffer::FindHighestSacked() const
     return ret;
 }
 
+TcpTxBuffer::SentIndex::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    // The item which contains seq is the last one starting at or before seq
+    auto it = m_sentIndex.upper_bound(seq);
+    if (it == m_sentIndex.begin())
+    {
+        return m_sentIndex.end();
+    }
+    --it;
+    if (seq < it->first + (*it->second)->m_packet->GetSize())
+    {
+        return it;
+    }
+    return m_sentIndex.end();
+}
+
+void
+TcpTxBuffer::ResetScanHints()
+{
+    m_lostUpTo = m_firstByteSeq;
+    m_nextSegFrom = m_firstByteSeq;
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
@@ -389,7 +413,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                const SequenceNumber32& listStartFrom,
                                uint32_t numBytes,
                                const SequenceNumber32& seq,
-                               bool* listEdited) const
+                               bool* listEdited)
 {
     NS_LOG_FUNCTION(this << numBytes << seq);
 
@@ -425,12 +449,24 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     TcpTxItem* outItem = nullptr;
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
+    bool isSentList = (&list == &m_sentList);
+
+    if (isSentList)
+    {
+        // Do not walk the items which end before seq
+        auto indexed = FindSentItem(seq);
+        if (indexed != m_sentIndex.end())
+        {
+            it = indexed->second;
+            beginOfCurrentPacket = indexed->first;
+        }
+    }
 
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -459,7 +495,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto inserted = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    m_sentIndex[firstPart->m_startSeq] = inserted;
+                    m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -506,6 +547,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     TcpTxItem* previous = *(--it);
 
                     list.erase(it);
+                    if (isSentList)
+                    {
+                        m_sentIndex.erase(currentItem->m_startSeq);
+                    }
 
                     MergeItems(previous, currentItem);
                     delete currentItem;
@@ -525,7 +570,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto inserted = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    m_sentIndex[firstPart->m_startSeq] = inserted;
+                    m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -555,6 +605,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 
             MergeItems(currentItem, next);
             list.erase(it);
+            if (isSentList)
+            {
+                m_sentIndex.erase(next->m_startSeq);
+            }
 
             delete next;
 
@@ -587,19 +641,19 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        auto self = const_cast<TcpTxBuffer*>(this);
         if (t1->m_retrans)
         {
-            auto self = const_cast<TcpTxBuffer*>(this);
             self->m_retrans -= t1->m_packet->GetSize();
             t1->m_retrans = false;
         }
         else
         {
             NS_ASSERT(t2->m_retrans);
-            auto self = const_cast<TcpTxBuffer*>(this);
             self->m_retrans -= t2->m_packet->GetSize();
             t2->m_retrans = false;
         }
+        self->ResetScanHints();
     }
 
     if (t1->m_lastSent < t2->m_lastSent)
@@ -638,16 +692,15 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // The items are contiguous: the only one which may end at ack contains ack - 1
+    auto it = FindSentItem(ack - 1);
+    if (it == m_sentIndex.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    const TcpTxItem* item = *it->second;
+    return item->m_startSeq + item->m_packet->GetSize() == ack && !item->m_sacked &&
+           item->m_retrans;
 }
 
 void
@@ -695,6 +748,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            m_sentIndex.erase(item->m_startSeq);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -713,7 +767,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            m_sentIndex.erase(item->m_startSeq);
             item->m_startSeq += offset;
+            m_sentIndex[item->m_startSeq] = i;
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -732,6 +788,16 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
         m_firstByteSeq = seq;
     }
 
+    // Keep the hints of the scans inside the sent list
+    if (m_lostUpTo < m_firstByteSeq)
+    {
+        m_lostUpTo = m_firstByteSeq;
+    }
+    if (m_nextSegFrom < m_firstByteSeq)
+    {
+        m_nextSegFrom = m_firstByteSeq;
+    }
+
     if (!m_sentList.empty())
     {
         TcpTxItem* head = m_sentList.front();
@@ -777,15 +843,21 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Start from the first item which begins inside the block
+        auto indexed = m_sentIndex.lower_bound((*option_it).first);
+        if (indexed == m_sentIndex.end())
+        {
+            continue;
+        }
+        auto item_it = indexed->second;
+        SequenceNumber32 beginOfCurrentPacket = indexed->first;
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -879,12 +951,25 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
+    SequenceNumber32 lostUpTo = m_lostUpTo;
     for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
+        if (sacked >= m_dupAckThresh &&
+            item->m_startSeq + item->m_packet->GetSize() <= m_lostUpTo)
+        {
+            // This item and the ones before are already sacked or lost
+            break;
+        }
+
         if (item->m_sacked)
         {
             sacked++;
+            if (sacked == std::max<uint32_t>(m_dupAckThresh, 1) &&
+                lostUpTo < item->m_startSeq + item->m_packet->GetSize())
+            {
+                lostUpTo = item->m_startSeq + item->m_packet->GetSize();
+            }
         }
 
         if (sacked >= m_dupAckThresh)
@@ -906,6 +991,7 @@ TcpTxBuffer::UpdateLostCount()
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
         }
+        m_lostUpTo = lostUpTo;
     }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
@@ -921,24 +1007,20 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = FindSentItem(seq);
+    if (it != m_sentIndex.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+        const TcpTxItem* item = *it->second;
+        if (item->m_lost)
         {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
+        }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+        if (item->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
         }
     }
 
@@ -967,11 +1049,39 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
     SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    auto it = m_sentList.begin();
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // The items below m_nextSegFrom are retransmitted or sacked: skip them
+    if (m_nextSegFrom >= m_firstByteSeq + m_sentSize)
+    {
+        it = m_sentList.end();
+        beginOfCurrentPkt = m_firstByteSeq + m_sentSize;
+    }
+    else if (m_nextSegFrom > m_firstByteSeq)
+    {
+        auto indexed = FindSentItem(m_nextSegFrom);
+        NS_ASSERT(indexed != m_sentIndex.end());
+        it = indexed->second;
+        beginOfCurrentPkt = indexed->first;
+    }
+
+    bool nextSegFound = false;
+    for (; it != m_sentList.end(); ++it)
     {
         item = *it;
 
+        if (!nextSegFound && !item->m_retrans && !item->m_sacked)
+        {
+            m_nextSegFrom = beginOfCurrentPkt;
+            nextSegFound = true;
+        }
+
+        if (m_sackSeen && item->m_startSeq >= m_highestSack.second)
+        {
+            // Condition 1.b does not hold for this item and the following ones
+            break;
+        }
+
         // Condition 1.a , 1.b , and 1.c
         if (!item->m_retrans && !item->m_sacked &&
             ((m_sackSeen && item->m_startSeq < m_highestSack.second) || !m_sackSeen))
@@ -995,6 +1105,11 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
         beginOfCurrentPkt += item->m_packet->GetSize();
     }
 
+    if (!nextSegFound)
+    {
+        m_nextSegFrom = beginOfCurrentPkt;
+    }
+
     /* (2) If no sequence number 'S2' per rule (1) exists but there
      *     exists available unsent data and the receiver's advertised
      *     window allows, the sequence range of one segment of up to SMSS
@@ -1205,6 +1320,7 @@ TcpTxBuffer::ResetRenoSack()
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
     m_sackSeen = false;
+    ResetScanHints();
 }
 
 void
@@ -1228,6 +1344,7 @@ TcpTxBuffer::ResetSentList()
         m_appList.push_front(item);
         m_sentList.pop_back();
     }
+    m_sentIndex.clear();
 
     m_sentSize = 0;
     m_lostOut = 0;
@@ -1235,6 +1352,7 @@ TcpTxBuffer::ResetSentList()
     m_sackedOut = 0;
     m_sackSeen = false;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetScanHints();
 }
 
 void
@@ -1246,12 +1364,14 @@ TcpTxBuffer::ResetLastSegmentSent()
         TcpTxItem* item = m_sentList.back();
 
         m_sentList.pop_back();
+        m_sentIndex.erase(item->m_startSeq);
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
         {
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+        ResetScanHints();
     }
     ConsistencyCheck();
 }
@@ -1298,6 +1418,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
 
         (*it)->m_retrans = false;
     }
+    ResetScanHints();
 
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
@@ -1331,6 +1452,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        ResetScanHints();
     }
     ConsistencyCheck();
 }
@@ -1360,6 +1482,7 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        ResetScanHints();
     }
     ConsistencyCheck();
 }
@@ -1421,8 +1544,13 @@ TcpTxBuffer::ConsistencyCheck() const
     uint32_t lost = 0;
     uint32_t retrans = 0;
 
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size(),
+                  "Indexed items: " << m_sentIndex.size() << " sent items: " << m_sentList.size());
     for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
     {
+        auto indexed = m_sentIndex.find((*it)->m_startSeq);
+        NS_ASSERT_MSG(indexed != m_sentIndex.end() && indexed->second == it,
+                      "Item " << *(*it) << " is not indexed");
         if ((*it)->m_sacked)
         {
             sacked += (*it)->m_packet->GetSize();
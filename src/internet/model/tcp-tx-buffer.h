@@ -18,6 +18,9 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <list>
+#include <map>
+
 namespace ns3
 {
 class Packet;
@@ -64,6 +67,13 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * The items of the sent list are also indexed by their starting sequence
+ * number, so the SACK blocks, the lost and retransmitted segments are found
+ * in logarithmic time instead of walking the list from its head. Moreover,
+ * the buffer remembers the highest sequence up to which all the segments are
+ * sacked or lost, and the lowest one which may be retransmitted, so the scans
+ * of UpdateLostCount and NextSeg do not start again from the head each time.
+ *
  * Item properties
  * ---------------
  *
@@ -402,6 +412,8 @@ class TcpTxBuffer : public Object
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
     typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    /// Index of the sent list: starting sequence of each item, position of the item
+    typedef std::map<SequenceNumber32, PacketList::iterator> SentIndex;
 
     /**
      * @brief Update the lost count
@@ -418,8 +430,8 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. The walk stops at m_lostUpTo, below which
+     * all the segments are already sacked or lost.
      *
      */
     void UpdateLostCount();
@@ -554,7 +566,7 @@ class TcpTxBuffer : public Object
                                  const SequenceNumber32& startingSeq,
                                  uint32_t numBytes,
                                  const SequenceNumber32& requestedSeq,
-                                 bool* listEdited = nullptr) const;
+                                 bool* listEdited = nullptr);
 
     /**
      * @brief Merge two TcpTxItem
@@ -592,8 +604,25 @@ class TcpTxBuffer : public Object
      */
     std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32> FindHighestSacked() const;
 
+    /**
+     * @brief Find the item of the sent list which contains a sequence
+     * @param seq the sequence
+     * @return the position of the item in m_sentIndex, or its end if no item contains seq
+     */
+    SentIndex::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
+    /**
+     * @brief Restart the scans of UpdateLostCount and NextSeg from the head
+     *
+     * To be called when the sacked, lost or retransmitted flag of an item is
+     * cleared, as the segments below m_lostUpTo or m_nextSegFrom may then
+     * have to be marked lost or retransmitted again.
+     */
+    void ResetScanHints();
+
     PacketList m_appList;              //!< Buffer for application data
     PacketList m_sentList;             //!< Buffer for sent (but not acked) data
+    SentIndex m_sentIndex;             //!< Items of m_sentList by starting sequence
     uint32_t m_maxBuffer;              //!< Max number of data bytes in buffer (SND.WND)
     uint32_t m_size;                   //!< Size of all data in this buffer
     uint32_t m_sentSize;               //!< Size of sent (and not discarded) segments
@@ -607,6 +636,10 @@ class TcpTxBuffer : public Object
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
 
+    SequenceNumber32 m_lostUpTo{0};            //!< All the sent segments below are sacked or lost
+    mutable SequenceNumber32 m_nextSegFrom{0}; //!< All the sent segments below are retransmitted
+                                               //!< or sacked
+
     uint32_t m_dupAckThresh{0}; //!< Duplicate Ack threshold from TcpSocketBase
     uint32_t m_segmentSize{0};  //!< Segment size from TcpSocketBase
     bool m_renoSack{false};     //!< Indicates if AddRenoSack was called
@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief Check the endpoints found by the lookups of Ipv4EndPointDemux.
+ */
+class Ipv4EndPointDemuxLookupTest : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxLookupTest();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4EndPointDemuxLookupTest::Ipv4EndPointDemuxLookupTest()
+    : TestCase("Check the lookups of Ipv4EndPointDemux")
+{
+}
+
+void
+Ipv4EndPointDemuxLookupTest::DoRun()
+{
+    Ipv4EndPointDemux demux;
+    auto iface = CreateObject<Ipv4Interface>();
+    iface->AddAddress(Ipv4InterfaceAddress(Ipv4Address("10.1.1.1"), Ipv4Mask("/24")));
+    Ipv4Address local("10.1.1.1");
+    Ipv4Address peer("10.1.1.2");
+
+    Ipv4EndPoint* any = demux.Allocate(nullptr, 9);
+    Ipv4EndPoint* subnet = demux.Allocate(nullptr, Ipv4Address("10.1.1.0"), 10);
+    Ipv4EndPoint* connected = demux.Allocate(nullptr, local, 9, peer, 5000);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, local, 9, peer, 5000),
+                          nullptr,
+                          "The four-tuple is already used");
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, 9), nullptr, "The port is already bound");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(9), true, "Port 9 is used");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(11), false, "Port 11 is not used");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, local, 9), true, "10.1.1.1:9 is bound");
+
+    auto found = demux.Lookup(local, 9, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), connected, "The exact match should be preferred");
+    found = demux.Lookup(local, 9, Ipv4Address("10.1.1.3"), 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), any, "Another peer should reach the wildcard");
+    found = demux.Lookup(Ipv4Address("10.1.1.255"), 10, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), subnet, "The subnet-directed broadcast should match");
+    found = demux.Lookup(Ipv4Address("10.1.2.255"), 10, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.empty(), true, "Another subnet should not match");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 9, peer, 5000), connected, "Wrong endpoint");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 12, peer, 5000), nullptr, "Wrong endpoint");
+
+    // an endpoint connected after its allocation is found at its new four-tuple
+    Ipv4EndPoint* ephemeral = demux.Allocate();
+    uint16_t port = ephemeral->GetLocalPort();
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, port, peer, 80, iface).front(),
+                          ephemeral,
+                          "The unconnected endpoint should match any packet to its port");
+    ephemeral->SetLocalAddress(local);
+    ephemeral->SetPeer(peer, 80);
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, port, peer, 81, iface).empty(),
+                          true,
+                          "The connected endpoint should only match its peer");
+    found = demux.Lookup(local, port, peer, 80, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), ephemeral, "The connected endpoint should match");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, port, peer, 80), ephemeral, "Wrong endpoint");
+
+    connected->SetRxEnabled(false);
+    found = demux.Lookup(local, 9, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), any, "Disabled endpoints should be skipped");
+
+    Ptr<NetDevice> device = CreateObject<SimpleNetDevice>();
+    Ipv4EndPoint* bound = demux.Allocate(device, 11);
+    bound->BindToNetDevice(device);
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, 11, peer, 5000, iface).empty(),
+                          true,
+                          "An endpoint bound to another device should be skipped");
+
+    demux.DeAllocate(connected);
+    demux.DeAllocate(bound);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(11), false, "Port 11 is not used anymore");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetAllEndPoints().size(), 3, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetAllEndPoints().front(), any, "Wrong order of the endpoints");
+}
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief Check the allocation of the ephemeral ports of Ipv4EndPointDemux.
+ */
+class Ipv4EndPointDemuxEphemeralTest : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxEphemeralTest();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4EndPointDemuxEphemeralTest::Ipv4EndPointDemuxEphemeralTest()
+    : TestCase("Check the ephemeral ports of Ipv4EndPointDemux")
+{
+}
+
+void
+Ipv4EndPointDemuxEphemeralTest::DoRun()
+{
+    Ipv4EndPointDemux demux;
+    Ipv4EndPoint* first = demux.Allocate();
+    NS_TEST_ASSERT_MSG_EQ(first->GetLocalPort(), 49153, "Wrong first ephemeral port");
+    demux.Allocate(nullptr, 49154);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate()->GetLocalPort(), 49155, "A used port is skipped");
+    demux.DeAllocate(first);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate()->GetLocalPort(),
+                          49156,
+                          "The ports are allocated in increasing order");
+
+    // use all the ports, wrapping around the range
+    std::map<uint16_t, Ipv4EndPoint*> endPoints;
+    while (Ipv4EndPoint* endPoint = demux.Allocate())
+    {
+        NS_TEST_ASSERT_MSG_EQ(endPoints.contains(endPoint->GetLocalPort()),
+                              false,
+                              "Port allocated twice");
+        endPoints[endPoint->GetLocalPort()] = endPoint;
+    }
+    NS_TEST_ASSERT_MSG_EQ(endPoints.size(), 16384 - 3, "All the free ports should be allocated");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.begin()->first, 49152, "Wrong first port");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.rbegin()->first, 65535, "Wrong last port");
+
+    demux.DeAllocate(endPoints[50000]);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate()->GetLocalPort(), 50000, "The freed port is reused");
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(), nullptr, "No port is free");
+}
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief Check the lookups and the ephemeral ports of Ipv6EndPointDemux.
+ */
+class Ipv6EndPointDemuxTest : public TestCase
+{
+  public:
+    Ipv6EndPointDemuxTest();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6EndPointDemuxTest::Ipv6EndPointDemuxTest()
+    : TestCase("Check the lookups and the ephemeral ports of Ipv6EndPointDemux")
+{
+}
+
+void
+Ipv6EndPointDemuxTest::DoRun()
+{
+    Ipv6EndPointDemux demux;
+    Ipv6Address local("2001:db8::1");
+    Ipv6Address peer("2001:db8::2");
+
+    Ipv6EndPoint* any = demux.Allocate(nullptr, 9);
+    Ipv6EndPoint* exact = demux.Allocate(nullptr, local, 9);
+    Ipv6EndPoint* connected = demux.Allocate(nullptr, local, 9, peer, 5000);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, local, 9, peer, 5000),
+                          nullptr,
+                          "The four-tuple is already used");
+
+    auto found = demux.Lookup(local, 9, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), connected, "The exact match should be preferred");
+    found = demux.Lookup(local, 9, peer, 5001, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), exact, "The local address should be preferred");
+    found = demux.Lookup(Ipv6Address("2001:db8::3"), 9, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), any, "Another address should reach the wildcard");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 9, peer, 5000), connected, "Wrong endpoint");
+
+    Ipv6EndPoint* ephemeral = demux.Allocate();
+    NS_TEST_ASSERT_MSG_EQ(ephemeral->GetLocalPort(), 49153, "Wrong first ephemeral port");
+    ephemeral->SetLocalAddress(local);
+    ephemeral->SetPeer(peer, 80);
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, 49153, peer, 80, nullptr).front(),
+                          ephemeral,
+                          "The connected endpoint should match");
+
+    // the endpoint moves to its new port, which is not free anymore
+    ephemeral->SetLocalPort(49154);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(49153), false, "Port 49153 is not used anymore");
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, 49154, peer, 80, nullptr).front(),
+                          ephemeral,
+                          "The endpoint should match at its new port");
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate()->GetLocalPort(), 49155, "A used port is skipped");
+
+    demux.DeAllocate(connected);
+    found = demux.Lookup(local, 9, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints");
+    NS_TEST_ASSERT_MSG_EQ(found.front(), exact, "The deallocated endpoint should not match");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetEndPoints().size(), 4, "Wrong number of endpoints");
+}
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief EndPointDemux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite()
+    : TestSuite("end-point-demux", Type::UNIT)
+{
+    AddTestCase(new Ipv4EndPointDemuxLookupTest(), TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4EndPointDemuxEphemeralTest(), TestCase::Duration::QUICK);
+    AddTestCase(new Ipv6EndPointDemuxTest(), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -8,6 +8,8 @@
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -31,6 +33,28 @@ class TcpRxBufferTestCase : public TestCase
      * @brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * @brief Test the reassembly of segments received out of order, and the
+     * data extracted.
+     */
+    void TestReassembly();
+
+    /**
+     * @brief Create a packet whose bytes depend on their sequence number
+     * @param seq the sequence number of the first byte
+     * @param size the size of the packet
+     * @return the packet
+     */
+    Ptr<Packet> CreateSegment(SequenceNumber32 seq, uint32_t size) const;
+
+    /**
+     * @brief Check that the bytes of a packet depend on their sequence number
+     * @param p the packet
+     * @param seq the sequence number of the first byte
+     * @param size the expected size of the packet
+     */
+    void CheckPayload(Ptr<const Packet> p, SequenceNumber32 seq, uint32_t size);
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -42,6 +66,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReassembly();
 }
 
 void
@@ -277,6 +302,101 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+Ptr<Packet>
+TcpRxBufferTestCase::CreateSegment(SequenceNumber32 seq, uint32_t size) const
+{
+    std::vector<uint8_t> payload(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        payload[i] = (seq.GetValue() + i) % 251;
+    }
+    return Create<Packet>(payload.data(), size);
+}
+
+void
+TcpRxBufferTestCase::CheckPayload(Ptr<const Packet> p, SequenceNumber32 seq, uint32_t size)
+{
+    NS_TEST_ASSERT_MSG_NE(p, nullptr, "No data extracted");
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), size, "Wrong size of the extracted data");
+    std::vector<uint8_t> payload(size);
+    p->CopyData(payload.data(), size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(payload[i]),
+                              (seq.GetValue() + i) % 251,
+                              "Wrong byte at sequence " << seq + i);
+    }
+}
+
+void
+TcpRxBufferTestCase::TestReassembly()
+{
+    TcpRxBuffer rxBuf;
+    TcpOptionSack::SackList sackList;
+    TcpHeader h;
+    SequenceNumber32 head(1);
+    rxBuf.SetNextRxSequence(head);
+    rxBuf.SetMaxBufferSize(10000);
+
+    // One segment out of two is received, starting from the second one
+    for (uint32_t i = 1; i < 12; i += 2)
+    {
+        h.SetSequenceNumber(head + (100 * i));
+        rxBuf.Add(CreateSegment(head + (100 * i), 100), h);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(), head, "Sequence number differs from expected");
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four elements");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().first,
+                          SequenceNumber32(1101),
+                          "SACK block different than expected");
+
+    // Filling a hole between two blocks, one of which is no longer in the SACK
+    // list, reports the whole contiguous block first
+    h.SetSequenceNumber(head + 200);
+    rxBuf.Add(CreateSegment(head + 200, 100), h);
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four elements");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().first,
+                          SequenceNumber32(101),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().second,
+                          SequenceNumber32(401),
+                          "SACK block different than expected");
+
+    // Filling the first hole makes the whole block available
+    h.SetSequenceNumber(head);
+    rxBuf.Add(CreateSegment(head, 100), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(401),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 400, "Wrong available data");
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 3, "SACK list should contain three elements");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().first,
+                          SequenceNumber32(1101),
+                          "SACK block different than expected");
+
+    CheckPayload(rxBuf.Extract(50), head, 50);
+    CheckPayload(rxBuf.Extract(1000), head + 50, 350);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "Wrong available data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 400, "Wrong size of the buffered data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(100), nullptr, "No data should be available");
+
+    // A segment covering all the remaining holes, and overlapping the
+    // segments received out of order
+    h.SetSequenceNumber(head + 400);
+    rxBuf.Add(CreateSegment(head + 400, 800), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1201),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 800, "Wrong available data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+
+    CheckPayload(rxBuf.Extract(800), head + 400, 800);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Data inside the buffer");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
@@ -42,6 +42,8 @@ class TcpTxBufferTestCase : public TestCase
     /** @brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** @brief Test the scoreboard of a large window with many holes */
+    void TestLargeScoreboard();
     /**
      * @brief Callback to provide a value of receiver window
      * @returns the receiver window size
@@ -89,6 +91,13 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for a large window:
+     *  -> one segment out of two is sacked, the holes are lost or retransmitted
+     *  -> the lookups start from the middle of the sent list
+     */
+    Simulator::Schedule(Seconds(0), &TcpTxBufferTestCase::TestLargeScoreboard, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -409,6 +418,91 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeScoreboard()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    SequenceNumber32 head(1);
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+    uint32_t segmentSize = 100;
+    uint32_t segments = 1000;
+    txBuf->SetHeadSequence(head);
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetMaxBufferSize(segmentSize * segments);
+    txBuf->Add(Create<Packet>(segmentSize * segments));
+
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        txBuf->CopyFromSequence(segmentSize, head + (segmentSize * i));
+    }
+
+    // The receiver gets one segment out of two, starting from the second one
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    for (uint32_t i = 1; i < segments; i += 2)
+    {
+        sack->AddSackBlock(TcpOptionSack::SackBlock(head + (segmentSize * i),
+                                                    head + (segmentSize * (i + 1))));
+        txBuf->Update(sack->GetSackList());
+        sack->ClearSackList();
+    }
+
+    // A hole is lost when there are at least three sacked segments above it,
+    // so all of them but the last two
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), segmentSize * 500, "Wrong sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), segmentSize * 498, "Wrong lost bytes");
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * i) + 50),
+                              (i % 2 == 0 && i < segments - 5),
+                              "Wrong lost flag for segment " << i);
+    }
+
+    // The lost holes are retransmitted first, then the other holes (rule 3)
+    for (uint32_t i = 0; i < segments; i += 2)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                              true,
+                              "No NextSeq for segment " << i);
+        NS_TEST_ASSERT_MSG_EQ(ret, head + (segmentSize * i), "Wrong NextSeq");
+        txBuf->CopyFromSequence(segmentSize, ret);
+    }
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          false,
+                          "All the holes are retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(),
+                          segmentSize * 500,
+                          "Wrong retransmitted bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + segmentSize),
+                          true,
+                          "The first segment is retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + (segmentSize * 2)),
+                          false,
+                          "The second segment is sacked");
+
+    // Acknowledge the first half and a piece of the next hole
+    head = head + (segmentSize * 500) + 50;
+    txBuf->DiscardUpTo(head);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), segmentSize * 250, "Wrong sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), segmentSize * 248 - 50, "Wrong lost bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(),
+                          segmentSize * 250 - 50,
+                          "Wrong retransmitted bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head), true, "The head is lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + 50), false, "The segment is sacked");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + 50),
+                          true,
+                          "The head is retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          false,
+                          "All the holes are retransmitted");
+
+    txBuf->DiscardUpTo(SequenceNumber32(1) + (segmentSize * segments));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Data inside the buffer");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
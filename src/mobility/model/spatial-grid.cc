@@ -0,0 +1,206 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "spatial-grid.h"
+
+#include "mobility-model.h"
+
+#include "ns3/assert.h"
+#include "ns3/callback.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpatialGrid");
+
+SpatialGrid::SpatialGrid(double cellSize)
+    : m_cellSize(cellSize)
+{
+    NS_LOG_FUNCTION(this << cellSize);
+    NS_ASSERT_MSG(cellSize > 0, "The cells of a SpatialGrid must have a positive size");
+}
+
+SpatialGrid::~SpatialGrid()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+void
+SpatialGrid::Reset(double cellSize)
+{
+    NS_LOG_FUNCTION(this << cellSize);
+    NS_ASSERT_MSG(cellSize > 0, "The cells of a SpatialGrid must have a positive size");
+    Clear();
+    m_cellSize = cellSize;
+}
+
+void
+SpatialGrid::Add(uint32_t key, Ptr<MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << key << mobility);
+    if (!mobility)
+    {
+        m_unlocated.push_back(key);
+        return;
+    }
+    auto [it, inserted] = m_entries.emplace(key, Entry{mobility, false, Cell{}});
+    NS_ASSERT_MSG(inserted, "Key " << key << " is already in the SpatialGrid");
+    Insert(key, it->second);
+
+    auto& keys = m_keys[PeekPointer(mobility)];
+    if (keys.empty())
+    {
+        mobility->TraceConnectWithoutContext("CourseChange",
+                                             MakeCallback(&SpatialGrid::CourseChanged, this));
+    }
+    keys.push_back(key);
+}
+
+void
+SpatialGrid::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& [key, entry] : m_entries)
+    {
+        auto it = m_keys.find(PeekPointer(entry.mobility));
+        if (it != m_keys.end())
+        {
+            entry.mobility->TraceDisconnectWithoutContext(
+                "CourseChange",
+                MakeCallback(&SpatialGrid::CourseChanged, this));
+            m_keys.erase(it);
+        }
+    }
+    m_entries.clear();
+    m_cells.clear();
+    m_moving.clear();
+    m_unlocated.clear();
+}
+
+std::size_t
+SpatialGrid::GetN() const
+{
+    return m_entries.size() + m_unlocated.size();
+}
+
+SpatialGrid::Cell
+SpatialGrid::GetCell(const Vector& position) const
+{
+    return Cell{static_cast<int64_t>(std::floor(position.x / m_cellSize)),
+                static_cast<int64_t>(std::floor(position.y / m_cellSize)),
+                static_cast<int64_t>(std::floor(position.z / m_cellSize))};
+}
+
+void
+SpatialGrid::Insert(uint32_t key, Entry& entry)
+{
+    entry.moving = (entry.mobility->GetVelocity().GetLength() > 0);
+    if (entry.moving)
+    {
+        m_moving.push_back(key);
+    }
+    else
+    {
+        entry.cell = GetCell(entry.mobility->GetPosition());
+        m_cells[entry.cell].push_back(key);
+    }
+}
+
+void
+SpatialGrid::Erase(uint32_t key, const Entry& entry)
+{
+    if (entry.moving)
+    {
+        m_moving.erase(std::find(m_moving.begin(), m_moving.end(), key));
+        return;
+    }
+    auto cellIt = m_cells.find(entry.cell);
+    NS_ASSERT(cellIt != m_cells.end());
+    auto& keys = cellIt->second;
+    keys.erase(std::find(keys.begin(), keys.end(), key));
+    if (keys.empty())
+    {
+        m_cells.erase(cellIt);
+    }
+}
+
+void
+SpatialGrid::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_keys.find(PeekPointer(mobility));
+    if (it == m_keys.end())
+    {
+        return;
+    }
+    for (auto key : it->second)
+    {
+        auto& entry = m_entries.at(key);
+        Erase(key, entry);
+        Insert(key, entry);
+    }
+}
+
+std::vector<uint32_t>
+SpatialGrid::GetInRange(const Vector& position, double range) const
+{
+    NS_LOG_FUNCTION(this << position << range);
+    std::vector<uint32_t> keys = m_unlocated;
+
+    auto addIfInRange = [&](uint32_t key) {
+        if (CalculateDistance(m_entries.at(key).mobility->GetPosition(), position) <= range)
+        {
+            keys.push_back(key);
+        }
+    };
+
+    for (auto key : m_moving)
+    {
+        addIfInRange(key);
+    }
+
+    const auto [lowX, lowY, lowZ] = GetCell(position - Vector(range, range, range));
+    const auto [highX, highY, highZ] = GetCell(position + Vector(range, range, range));
+    const auto spanned = static_cast<double>(highX - lowX + 1) * (highY - lowY + 1) *
+                         (highZ - lowZ + 1);
+    if (spanned > m_cells.size())
+    {
+        // the range covers more cells than there are occupied ones
+        for (const auto& [cell, cellKeys] : m_cells)
+        {
+            const auto [x, y, z] = cell;
+            if (x >= lowX && x <= highX && y >= lowY && y <= highY && z >= lowZ && z <= highZ)
+            {
+                std::for_each(cellKeys.begin(), cellKeys.end(), addIfInRange);
+            }
+        }
+    }
+    else
+    {
+        for (auto x = lowX; x <= highX; ++x)
+        {
+            for (auto y = lowY; y <= highY; ++y)
+            {
+                for (auto z = lowZ; z <= highZ; ++z)
+                {
+                    auto cellIt = m_cells.find(Cell{x, y, z});
+                    if (cellIt != m_cells.end())
+                    {
+                        std::for_each(cellIt->second.begin(), cellIt->second.end(), addIfInRange);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace ns3
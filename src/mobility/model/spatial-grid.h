@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "ns3/mobility-export.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace ns3
+{
+
+class MobilityModel;
+
+/**
+ * @ingroup mobility
+ * @brief Index of the positions of a set of mobility models, to find the
+ * ones close to a point without visiting all of them.
+ *
+ * Each entry is a key chosen by the user and the MobilityModel of the
+ * object it stands for; several keys may share a MobilityModel.  The grid
+ * splits the space in cubic cells and keeps every entry whose velocity is
+ * null in the cell of its position.  Entries which move, and entries
+ * without a MobilityModel, are kept aside and checked at every query.
+ *
+ * The grid follows the CourseChange trace source of the mobility models,
+ * so it relies on the contract of that trace: an object whose velocity is
+ * null does not move until it notifies a course change.
+ *
+ * Channels use the grid to skip the receivers out of range of a
+ * transmitter.  The keys are returned in increasing order, so a channel
+ * which numbers its receivers in the order of its receiver list visits
+ * the receivers in range in the same order as a scan of the whole list.
+ */
+class MOBILITY_EXPORT SpatialGrid
+{
+  public:
+    /**
+     * Create an empty grid.
+     *
+     * @param cellSize the length of the side of the cells, in meters
+     */
+    SpatialGrid(double cellSize = 1000);
+    ~SpatialGrid();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    SpatialGrid(const SpatialGrid&) = delete;
+    SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+    /**
+     * Remove all the entries and set the length of the side of the cells.
+     *
+     * @param cellSize the length of the side of the cells, in meters
+     */
+    void Reset(double cellSize);
+
+    /**
+     * Add an entry.
+     *
+     * @param key the key of the entry, unique in the grid
+     * @param mobility the MobilityModel of the entry, or nullptr if it has none
+     */
+    void Add(uint32_t key, Ptr<MobilityModel> mobility);
+
+    /**
+     * Remove all the entries.
+     */
+    void Clear();
+
+    /**
+     * @return the number of entries
+     */
+    std::size_t GetN() const;
+
+    /**
+     * Get the entries within a distance of a point.  The entries without a
+     * MobilityModel are always returned, since their distance is unknown.
+     *
+     * @param position the point
+     * @param range the distance, in meters
+     * @return the keys of the entries, in increasing order
+     */
+    std::vector<uint32_t> GetInRange(const Vector& position, double range) const;
+
+  private:
+    /// Coordinates of a cell
+    using Cell = std::tuple<int64_t, int64_t, int64_t>;
+
+    /// An entry of the grid
+    struct Entry
+    {
+        Ptr<MobilityModel> mobility; //!< The MobilityModel of the entry
+        bool moving;                 //!< Whether the entry is in the list of moving entries
+        Cell cell;                   //!< The cell of the entry, if it is at rest
+    };
+
+    /**
+     * @param position a position
+     * @return the cell which contains the position
+     */
+    Cell GetCell(const Vector& position) const;
+
+    /**
+     * Put an entry in its cell or in the list of moving entries.
+     *
+     * @param key the key of the entry
+     * @param entry the entry
+     */
+    void Insert(uint32_t key, Entry& entry);
+
+    /**
+     * Remove an entry from its cell or from the list of moving entries.
+     *
+     * @param key the key of the entry
+     * @param entry the entry
+     */
+    void Erase(uint32_t key, const Entry& entry);
+
+    /**
+     * Move the entries of a MobilityModel after a course change.
+     *
+     * @param mobility the MobilityModel
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    double m_cellSize;                             //!< Side of the cells, in meters
+    std::map<uint32_t, Entry> m_entries;           //!< Entries with a MobilityModel, by key
+    std::map<Cell, std::vector<uint32_t>> m_cells; //!< Keys of the entries at rest, by cell
+    std::vector<uint32_t> m_moving;                //!< Keys of the entries which move
+    std::vector<uint32_t> m_unlocated;             //!< Keys of the entries without a MobilityModel
+
+    /// Keys of the entries of each MobilityModel
+    std::map<const MobilityModel*, std::vector<uint32_t>> m_keys;
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_H */
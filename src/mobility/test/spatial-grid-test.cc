@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/spatial-grid.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup mobility-test
+ *
+ * @brief Check that SpatialGrid returns the same entries as a scan of all
+ * the positions, also after course changes and with moving entries.
+ */
+class SpatialGridTestCase : public TestCase
+{
+  public:
+    SpatialGridTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compare the entries returned by the grid with a scan of all the
+     * mobility models.
+     *
+     * @param position the point of the query
+     * @param range the range of the query
+     */
+    void CheckQuery(Vector position, double range);
+
+    SpatialGrid m_grid;                           //!< The grid under test
+    std::vector<Ptr<MobilityModel>> m_mobilities; //!< The MobilityModel of each key
+};
+
+SpatialGridTestCase::SpatialGridTestCase()
+    : TestCase("Check SpatialGrid queries against a scan of all the positions"),
+      m_grid(100)
+{
+}
+
+void
+SpatialGridTestCase::CheckQuery(Vector position, double range)
+{
+    std::vector<uint32_t> expected;
+    for (uint32_t key = 0; key < m_mobilities.size(); ++key)
+    {
+        if (!m_mobilities[key] ||
+            CalculateDistance(m_mobilities[key]->GetPosition(), position) <= range)
+        {
+            expected.push_back(key);
+        }
+    }
+    std::vector<uint32_t> found = m_grid.GetInRange(position, range);
+    NS_TEST_ASSERT_MSG_EQ(found.size(),
+                          expected.size(),
+                          "Wrong number of entries in range " << range << " of " << position
+                                                              << " at "
+                                                              << Simulator::Now().As(Time::S));
+    for (std::size_t i = 0; i < found.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(found[i], expected[i], "Wrong entry in range " << range);
+    }
+}
+
+void
+SpatialGridTestCase::DoRun()
+{
+    // a lattice of nodes at rest, with negative coordinates too
+    for (int i = 0; i < 20; ++i)
+    {
+        for (int j = 0; j < 10; ++j)
+        {
+            auto mobility = CreateObject<ConstantPositionMobilityModel>();
+            mobility->SetPosition(Vector(-500 + i * 53.0, -200 + j * 47.0, (i + j) % 3));
+            m_mobilities.push_back(mobility);
+        }
+    }
+    // a key without a MobilityModel and a key which shares a MobilityModel
+    m_mobilities.push_back(nullptr);
+    m_mobilities.push_back(m_mobilities[17]);
+    // a node which moves at 10 m/s along x
+    auto moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetPosition(Vector(-300, 0, 0));
+    moving->SetVelocity(Vector(10, 0, 0));
+    m_mobilities.push_back(moving);
+
+    for (uint32_t key = 0; key < m_mobilities.size(); ++key)
+    {
+        m_grid.Add(key, m_mobilities[key]);
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_grid.GetN(), m_mobilities.size(), "Wrong number of entries");
+
+    for (double range : {0.0, 30.0, 99.0, 100.0, 250.0, 5000.0})
+    {
+        CheckQuery(Vector(0, 0, 0), range);
+        CheckQuery(Vector(-480, -190, 1), range);
+        CheckQuery(Vector(333.3, 111.1, 0), range);
+    }
+
+    // move a node at rest, and the shared MobilityModel, far away
+    DynamicCast<ConstantPositionMobilityModel>(m_mobilities[5])->SetPosition(Vector(900, 900, 0));
+    DynamicCast<ConstantPositionMobilityModel>(m_mobilities[17])->SetPosition(Vector(1, 1, 0));
+    CheckQuery(Vector(0, 0, 0), 30);
+    CheckQuery(Vector(900, 900, 0), 10);
+
+    // the moving node is found at its current position, and stops later
+    Simulator::Schedule(Seconds(20), &SpatialGridTestCase::CheckQuery, this, Vector(-100, 0, 0), 5);
+    Simulator::Schedule(Seconds(30), [moving]() { moving->SetVelocity(Vector(0, 0, 0)); });
+    Simulator::Schedule(Seconds(40), &SpatialGridTestCase::CheckQuery, this, Vector(0, 0, 0), 5);
+    Simulator::Schedule(Seconds(40), &SpatialGridTestCase::CheckQuery, this, Vector(-100, 0, 0), 5);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    m_grid.Clear();
+    NS_TEST_ASSERT_MSG_EQ(m_grid.GetN(), 0, "The grid is not empty after Clear");
+    NS_TEST_ASSERT_MSG_EQ(m_grid.GetInRange(Vector(0, 0, 0), 1e6).size(),
+                          0,
+                          "Entries found after Clear");
+}
+
+/**
+ * @ingroup mobility-test
+ *
+ * @brief SpatialGrid TestSuite
+ */
+class SpatialGridTestSuite : public TestSuite
+{
+  public:
+    SpatialGridTestSuite();
+};
+
+SpatialGridTestSuite::SpatialGridTestSuite()
+    : TestSuite("spatial-grid", Type::UNIT)
+{
+    AddTestCase(new SpatialGridTestCase(), TestCase::Duration::QUICK);
+}
+
+static SpatialGridTestSuite g_spatialGridTestSuite; //!< Static variable for test initialization
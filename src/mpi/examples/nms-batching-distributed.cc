@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mpi
+ *
+ * Check that NullMessageSimulatorImpl batches the packets sent to a
+ * remote rank.
+ *
+ * Two nodes, one on rank 0 and one on rank 1, share a point-to-point
+ * link with a delay of 1 ms.  Node 0 sends a stream of small packets to
+ * node 1, one every 20 us.  The simulation runs twice in the same MPI
+ * environment: first with MaxBatchDelay 0, so that nearly every packet
+ * travels in its own MPI message, then with MaxBatchDelay 500 us.
+ *
+ * The second run must deliver all the packets too, send more than one
+ * packet per data message, fewer Null Messages, and fewer MPI messages,
+ * data and null ones together, per packet than the first run.  The ratio
+ * of Null Messages to data messages rises instead, since the data
+ * messages drop much faster than the Null Messages.
+ *
+ *                 -------   -------
+ *                  RANK 0    RANK 1
+ *                 ------- | -------
+ *                         |
+ *              n0 --------|-------- n1
+ */
+
+#include "mpi-test-fixtures.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/network-module.h"
+#include "ns3/null-message-simulator-impl.h"
+#include "ns3/point-to-point-helper.h"
+
+#include <mpi.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("NmsBatchingDistributed");
+
+namespace
+{
+
+/** Number of packets sent by node 0 in each run. */
+const uint32_t PACKET_COUNT = 1000;
+
+/** Packets received by node 1 in the current run. */
+uint64_t g_received = 0;
+
+/**
+ * Count a packet received by node 1.
+ *
+ * @copydetails ns3::Node::ProtocolHandler
+ */
+void
+Receive(Ptr<NetDevice> device,
+        Ptr<const Packet> packet,
+        uint16_t protocol,
+        const Address& from,
+        const Address& to,
+        NetDevice::PacketType packetType)
+{
+    g_received++;
+}
+
+/**
+ * Send one packet over a device.
+ *
+ * @param [in] device The device of node 0.
+ */
+void
+Send(Ptr<NetDevice> device)
+{
+    // The PPP header only maps the IP protocol numbers
+    device->Send(Create<Packet>(100), device->GetBroadcast(), 0x0800);
+}
+
+/** Message counters of a run, summed over the ranks. */
+struct Counters
+{
+    uint64_t received;     //!< Packets received by node 1.
+    uint64_t packets;      //!< Packets sent through MPI.
+    uint64_t dataMessages; //!< MPI messages sent with packets.
+    uint64_t nullMessages; //!< MPI messages sent without packets.
+};
+
+/**
+ * Run the simulation once.
+ *
+ * @param [in] maxBatchDelay The MaxBatchDelay attribute of the simulator.
+ * @return The counters of the run, valid on rank 0.
+ */
+Counters
+RunOnce(Time maxBatchDelay)
+{
+    Config::SetDefault("ns3::NullMessageSimulatorImpl::MaxBatchDelay", TimeValue(maxBatchDelay));
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::NullMessageSimulatorImpl"));
+    MpiInterface::Enable(MPI_COMM_WORLD);
+
+    NodeContainer nodes;
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(1));
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("1ms"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    g_received = 0;
+    nodes.Get(1)->RegisterProtocolHandler(MakeCallback(&Receive), 0x0800, devices.Get(1));
+    if (MpiInterface::GetSystemId() == 0)
+    {
+        for (uint32_t i = 0; i < PACKET_COUNT; ++i)
+        {
+            Simulator::ScheduleWithContext(0,
+                                           MicroSeconds(100 + 20 * i),
+                                           &Send,
+                                           devices.Get(0));
+        }
+    }
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    NullMessageSimulatorImpl::Statistics stats =
+        NullMessageSimulatorImpl::GetInstance()->GetStatistics();
+    uint64_t local[4] = {g_received,
+                         stats.packetsSent,
+                         stats.dataMessagesSent,
+                         stats.nullMessagesSent};
+    uint64_t global[4];
+    MPI_Reduce(local, global, 4, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    Simulator::Destroy();
+    MpiInterface::Disable();
+    return {global[0], global[1], global[2], global[3]};
+}
+
+/**
+ * Print the outcome of a check from rank 0.
+ *
+ * @param [in] what The property checked.
+ * @param [in] ok Whether it holds.
+ */
+void
+Check(const std::string& what, bool ok)
+{
+    RANK0COUT(what << ": " << (ok ? "PASSED" : "FAILED") << "\n");
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    bool verbose = false;
+    bool testing = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("verbose", "Log the message counters of every rank", verbose);
+    cmd.AddValue("test", "Enable regression test output", testing);
+    cmd.Parse(argc, argv);
+
+    // MPI outlives both runs, so that the simulator can be enabled twice
+    MPI_Init(&argc, &argv);
+    SinkTracer::Init();
+
+    if (SinkTracer::GetWorldSize() != 2)
+    {
+        RANK0COUT("This simulation requires exactly 2 logical processors." << std::endl);
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (verbose)
+    {
+        LogComponentEnable("NullMessageSimulatorImpl", LOG_LEVEL_INFO);
+    }
+
+    Counters unbatched = RunOnce(Seconds(0));
+    Counters batched = RunOnce(MicroSeconds(500));
+
+    RANK0COUT(cmd.GetName() << "\n");
+    if (!testing)
+    {
+        RANK0COUT("MaxBatchDelay 0:      " << unbatched.packets << " packets, "
+                                            << unbatched.dataMessages << " data messages, "
+                                            << unbatched.nullMessages << " null messages\n");
+        RANK0COUT("MaxBatchDelay 500 us: " << batched.packets << " packets, "
+                                            << batched.dataMessages << " data messages, "
+                                            << batched.nullMessages << " null messages\n");
+    }
+    Check("All packets received without batching", unbatched.received == PACKET_COUNT);
+    Check("All packets received with batching", batched.received == PACKET_COUNT);
+    Check("Several packets per data message", batched.packets > batched.dataMessages);
+    Check("Fewer null messages with batching", batched.nullMessages < unbatched.nullMessages);
+    Check("Fewer messages per packet with batching",
+          (batched.dataMessages + batched.nullMessages) * unbatched.packets <
+              (unbatched.dataMessages + unbatched.nullMessages) * batched.packets);
+
+    MPI_Finalize();
+    return 0;
+}
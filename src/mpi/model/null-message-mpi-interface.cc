@@ -27,10 +27,12 @@
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <mpi.h>
+#include <vector>
 
 namespace ns3
 {
@@ -78,10 +80,70 @@ class NullMessageSentBuffer
 };
 
 /**
- * maximum MPI message size for easy
- * buffer creation
+ * @ingroup mpi
+ *
+ * @brief Packets waiting to be sent to a remote task in one MPI message.
+ *
+ * The message starts with the guarantee time and the number of packets,
+ * followed for every packet by its receive time, destination node and
+ * device, serialized size and serialization.
+ */
+class NullMessageBatch
+{
+  public:
+    NullMessageBatch();
+
+    /** The message, with room for the header at the start. */
+    std::vector<uint8_t> m_data;
+    /** Number of packets in the message. */
+    uint32_t m_packets;
+    /** Time at which the first packet was queued. */
+    Time m_first;
+};
+
+/** Size of the header of a batch: guarantee time and packet count. */
+const uint32_t NULL_MESSAGE_BATCH_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+/** Size of the header of a packet in a batch: time, node, device and size. */
+const uint32_t NULL_MESSAGE_PACKET_HEADER_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+NullMessageBatch::NullMessageBatch()
+    : m_data(NULL_MESSAGE_BATCH_HEADER_SIZE),
+      m_packets(0)
+{
+}
+
+/**
+ * Write a value at a position of an MPI message.
+ *
+ * @tparam T The type of the value.
+ * @param [in,out] buffer The position, advanced past the value.
+ * @param [in] value The value.
+ */
+template <typename T>
+static void
+WriteValue(uint8_t*& buffer, T value)
+{
+    std::memcpy(buffer, &value, sizeof(T));
+    buffer += sizeof(T);
+}
+
+/**
+ * Read a value at a position of an MPI message.
+ *
+ * @tparam T The type of the value.
+ * @param [in,out] buffer The position, advanced past the value.
+ * @return The value.
  */
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
+template <typename T>
+static T
+ReadValue(const uint8_t*& buffer)
+{
+    T value;
+    std::memcpy(&value, buffer, sizeof(T));
+    buffer += sizeof(T);
+    return value;
+}
 
 NullMessageSentBuffer::NullMessageSentBuffer()
 {
@@ -119,6 +181,9 @@ bool NullMessageMpiInterface::g_enabled = false;
 bool NullMessageMpiInterface::g_mpiInitCalled = false;
 
 std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
+uint32_t NullMessageMpiInterface::g_maxMessageSize = 0;
+std::unordered_map<uint32_t, NullMessageBatch> NullMessageMpiInterface::g_batches;
+Time NullMessageMpiInterface::g_oldestBatch = Time::Max();
 
 MPI_Comm NullMessageMpiInterface::g_communicator = MPI_COMM_WORLD;
 bool NullMessageMpiInterface::g_freeCommunicator = false;
@@ -217,12 +282,23 @@ NullMessageMpiInterface::Enable(MPI_Comm communicator)
 }
 
 void
-NullMessageMpiInterface::InitializeSendReceiveBuffers()
+NullMessageMpiInterface::InitializeSendReceiveBuffers(uint32_t maxMessageSize)
 {
-    NS_LOG_FUNCTION_NOARGS();
+    NS_LOG_FUNCTION(maxMessageSize);
     NS_ASSERT(g_enabled);
 
+    // A rank receives into buffers of its own MaxBatchSize, so every rank
+    // must use the same size
+    uint32_t minMessageSize;
+    uint32_t maxMessageSizeAll;
+    MPI_Allreduce(&maxMessageSize, &minMessageSize, 1, MPI_UINT32_T, MPI_MIN, g_communicator);
+    MPI_Allreduce(&maxMessageSize, &maxMessageSizeAll, 1, MPI_UINT32_T, MPI_MAX, g_communicator);
+    NS_ABORT_MSG_IF(minMessageSize != maxMessageSizeAll,
+                    "ns3::NullMessageSimulatorImpl::MaxBatchSize differs between ranks ("
+                        << minMessageSize << " to " << maxMessageSizeAll << ")");
+
     g_numNeighbors = RemoteChannelBundleManager::Size();
+    g_maxMessageSize = maxMessageSize;
 
     // Post a non-blocking receive for all peers
     g_requests = new MPI_Request[g_numNeighbors];
@@ -233,9 +309,9 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers()
         Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
         if (bundle)
         {
-            g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
+            g_pRxBuffers[index] = new char[g_maxMessageSize];
             MPI_Irecv(g_pRxBuffers[index],
-                      NULL_MESSAGE_MAX_MPI_MSG_SIZE,
+                      g_maxMessageSize,
                       MPI_CHAR,
                       rank,
                       0,
@@ -256,39 +332,103 @@ NullMessageMpiInterface::SendPacket(Ptr<Packet> p, const Time& rxTime, uint32_t
     // Find the system id for the destination node
     Ptr<Node> destNode = NodeList::GetNode(node);
     uint32_t nodeSysId = destNode->GetSystemId();
+    Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(nodeSysId);
+    NS_ASSERT(bundle);
+
+    uint32_t serializedSize = p->GetSerializedSize();
+    uint32_t recordSize = NULL_MESSAGE_PACKET_HEADER_SIZE + serializedSize;
+    NS_ABORT_MSG_IF(NULL_MESSAGE_BATCH_HEADER_SIZE + recordSize > g_maxMessageSize,
+                    "Packet of " << serializedSize
+                                 << " serialized bytes does not fit in an MPI message;"
+                                    " increase ns3::NullMessageSimulatorImpl::MaxBatchSize");
+
+    NullMessageBatch& batch = g_batches[nodeSysId];
+    if (batch.m_data.size() + recordSize > g_maxMessageSize)
+    {
+        FlushBatch(bundle);
+    }
+    if (batch.m_packets == 0)
+    {
+        batch.m_first = Simulator::Now();
+        g_oldestBatch = Min(g_oldestBatch, batch.m_first);
+    }
+
+    // Add the time, dest node and dest device, then the packet
+    std::size_t offset = batch.m_data.size();
+    batch.m_data.resize(offset + recordSize);
+    uint8_t* buffer = batch.m_data.data() + offset;
+    WriteValue<uint64_t>(buffer, rxTime.GetInteger());
+    WriteValue<uint32_t>(buffer, node);
+    WriteValue<uint32_t>(buffer, dev);
+    WriteValue<uint32_t>(buffer, serializedSize);
+    p->Serialize(buffer, serializedSize);
+    batch.m_packets++;
+
+    NullMessageSimulatorImpl::GetInstance()->m_statistics.packetsSent++;
+    NullMessageSimulatorImpl::GetInstance()->RescheduleNullMessageEvent(bundle);
+}
+
+bool
+NullMessageMpiInterface::FlushBatch(Ptr<RemoteChannelBundle> bundle, const Time& queuedBefore)
+{
+    NS_LOG_FUNCTION(bundle << queuedBefore.GetTimeStep());
+
+    NS_ASSERT(g_enabled);
+
+    auto it = g_batches.find(bundle->GetSystemId());
+    if (it == g_batches.end() || it->second.m_packets == 0 || it->second.m_first >= queuedBefore)
+    {
+        return false;
+    }
+    NullMessageBatch& batch = it->second;
+
+    // The guarantee covers every packet sent after this batch
+    NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
+    Time guaranteeUpdate = simulator->CalculateGuaranteeTime(bundle->GetSystemId());
+    uint8_t* header = batch.m_data.data();
+    WriteValue<uint64_t>(header, guaranteeUpdate.GetInteger());
+    WriteValue<uint32_t>(header, batch.m_packets);
 
     NullMessageSentBuffer sendBuf;
     g_pendingTx.push_back(sendBuf);
     auto iter = g_pendingTx.rbegin(); // Points to the last element
-
-    uint32_t serializedSize = p->GetSerializedSize();
-    uint32_t bufferSize = serializedSize + (2 * sizeof(uint64_t)) + (2 * sizeof(uint32_t));
-    auto buffer = new uint8_t[bufferSize];
+    auto buffer = new uint8_t[batch.m_data.size()];
+    std::memcpy(buffer, batch.m_data.data(), batch.m_data.size());
     iter->SetBuffer(buffer);
-    // Add the time, dest node and dest device
-    uint64_t t = rxTime.GetInteger();
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = t;
-
-    Time guarantee_update =
-        NullMessageSimulatorImpl::GetInstance()->CalculateGuaranteeTime(nodeSysId);
-    *pTime++ = guarantee_update.GetTimeStep();
-
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = node;
-    *pData++ = dev;
-    // Serialize the packet
-    p->Serialize(reinterpret_cast<uint8_t*>(pData), serializedSize);
 
     MPI_Isend(reinterpret_cast<void*>(iter->GetBuffer()),
-              bufferSize,
+              batch.m_data.size(),
               MPI_CHAR,
-              nodeSysId,
+              bundle->GetSystemId(),
               0,
               g_communicator,
               (iter->GetRequest()));
 
-    NullMessageSimulatorImpl::GetInstance()->RescheduleNullMessageEvent(nodeSysId);
+    bundle->SetLastGuaranteeSent(guaranteeUpdate);
+    simulator->m_statistics.dataMessagesSent++;
+    batch.m_data.resize(NULL_MESSAGE_BATCH_HEADER_SIZE);
+    batch.m_packets = 0;
+    return true;
+}
+
+void
+NullMessageMpiInterface::FlushBatches(const Time& queuedBefore)
+{
+    if (g_oldestBatch >= queuedBefore)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(queuedBefore.GetTimeStep());
+
+    g_oldestBatch = Time::Max();
+    for (auto& [systemId, batch] : g_batches)
+    {
+        if (!FlushBatch(RemoteChannelBundleManager::Find(systemId), queuedBefore) &&
+            batch.m_packets > 0)
+        {
+            g_oldestBatch = Min(g_oldestBatch, batch.m_first);
+        }
+    }
 }
 
 void
@@ -303,16 +443,12 @@ NullMessageMpiInterface::SendNullMessage(const Time& guarantee_update,
     g_pendingTx.push_back(sendBuf);
     auto iter = g_pendingTx.rbegin(); // Points to the last element
 
-    uint32_t bufferSize = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+    uint32_t bufferSize = NULL_MESSAGE_BATCH_HEADER_SIZE;
     auto buffer = new uint8_t[bufferSize];
     iter->SetBuffer(buffer);
-    // Add the time, dest node and dest device
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = 0;
-    *pTime++ = guarantee_update.GetInteger();
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = 0;
-    *pData++ = 0;
+    // Add the guarantee time and no packets
+    WriteValue<uint64_t>(buffer, guarantee_update.GetInteger());
+    WriteValue<uint32_t>(buffer, 0);
 
     // Find the system id for the destination MPI rank
     uint32_t nodeSysId = bundle->GetSystemId();
@@ -324,6 +460,9 @@ NullMessageMpiInterface::SendNullMessage(const Time& guarantee_update,
               0,
               g_communicator,
               (iter->GetRequest()));
+
+    bundle->SetLastGuaranteeSent(guarantee_update);
+    NullMessageSimulatorImpl::GetInstance()->m_statistics.nullMessagesSent++;
 }
 
 void
@@ -378,26 +517,33 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
 
         if (messageReceived)
         {
-            int count;
-            MPI_Get_count(&status, MPI_CHAR, &count);
+            NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
 
             // Get the meta data first
-            auto pTime = reinterpret_cast<uint64_t*>(g_pRxBuffers[index]);
-            uint64_t time = *pTime++;
-            uint64_t guaranteeUpdate = *pTime++;
+            auto pData = reinterpret_cast<const uint8_t*>(g_pRxBuffers[index]);
+            auto guaranteeUpdate = ReadValue<uint64_t>(pData);
+            auto packets = ReadValue<uint32_t>(pData);
 
-            auto pData = reinterpret_cast<uint32_t*>(pTime);
-            uint32_t node = *pData++;
-            uint32_t dev = *pData++;
-
-            Time rxTime(time);
+            // A batch without packets is a Null Message
+            if (packets == 0)
+            {
+                simulator->m_statistics.nullMessagesReceived++;
+            }
+            else
+            {
+                simulator->m_statistics.dataMessagesReceived++;
+                simulator->m_statistics.packetsReceived += packets;
+            }
 
-            // rxtime == 0 means this is a Null Message
-            if (rxTime.IsStrictlyPositive())
+            for (uint32_t k = 0; k < packets; ++k)
             {
-                count -= sizeof(time) + sizeof(guaranteeUpdate) + sizeof(node) + sizeof(dev);
+                Time rxTime(ReadValue<uint64_t>(pData));
+                auto node = ReadValue<uint32_t>(pData);
+                auto dev = ReadValue<uint32_t>(pData);
+                auto size = ReadValue<uint32_t>(pData);
 
-                Ptr<Packet> p = Create<Packet>(reinterpret_cast<uint8_t*>(pData), count, true);
+                Ptr<Packet> p = Create<Packet>(pData, size, true);
+                pData += size;
 
                 // Find the correct node/device to schedule receive event
                 Ptr<Node> pNode = NodeList::GetNode(node);
@@ -427,10 +573,11 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
             NS_ASSERT(bundle);
 
             bundle->SetGuaranteeTime(Time(guaranteeUpdate));
+            simulator->HandleGuaranteeUpdate(bundle);
 
             // Re-queue the next read
             MPI_Irecv(g_pRxBuffers[index],
-                      NULL_MESSAGE_MAX_MPI_MSG_SIZE,
+                      g_maxMessageSize,
                       MPI_CHAR,
                       status.MPI_SOURCE,
                       0,
@@ -494,6 +641,8 @@ NullMessageMpiInterface::Disable()
         delete[] g_requests;
 
         g_pendingTx.clear();
+        g_batches.clear();
+        g_oldestBatch = Time::Max();
 
         if (g_freeCommunicator)
         {
@@ -22,13 +22,16 @@
 
 #include <list>
 #include <mpi.h>
+#include <unordered_map>
 
 namespace ns3
 {
 
 class NullMessageSimulatorImpl;
 class NullMessageSentBuffer;
+class NullMessageBatch;
 class RemoteChannelBundle;
+class RemoteChannelBundleManager;
 class Packet;
 
 /**
@@ -36,6 +39,10 @@ class Packet;
  *
  * @brief Interface between ns-3 and MPI for the Null Message
  * distributed simulation implementation.
+ *
+ * Packets sent to a remote task are queued in a batch per task and sent
+ * in a single MPI message, which also carries the guarantee time of the
+ * sending task.  A Null Message is a batch without packets.
  */
 class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
 {
@@ -68,6 +75,7 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      * It is not intended for state to be shared.
      */
     friend ns3::RemoteChannelBundle;
+    friend ns3::RemoteChannelBundleManager;
     friend ns3::NullMessageSimulatorImpl;
 
     /**
@@ -83,12 +91,29 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      *
      * @param [in] bundle The bundle of links between two ranks.
      *
-     * @internal The Null Message MPI buffer format uses the same packet
-     * metadata format as sending a normal packet with the time,
-     * destination node, and destination device set to zero.  Using the
-     * same packet metadata simplifies receive logic.
+     * @internal The Null Message MPI buffer format is the format of a
+     * batch of packets, with no packets.  Using the same format
+     * simplifies receive logic.
      */
     static void SendNullMessage(const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+    /**
+     * @brief Send the packets queued for the task across a bundle.
+     *
+     * The batch carries the current guarantee time for the bundle.
+     *
+     * @param [in] bundle The bundle of links between two ranks.
+     * @param [in] queuedBefore Send the batch only if its first packet
+     * was queued before this time.
+     * @return Whether a batch was sent.
+     */
+    static bool FlushBatch(Ptr<RemoteChannelBundle> bundle,
+                           const Time& queuedBefore = Time::Max());
+    /**
+     * @brief Send the batches whose first packet was queued before a time.
+     *
+     * @param [in] queuedBefore The time.
+     */
+    static void FlushBatches(const Time& queuedBefore);
     /**
      * Non-blocking check for received messages complete.  Will
      * receive all messages that are queued up locally.
@@ -109,8 +134,10 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      *
      * This method should be called after all links have been added to the RemoteChannelBundle
      * manager to setup any required send and receive buffers.
+     *
+     * @param [in] maxMessageSize The size of the largest MPI message.
      */
-    static void InitializeSendReceiveBuffers();
+    static void InitializeSendReceiveBuffers(uint32_t maxMessageSize);
 
     /**
      * Check for received messages complete.  Will block until message
@@ -150,6 +177,15 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
     /** List of pending non-blocking sends. */
     static std::list<NullMessageSentBuffer> g_pendingTx;
 
+    /** Size of the largest MPI message, and of the receive buffers. */
+    static uint32_t g_maxMessageSize;
+
+    /** Packets waiting to be sent, by remote system id. */
+    static std::unordered_map<uint32_t, NullMessageBatch> g_batches;
+
+    /** Time at which the oldest pending batch was started, or earlier. */
+    static Time g_oldestBatch;
+
     /** MPI communicator being used for ns-3 tasks. */
     static MPI_Comm g_communicator;
 
@@ -29,7 +29,9 @@
 #include "ns3/ptr.h"
 #include "ns3/scheduler.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -56,7 +58,20 @@ NullMessageSimulatorImpl::GetTypeId()
                           "Null Message scheduler tuning parameter",
                           DoubleValue(1.0),
                           MakeDoubleAccessor(&NullMessageSimulatorImpl::m_schedulerTune),
-                          MakeDoubleChecker<double>(0.01, 1.0));
+                          MakeDoubleChecker<double>(0.01, 1.0))
+            .AddAttribute("MaxBatchSize",
+                          "Size of the largest MPI message, which bounds the number of packets "
+                          "sent to a remote task in one message; all the tasks must use the "
+                          "same size",
+                          UintegerValue(65536),
+                          MakeUintegerAccessor(&NullMessageSimulatorImpl::m_maxBatchSize),
+                          MakeUintegerChecker<uint32_t>(2048))
+            .AddAttribute("MaxBatchDelay",
+                          "Longest simulation time for which a packet to a remote task may wait "
+                          "for other packets to be sent in the same MPI message",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NullMessageSimulatorImpl::m_maxBatchDelay),
+                          MakeTimeChecker(Seconds(0)));
     return tid;
 }
 
@@ -77,6 +92,7 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl()
     m_events = nullptr;
 
     m_safeTime = Seconds(0);
+    m_statistics = {};
 
     NS_ASSERT(g_instance == nullptr);
     g_instance = this;
@@ -85,6 +101,7 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl()
 NullMessageSimulatorImpl::~NullMessageSimulatorImpl()
 {
     NS_LOG_FUNCTION(this);
+    g_instance = nullptr;
 }
 
 void
@@ -117,6 +134,18 @@ NullMessageSimulatorImpl::Destroy()
         }
     }
 
+    NS_LOG_INFO("rank " << m_myId << ": " << m_statistics.packetsSent << " packets in "
+                        << m_statistics.dataMessagesSent << " data messages, "
+                        << m_statistics.nullMessagesSent << " null messages ("
+                        << m_statistics.nullMessagesSuppressed << " suppressed), null/data ratio "
+                        << (m_statistics.dataMessagesSent
+                                ? double(m_statistics.nullMessagesSent) /
+                                      m_statistics.dataMessagesSent
+                                : 0)
+                        << "; received " << m_statistics.packetsReceived << " packets in "
+                        << m_statistics.dataMessagesReceived << " data messages, "
+                        << m_statistics.nullMessagesReceived << " null messages");
+
     RemoteChannelBundleManager::Destroy();
     MpiInterface::Destroy();
 }
@@ -187,7 +216,7 @@ NullMessageSimulatorImpl::CalculateLookAhead()
     }
 
     // Completed setup of remote channel bundles.  Setup send and receive buffers.
-    NullMessageMpiInterface::InitializeSendReceiveBuffers();
+    NullMessageMpiInterface::InitializeSendReceiveBuffers(m_maxBatchSize);
 
     // Initialized to 0 as we don't have a simulation start time.
     m_safeTime = Time(0);
@@ -254,7 +283,7 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent(Ptr<RemoteChannelBundle> bund
 {
     NS_LOG_FUNCTION(this << bundle);
 
-    Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
+    Time delay = GetNullMessageInterval(bundle);
 
     bundle->SetEventId(Simulator::Schedule(delay,
                                            &NullMessageSimulatorImpl::NullMessageEventHandler,
@@ -269,7 +298,7 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent(Ptr<RemoteChannelBundle> bu
 
     Simulator::Cancel(bundle->GetEventId());
 
-    Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
+    Time delay = GetNullMessageInterval(bundle);
 
     bundle->SetEventId(Simulator::Schedule(delay,
                                            &NullMessageSimulatorImpl::NullMessageEventHandler,
@@ -303,6 +332,10 @@ NullMessageSimulatorImpl::Run()
     {
         Time nextTime = Next();
 
+        // Send the batches of packets which would otherwise wait past
+        // MaxBatchDelay once the clock advances to the next event
+        NullMessageMpiInterface::FlushBatches(nextTime - m_maxBatchDelay);
+
         if (nextTime <= GetSafeTime())
         {
             ProcessOneEvent();
@@ -310,10 +343,17 @@ NullMessageSimulatorImpl::Run()
         }
         else
         {
-            // Block until packet or Null Message has been received.
+            // Tell every neighbor how far this task has come, then block
+            // until packet or Null Message has been received.
+            RemoteChannelBundleManager::SendGuaranteeUpdates();
             HandleArrivingMessagesBlocking();
         }
     }
+
+    // Send the last batches, and tell the neighbors how far this task got:
+    // a neighbor may still wait for this guarantee to reach the stop time
+    // when the timed Null Messages have backed off
+    RemoteChannelBundleManager::SendGuaranteeUpdates();
 }
 
 void
@@ -551,7 +591,30 @@ NullMessageSimulatorImpl::CalculateGuaranteeTime(uint32_t nodeSysId)
     Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(nodeSysId);
     NS_ASSERT(bundle);
 
-    return Min(NullMessageSimulatorImpl::GetInstance()->Next(), GetSafeTime()) + bundle->GetDelay();
+    Time next = m_events->IsEmpty() ? GetMaximumSimulationTime() : Next();
+    return Min(next, GetSafeTime()) + bundle->GetDelay();
+}
+
+Time
+NullMessageSimulatorImpl::GetNullMessageInterval(Ptr<RemoteChannelBundle> bundle) const
+{
+    return Time(m_schedulerTune * bundle->GetNullMessageBackoff() *
+                bundle->GetDelay().GetTimeStep());
+}
+
+void
+NullMessageSimulatorImpl::HandleGuaranteeUpdate(Ptr<RemoteChannelBundle> bundle)
+{
+    NS_LOG_FUNCTION(this << bundle);
+
+    // The remote task has reached the guarantee time last sent to it when
+    // the guarantee it sends back is one bundle delay ahead of it
+    if (bundle->GetNullMessageBackoff() > 1 &&
+        bundle->GetGuaranteeTime() - bundle->GetDelay() >= bundle->GetLastGuaranteeSent())
+    {
+        bundle->SetNullMessageBackoff(1);
+        RescheduleNullMessageEvent(bundle);
+    }
 }
 
 void
@@ -559,12 +622,41 @@ NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
 {
     NS_LOG_FUNCTION(this << bundle);
 
-    Time time = Min(Next(), GetSafeTime()) + bundle->GetDelay();
-    NullMessageMpiInterface::SendNullMessage(time, bundle);
+    // Largest factor by which the Null Message interval is lengthened
+    const uint32_t maxBackoff = 64;
+
+    // Pending packets carry the guarantee time themselves
+    if (!NullMessageMpiInterface::FlushBatch(bundle))
+    {
+        Time time = CalculateGuaranteeTime(bundle->GetSystemId());
+        bool advanced = time > bundle->GetLastGuaranteeSent();
+        bool starving =
+            bundle->GetGuaranteeTime() - bundle->GetDelay() >= bundle->GetLastGuaranteeSent();
+        if (advanced)
+        {
+            NullMessageMpiInterface::SendNullMessage(time, bundle);
+        }
+        else
+        {
+            m_statistics.nullMessagesSuppressed++;
+        }
+
+        // Back off while the remote task is ahead of what it was told, or
+        // while there is nothing new to tell it
+        uint32_t backoff = bundle->GetNullMessageBackoff();
+        bundle->SetNullMessageBackoff(advanced && starving ? 1
+                                                           : std::min(2 * backoff, maxBackoff));
+    }
 
     ScheduleNullMessageEvent(bundle);
 }
 
+NullMessageSimulatorImpl::Statistics
+NullMessageSimulatorImpl::GetStatistics() const
+{
+    return m_statistics;
+}
+
 NullMessageSimulatorImpl*
 NullMessageSimulatorImpl::GetInstance()
 {
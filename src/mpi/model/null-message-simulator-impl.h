@@ -35,10 +35,31 @@ class RemoteChannelBundle;
  * @ingroup mpi
  *
  * @brief Simulator implementation using MPI and a Null Message algorithm.
+ *
+ * Packets sent to a remote task in the same time step, or within
+ * MaxBatchDelay, are sent in one MPI message which carries the guarantee
+ * time of this task, so that a packet also serves as a Null Message.
+ * Timed Null Messages are sent only when the guarantee time has advanced.
+ * Their interval, SchedulerTune times the bundle delay, doubles while
+ * the remote task is ahead of the guarantee last sent to it, and falls
+ * back as soon as the remote task catches up with it.  Before blocking on
+ * receives every remote task is sent the current guarantee time.
  */
 class NullMessageSimulatorImpl : public SimulatorImpl
 {
   public:
+    /** Counters of the MPI messages exchanged by this task. */
+    struct Statistics
+    {
+        uint64_t packetsSent;            //!< Packets sent to remote tasks.
+        uint64_t dataMessagesSent;       //!< MPI messages sent with packets.
+        uint64_t nullMessagesSent;       //!< MPI messages sent without packets.
+        uint64_t nullMessagesSuppressed; //!< Timed Null Messages not sent.
+        uint64_t packetsReceived;        //!< Packets received from remote tasks.
+        uint64_t dataMessagesReceived;   //!< MPI messages received with packets.
+        uint64_t nullMessagesReceived;   //!< MPI messages received without packets.
+    };
+
     /**
      *  Register this type.
      *  @return The object TypeId.
@@ -80,6 +101,14 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     static NullMessageSimulatorImpl* GetInstance();
 
+    /**
+     * Get the message counters of this task.  Their ratio shows the
+     * synchronization cost: the number of Null Messages per data message.
+     *
+     * @return The counters.
+     */
+    Statistics GetStatistics() const;
+
   private:
     friend class NullMessageEvent;
     friend class NullMessageMpiInterface;
@@ -149,6 +178,21 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     void RescheduleNullMessageEvent(uint32_t nodeSysId);
 
+    /**
+     * @param bundle The bundle from which a guarantee time was received.
+     *
+     * Send the next Null Message for the bundle after the base interval
+     * if the remote task has caught up with the guarantee time last sent
+     * to it.
+     */
+    void HandleGuaranteeUpdate(Ptr<RemoteChannelBundle> bundle);
+
+    /**
+     * @param bundle The bundle.
+     * @return The current interval between Null Messages for the bundle.
+     */
+    Time GetNullMessageInterval(Ptr<RemoteChannelBundle> bundle) const;
+
     /**
      * @param systemId SystemID to compute guarantee time for
      *
@@ -216,6 +260,15 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     double m_schedulerTune;
 
+    /** Size of the largest MPI message, which bounds a batch of packets. */
+    uint32_t m_maxBatchSize;
+
+    /** Longest time for which a packet may wait for others in its batch. */
+    Time m_maxBatchDelay;
+
+    /** The message counters. */
+    Statistics m_statistics;
+
     /** Singleton instance. */
     static NullMessageSimulatorImpl* g_instance;
 };
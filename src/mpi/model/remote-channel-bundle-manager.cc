@@ -15,6 +15,7 @@
 
 #include "remote-channel-bundle-manager.h"
 
+#include "null-message-mpi-interface.h"
 #include "null-message-simulator-impl.h"
 #include "remote-channel-bundle.h"
 
@@ -77,6 +78,27 @@ RemoteChannelBundleManager::InitializeNullMessageEvents()
     g_initialized = true;
 }
 
+void
+RemoteChannelBundleManager::SendGuaranteeUpdates()
+{
+    NS_ASSERT(g_initialized);
+
+    for (auto iter = g_remoteChannelBundles.begin(); iter != g_remoteChannelBundles.end(); ++iter)
+    {
+        Ptr<RemoteChannelBundle> bundle = iter->second;
+        if (NullMessageMpiInterface::FlushBatch(bundle))
+        {
+            continue;
+        }
+        Time guarantee =
+            NullMessageSimulatorImpl::GetInstance()->CalculateGuaranteeTime(bundle->GetSystemId());
+        if (guarantee > bundle->GetLastGuaranteeSent())
+        {
+            NullMessageMpiInterface::SendNullMessage(guarantee, bundle);
+        }
+    }
+}
+
 Time
 RemoteChannelBundleManager::GetSafeTime()
 {
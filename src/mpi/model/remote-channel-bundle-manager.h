@@ -66,6 +66,14 @@ class RemoteChannelBundleManager
      */
     static void InitializeNullMessageEvents();
 
+    /**
+     * Send the pending batches of packets, and a Null Message to every
+     * remote task whose guarantee time has advanced since the last
+     * message.  Called before blocking on receives, so that no task
+     * waits for information that this task holds.
+     */
+    static void SendGuaranteeUpdates();
+
     /**
      * Get the safe time across all channels in this bundle.
      * @return The safe time.
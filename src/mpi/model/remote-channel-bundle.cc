@@ -36,6 +36,8 @@ RemoteChannelBundle::GetTypeId()
 RemoteChannelBundle::RemoteChannelBundle()
     : m_remoteSystemId(UINT32_MAX),
       m_guaranteeTime(0),
+      m_lastGuaranteeSent(0),
+      m_nullMessageBackoff(1),
       m_delay(Time::Max())
 {
 }
@@ -43,6 +45,8 @@ RemoteChannelBundle::RemoteChannelBundle()
 RemoteChannelBundle::RemoteChannelBundle(const uint32_t remoteSystemId)
     : m_remoteSystemId(remoteSystemId),
       m_guaranteeTime(0),
+      m_lastGuaranteeSent(0),
+      m_nullMessageBackoff(1),
       m_delay(Time::Max())
 {
 }
@@ -74,6 +78,31 @@ RemoteChannelBundle::SetGuaranteeTime(Time time)
     m_guaranteeTime = time;
 }
 
+Time
+RemoteChannelBundle::GetLastGuaranteeSent() const
+{
+    return m_lastGuaranteeSent;
+}
+
+void
+RemoteChannelBundle::SetLastGuaranteeSent(Time time)
+{
+    m_lastGuaranteeSent = time;
+}
+
+uint32_t
+RemoteChannelBundle::GetNullMessageBackoff() const
+{
+    return m_nullMessageBackoff;
+}
+
+void
+RemoteChannelBundle::SetNullMessageBackoff(uint32_t backoff)
+{
+    NS_ASSERT(backoff >= 1);
+    m_nullMessageBackoff = backoff;
+}
+
 Time
 RemoteChannelBundle::GetDelay() const
 {
@@ -108,8 +137,9 @@ std::ostream&
 operator<<(std::ostream& out, ns3::RemoteChannelBundle& bundle)
 {
     out << "RemoteChannelBundle Rank = " << bundle.m_remoteSystemId
-        << ", GuaranteeTime = " << bundle.m_guaranteeTime << ", Delay = " << bundle.m_delay
-        << std::endl;
+        << ", GuaranteeTime = " << bundle.m_guaranteeTime
+        << ", LastGuaranteeSent = " << bundle.m_lastGuaranteeSent << ", Delay = " << bundle.m_delay
+        << ", NullMessageBackoff = " << bundle.m_nullMessageBackoff << std::endl;
 
     for (const auto& element : bundle.m_channels)
     {
@@ -87,6 +87,34 @@ class RemoteChannelBundle : public Object
      */
     void SetGuaranteeTime(Time time);
 
+    /**
+     * Get the last guarantee time sent to the remote task, with a
+     * Null Message or a batch of packets.
+     * @return The last guarantee time sent.
+     */
+    Time GetLastGuaranteeSent() const;
+
+    /**
+     * Set the last guarantee time sent to the remote task.
+     *
+     * @param [in] time The guarantee time.
+     */
+    void SetLastGuaranteeSent(Time time);
+
+    /**
+     * Get the factor by which the interval between Null Messages for
+     * this bundle is currently lengthened.
+     * @return The backoff factor, at least 1.
+     */
+    uint32_t GetNullMessageBackoff() const;
+
+    /**
+     * Set the Null Message backoff factor.
+     *
+     * @param [in] backoff The backoff factor, at least 1.
+     */
+    void SetNullMessageBackoff(uint32_t backoff);
+
     /**
      * Get the minimum delay along any channel in this bundle
      * @return The minimum delay.
@@ -150,6 +178,12 @@ class RemoteChannelBundle : public Object
      */
     Time m_guaranteeTime;
 
+    /** Last guarantee time sent to the remote task. */
+    Time m_lastGuaranteeSent;
+
+    /** Factor applied to the base interval between Null Messages. */
+    uint32_t m_nullMessageBackoff;
+
     /**
      * Delay for this Channel bundle, which is
      * the min link delay over all incoming channels;
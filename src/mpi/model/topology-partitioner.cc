@@ -0,0 +1,525 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mpi
+ * Implementation of class ns3::TopologyPartitioner.
+ */
+
+#include "topology-partitioner.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <unordered_set>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TopologyPartitioner");
+
+TopologyPartitioner::TopologyPartitioner()
+    : m_imbalance(0.1),
+      m_lookahead(Time::Max()),
+      m_cutWeight(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+TopologyPartitioner::IndexOf(Ptr<Node> node)
+{
+    auto it = m_index.find(node->GetId());
+    if (it != m_index.end())
+    {
+        return it->second;
+    }
+    uint32_t index = m_nodes.size();
+    m_index[node->GetId()] = index;
+    m_nodes.push_back(node);
+    m_nodeWeights.push_back(1.0);
+    return index;
+}
+
+void
+TopologyPartitioner::Add(Ptr<Node> node, double weight)
+{
+    NS_LOG_FUNCTION(this << node << weight);
+    NS_ABORT_MSG_IF(weight < 0, "Negative node weight " << weight);
+    m_nodeWeights[IndexOf(node)] = weight;
+}
+
+void
+TopologyPartitioner::Add(NodeContainer nodes)
+{
+    NS_LOG_FUNCTION(this);
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        IndexOf(*it);
+    }
+}
+
+void
+TopologyPartitioner::AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight)
+{
+    NS_LOG_FUNCTION(this << a << b << delay << weight);
+    NS_ABORT_MSG_IF(delay.IsStrictlyNegative(), "Negative link delay " << delay);
+    NS_ABORT_MSG_IF(weight < 0, "Negative link weight " << weight);
+    uint32_t ia = IndexOf(a);
+    uint32_t ib = IndexOf(b);
+    if (ia != ib)
+    {
+        m_links.push_back({ia, ib, delay, weight});
+    }
+}
+
+void
+TopologyPartitioner::AddChannels()
+{
+    NS_LOG_FUNCTION(this);
+    std::unordered_set<uint32_t> seen;
+    // AddLink() appends the nodes reached through a channel, so their
+    // channels are read as well
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        Ptr<Node> node = m_nodes[i];
+        for (uint32_t d = 0; d < node->GetNDevices(); ++d)
+        {
+            Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+            if (!channel || !seen.insert(channel->GetId()).second)
+            {
+                continue;
+            }
+            std::size_t nDevices = channel->GetNDevices();
+            TimeValue delay;
+            if (nDevices == 2 && channel->GetAttributeFailSafe("Delay", delay) &&
+                delay.Get().IsStrictlyPositive())
+            {
+                AddLink(channel->GetDevice(0)->GetNode(),
+                        channel->GetDevice(1)->GetNode(),
+                        delay.Get());
+                continue;
+            }
+            for (std::size_t j = 1; j < nDevices; ++j)
+            {
+                AddLink(channel->GetDevice(0)->GetNode(), channel->GetDevice(j)->GetNode(), Time());
+            }
+        }
+    }
+}
+
+void
+TopologyPartitioner::SetLinkWeight(Ptr<Node> a, Ptr<Node> b, double weight)
+{
+    NS_LOG_FUNCTION(this << a << b << weight);
+    NS_ABORT_MSG_IF(weight < 0, "Negative link weight " << weight);
+    uint32_t ia = IndexOf(a);
+    uint32_t ib = IndexOf(b);
+    bool found = false;
+    for (auto& link : m_links)
+    {
+        if ((link.a == ia && link.b == ib) || (link.a == ib && link.b == ia))
+        {
+            link.weight = weight;
+            found = true;
+        }
+    }
+    NS_ABORT_MSG_UNLESS(found, "No link between nodes " << a->GetId() << " and " << b->GetId());
+}
+
+void
+TopologyPartitioner::SetImbalance(double imbalance)
+{
+    NS_LOG_FUNCTION(this << imbalance);
+    NS_ABORT_MSG_IF(imbalance < 0, "Negative imbalance " << imbalance);
+    m_imbalance = imbalance;
+}
+
+uint32_t
+TopologyPartitioner::Contract(Time threshold, std::vector<uint32_t>& group) const
+{
+    std::vector<uint32_t> parent(m_nodes.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (const auto& link : m_links)
+    {
+        if (link.delay.IsZero() || link.delay < threshold)
+        {
+            parent[find(link.a)] = find(link.b);
+        }
+    }
+
+    // Number the groups in order of their first node
+    const uint32_t none = m_nodes.size();
+    std::vector<uint32_t> number(m_nodes.size(), none);
+    uint32_t nGroups = 0;
+    group.resize(m_nodes.size());
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        uint32_t root = find(i);
+        if (number[root] == none)
+        {
+            number[root] = nGroups++;
+        }
+        group[i] = number[root];
+    }
+    return nGroups;
+}
+
+double
+TopologyPartitioner::Pack(const std::vector<double>& weights,
+                          uint32_t nRanks,
+                          std::vector<uint32_t>& rank)
+{
+    std::vector<uint32_t> order(weights.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&weights](uint32_t x, uint32_t y) {
+        return weights[x] > weights[y];
+    });
+    std::vector<double> load(nRanks, 0);
+    rank.resize(weights.size());
+    for (uint32_t g : order)
+    {
+        auto lightest = std::min_element(load.begin(), load.end());
+        rank[g] = lightest - load.begin();
+        *lightest += weights[g];
+    }
+    return *std::max_element(load.begin(), load.end());
+}
+
+void
+TopologyPartitioner::Partition(uint32_t nRanks)
+{
+    NS_LOG_FUNCTION(this << nRanks);
+    NS_ABORT_MSG_IF(nRanks == 0, "Cannot partition into zero ranks");
+
+    m_rankOf.assign(m_nodes.size(), 0);
+    if (nRanks == 1 || m_nodes.empty())
+    {
+        m_rankWeights.assign(nRanks, 0);
+        Evaluate();
+        return;
+    }
+
+    double total = std::accumulate(m_nodeWeights.begin(), m_nodeWeights.end(), 0.0);
+    double cap = (1 + m_imbalance) * total / nRanks;
+
+    // Find the largest delay below which all links can be contracted while
+    // the groups can still be balanced; the links which remain between
+    // groups then bound the lookahead from below
+    std::vector<Time> thresholds{Time::Max()};
+    for (const auto& link : m_links)
+    {
+        if (link.delay.IsStrictlyPositive())
+        {
+            thresholds.push_back(link.delay);
+        }
+    }
+    std::sort(thresholds.begin(), thresholds.end(), std::greater<>());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+
+    std::vector<uint32_t> group;
+    std::vector<double> weights;
+    std::vector<uint32_t> packed;
+    uint32_t nGroups = 0;
+    bool balanced = false;
+    for (const auto& threshold : thresholds)
+    {
+        nGroups = Contract(threshold, group);
+        weights.assign(nGroups, 0);
+        for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        {
+            weights[group[i]] += m_nodeWeights[i];
+        }
+        if (Pack(weights, nRanks, packed) <= cap)
+        {
+            NS_LOG_LOGIC("Contracted links below " << threshold << " into " << nGroups
+                                                   << " groups");
+            balanced = true;
+            break;
+        }
+    }
+    if (!balanced)
+    {
+        NS_LOG_WARN("Nodes joined by links without delay cannot be balanced over " << nRanks
+                                                                                   << " ranks");
+        cap = Pack(weights, nRanks, packed);
+    }
+
+    // Links between groups, merged per pair of groups
+    std::map<std::pair<uint32_t, uint32_t>, double> between;
+    for (const auto& link : m_links)
+    {
+        uint32_t ga = group[link.a];
+        uint32_t gb = group[link.b];
+        if (ga != gb)
+        {
+            between[{std::min(ga, gb), std::max(ga, gb)}] += link.weight;
+        }
+    }
+    std::vector<std::vector<std::pair<uint32_t, double>>> adjacency(nGroups);
+    for (const auto& [pair, weight] : between)
+    {
+        adjacency[pair.first].emplace_back(pair.second, weight);
+        adjacency[pair.second].emplace_back(pair.first, weight);
+    }
+
+    // Grow each rank but the last from the heaviest unassigned group,
+    // following the heaviest links out of the rank
+    std::vector<uint32_t> order(nGroups);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&weights](uint32_t x, uint32_t y) {
+        return weights[x] > weights[y];
+    });
+    std::vector<uint32_t> rankOf(nGroups, nRanks);
+    std::vector<double> load(nRanks, 0);
+    double target = total / nRanks;
+    for (uint32_t r = 0; r + 1 < nRanks; ++r)
+    {
+        std::vector<double> connection(nGroups, 0);
+        std::priority_queue<std::pair<double, uint32_t>> frontier;
+        std::size_t next = 0;
+        while (load[r] < target)
+        {
+            uint32_t chosen = nGroups;
+            while (!frontier.empty() && chosen == nGroups)
+            {
+                auto [weight, g] = frontier.top();
+                frontier.pop();
+                if (rankOf[g] == nRanks && weight == connection[g] && load[r] + weights[g] <= cap)
+                {
+                    chosen = g;
+                }
+            }
+            for (; chosen == nGroups && next < nGroups; ++next)
+            {
+                uint32_t g = order[next];
+                if (rankOf[g] == nRanks && load[r] + weights[g] <= cap)
+                {
+                    chosen = g;
+                }
+            }
+            if (chosen == nGroups)
+            {
+                break;
+            }
+            rankOf[chosen] = r;
+            load[r] += weights[chosen];
+            for (const auto& [h, weight] : adjacency[chosen])
+            {
+                if (rankOf[h] == nRanks)
+                {
+                    connection[h] += weight;
+                    frontier.emplace(connection[h], h);
+                }
+            }
+        }
+    }
+    for (uint32_t g = 0; g < nGroups; ++g)
+    {
+        if (rankOf[g] == nRanks)
+        {
+            rankOf[g] = nRanks - 1;
+            load[nRanks - 1] += weights[g];
+        }
+    }
+    if (*std::max_element(load.begin(), load.end()) > cap)
+    {
+        NS_LOG_LOGIC("Grown ranks are unbalanced, packing the groups instead");
+        rankOf = packed;
+        std::fill(load.begin(), load.end(), 0);
+        for (uint32_t g = 0; g < nGroups; ++g)
+        {
+            load[rankOf[g]] += weights[g];
+        }
+    }
+
+    // Move single groups to the rank they exchange the most traffic with,
+    // as long as the cut decreases and the ranks stay balanced
+    std::vector<uint32_t> count(nRanks, 0);
+    for (uint32_t g = 0; g < nGroups; ++g)
+    {
+        count[rankOf[g]]++;
+    }
+    std::vector<double> connection(nRanks, 0);
+    const uint32_t maxPasses = 16;
+    for (uint32_t pass = 0; pass < maxPasses; ++pass)
+    {
+        bool moved = false;
+        for (uint32_t g = 0; g < nGroups; ++g)
+        {
+            uint32_t own = rankOf[g];
+            if (count[own] == 1)
+            {
+                continue;
+            }
+            connection[own] = 0;
+            for (const auto& [h, weight] : adjacency[g])
+            {
+                connection[rankOf[h]] = 0;
+            }
+            for (const auto& [h, weight] : adjacency[g])
+            {
+                connection[rankOf[h]] += weight;
+            }
+            uint32_t best = own;
+            double bestGain = 0;
+            for (const auto& [h, weight] : adjacency[g])
+            {
+                uint32_t r = rankOf[h];
+                double gain = connection[r] - connection[own];
+                if (gain > bestGain && load[r] + weights[g] <= cap)
+                {
+                    best = r;
+                    bestGain = gain;
+                }
+            }
+            if (best != own)
+            {
+                rankOf[g] = best;
+                load[own] -= weights[g];
+                load[best] += weights[g];
+                count[own]--;
+                count[best]++;
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_rankOf[i] = rankOf[group[i]];
+    }
+    m_rankWeights.assign(nRanks, 0);
+    Evaluate();
+    NS_LOG_INFO("Partitioned " << m_nodes.size() << " nodes into " << nRanks
+                               << " ranks, lookahead " << m_lookahead << ", cut weight "
+                               << m_cutWeight);
+}
+
+void
+TopologyPartitioner::Evaluate()
+{
+    NS_LOG_FUNCTION(this);
+    std::fill(m_rankWeights.begin(), m_rankWeights.end(), 0);
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if (m_rankOf[i] >= m_rankWeights.size())
+        {
+            m_rankWeights.resize(m_rankOf[i] + 1, 0);
+        }
+        m_rankWeights[m_rankOf[i]] += m_nodeWeights[i];
+    }
+    m_lookahead = Time::Max();
+    m_cutWeight = 0;
+    for (const auto& link : m_links)
+    {
+        if (m_rankOf[link.a] != m_rankOf[link.b])
+        {
+            m_lookahead = std::min(m_lookahead, link.delay);
+            m_cutWeight += link.weight;
+        }
+    }
+}
+
+void
+TopologyPartitioner::Apply() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_rankOf.size() != m_nodes.size(), "Partition() has not been called");
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_nodes[i]->SetAttribute("SystemId", UintegerValue(m_rankOf[i]));
+    }
+}
+
+void
+TopologyPartitioner::ReadSystemIds()
+{
+    NS_LOG_FUNCTION(this);
+    m_rankOf.resize(m_nodes.size());
+    m_rankWeights.clear();
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_rankOf[i] = m_nodes[i]->GetSystemId();
+    }
+    Evaluate();
+}
+
+uint32_t
+TopologyPartitioner::GetSystemId(Ptr<Node> node) const
+{
+    auto it = m_index.find(node->GetId());
+    NS_ABORT_MSG_IF(it == m_index.end(), "Node " << node->GetId() << " was not added");
+    NS_ABORT_MSG_IF(it->second >= m_rankOf.size(), "Partition() has not been called");
+    return m_rankOf[it->second];
+}
+
+Time
+TopologyPartitioner::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+double
+TopologyPartitioner::GetCutWeight() const
+{
+    return m_cutWeight;
+}
+
+double
+TopologyPartitioner::GetRankWeight(uint32_t rank) const
+{
+    return rank < m_rankWeights.size() ? m_rankWeights[rank] : 0;
+}
+
+void
+TopologyPartitioner::Print(std::ostream& os) const
+{
+    os << m_nodes.size() << " nodes in " << m_rankWeights.size() << " ranks, lookahead ";
+    if (m_lookahead == Time::Max())
+    {
+        os << "unbounded";
+    }
+    else
+    {
+        os << m_lookahead.As(Time::MS);
+    }
+    os << ", cut weight " << m_cutWeight << std::endl;
+    for (uint32_t r = 0; r < m_rankWeights.size(); ++r)
+    {
+        os << "rank " << r << " (weight " << m_rankWeights[r] << "):";
+        for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        {
+            if (m_rankOf[i] == r)
+            {
+                os << " " << m_nodes[i]->GetId();
+            }
+        }
+        os << std::endl;
+    }
+}
+
+} // namespace ns3
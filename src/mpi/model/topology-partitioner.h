@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mpi
+ * Declaration of class ns3::TopologyPartitioner.
+ */
+
+#ifndef NS3_TOPOLOGY_PARTITIONER_H
+#define NS3_TOPOLOGY_PARTITIONER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Node;
+
+/**
+ * @ingroup mpi
+ *
+ * @brief Compute the system ids of the nodes of a distributed simulation.
+ *
+ * The topology is described as a graph of nodes and links.  Every link
+ * has a propagation delay and an expected traffic weight, for instance
+ * the expected number of packets per second over the link.  Links with a
+ * positive delay are the candidates for a remote point-to-point channel;
+ * links without a delay are never cut.
+ *
+ * Partition() splits the nodes into a number of ranks of roughly equal
+ * weight.  It first maximizes the lookahead, which is the smallest delay
+ * of the links between ranks: the links shorter than the largest
+ * feasible delay are contracted, so that they cannot be cut, as long as
+ * the remaining groups of nodes can still be balanced.  It then grows
+ * the ranks from the heaviest groups along the heaviest links and refines
+ * them by moving groups between ranks while the weight of the cut links
+ * decreases.
+ *
+ * With MPI the system ids must be set before the point-to-point links are
+ * installed, since PointToPointHelper chooses a PointToPointRemoteChannel
+ * from the system ids of the two nodes.  A typical script creates the
+ * nodes, describes the links to be installed with AddLink(), calls
+ * Partition() and Apply(), and then installs the links:
+ *
+ * @code
+ *   NodeContainer nodes;
+ *   nodes.Create(64);
+ *   TopologyPartitioner partitioner;
+ *   partitioner.Add(nodes);
+ *   partitioner.AddLink(nodes.Get(0), nodes.Get(1), MilliSeconds(5), 100);
+ *   ...
+ *   partitioner.Partition(MpiInterface::GetSize());
+ *   partitioner.Apply();
+ * @endcode
+ *
+ * AddChannels() reads the links of a topology which is already built
+ * instead, for example to assess a manual partition with ReadSystemIds()
+ * and Print(), or to partition the nodes for MultithreadedSimulatorImpl,
+ * which reads the system ids when it starts to run.
+ */
+class TopologyPartitioner
+{
+  public:
+    TopologyPartitioner();
+
+    /**
+     * Add a node with a given weight, or change its weight.
+     *
+     * @param [in] node The node.
+     * @param [in] weight The expected processing load of the node.
+     */
+    void Add(Ptr<Node> node, double weight = 1.0);
+
+    /**
+     * Add nodes with unit weight.
+     *
+     * @param [in] nodes The nodes.
+     */
+    void Add(NodeContainer nodes);
+
+    /**
+     * Add a link between two nodes.  The nodes are added if needed.
+     * Several links between the same nodes are allowed.
+     *
+     * @param [in] a One end of the link.
+     * @param [in] b The other end of the link.
+     * @param [in] delay The propagation delay of the link; a link without
+     *             delay is never cut.
+     * @param [in] weight The expected traffic over the link.
+     */
+    void AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight = 1.0);
+
+    /**
+     * Add the links of the channels attached to the devices of the nodes
+     * added so far.  A channel with two devices and a positive \c Delay
+     * attribute gives a link with unit weight; the nodes attached to any
+     * other channel are kept together.  The nodes reached through these
+     * channels are added with unit weight if needed, and their channels are
+     * read too, so the whole connected topology is added.
+     */
+    void AddChannels();
+
+    /**
+     * Set the traffic weight of the links between two nodes.
+     *
+     * @param [in] a One end of the links.
+     * @param [in] b The other end of the links.
+     * @param [in] weight The expected traffic over each link.
+     */
+    void SetLinkWeight(Ptr<Node> a, Ptr<Node> b, double weight);
+
+    /**
+     * Set the tolerated imbalance between the ranks.
+     *
+     * @param [in] imbalance The largest relative excess of the weight of a
+     *             rank over the average; 0.1 by default.
+     */
+    void SetImbalance(double imbalance);
+
+    /**
+     * Compute the partition.
+     *
+     * @param [in] nRanks The number of ranks.
+     */
+    void Partition(uint32_t nRanks);
+
+    /**
+     * Set the \c SystemId attribute of every node to its rank.
+     */
+    void Apply() const;
+
+    /**
+     * Take the current system ids of the nodes as the partition, so that
+     * the figures of merit of a manual partition can be read.
+     */
+    void ReadSystemIds();
+
+    /**
+     * Get the rank of a node.
+     *
+     * @param [in] node The node.
+     * @returns The rank computed by Partition().
+     */
+    uint32_t GetSystemId(Ptr<Node> node) const;
+
+    /**
+     * Get the lookahead of the partition.
+     *
+     * @returns The smallest delay of a link between two ranks, or
+     *          Time::Max() if no link is cut.
+     */
+    Time GetLookahead() const;
+
+    /**
+     * Get the weight of the cut.
+     *
+     * @returns The sum of the weights of the links between two ranks.
+     */
+    double GetCutWeight() const;
+
+    /**
+     * Get the weight of a rank.
+     *
+     * @param [in] rank The rank.
+     * @returns The sum of the weights of the nodes of the rank.
+     */
+    double GetRankWeight(uint32_t rank) const;
+
+    /**
+     * Print the rank assignment and its figures of merit.
+     *
+     * @param [in,out] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /** A link between two nodes. */
+    struct Link
+    {
+        uint32_t a;    //!< Index of one end.
+        uint32_t b;    //!< Index of the other end.
+        Time delay;    //!< Propagation delay, or zero if it cannot be cut.
+        double weight; //!< Expected traffic.
+    };
+
+    /**
+     * Get the index of a node, adding it if needed.
+     *
+     * @param [in] node The node.
+     * @returns The index of the node.
+     */
+    uint32_t IndexOf(Ptr<Node> node);
+
+    /**
+     * Contract the links shorter than a delay.
+     *
+     * @param [in] threshold The delay; links with no delay are always
+     *             contracted.
+     * @param [out] group The group of each node.
+     * @returns The number of groups.
+     */
+    uint32_t Contract(Time threshold, std::vector<uint32_t>& group) const;
+
+    /**
+     * Assign groups to ranks, heaviest first, each to the lightest rank.
+     *
+     * @param [in] weights The weights of the groups.
+     * @param [in] nRanks The number of ranks.
+     * @param [out] rank The rank of each group.
+     * @returns The weight of the heaviest rank.
+     */
+    static double Pack(const std::vector<double>& weights,
+                       uint32_t nRanks,
+                       std::vector<uint32_t>& rank);
+
+    /** Compute the lookahead, the cut and the rank weights. */
+    void Evaluate();
+
+    std::vector<Ptr<Node>> m_nodes;                 //!< The nodes.
+    std::vector<double> m_nodeWeights;              //!< Weight of each node.
+    std::unordered_map<uint32_t, uint32_t> m_index; //!< Node index by node id.
+    std::vector<Link> m_links;                      //!< The links.
+    double m_imbalance;                             //!< Tolerated imbalance.
+    std::vector<uint32_t> m_rankOf;                 //!< Rank of each node.
+    std::vector<double> m_rankWeights;              //!< Weight of each rank.
+    Time m_lookahead;                               //!< Smallest delay of a cut link.
+    double m_cutWeight;                             //!< Weight of the cut links.
+};
+
+} // namespace ns3
+
+#endif /* NS3_TOPOLOGY_PARTITIONER_H */
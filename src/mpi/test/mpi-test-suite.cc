@@ -161,3 +161,7 @@ static MpiTestSuite g_mpiEmpty3NullMsg("mpi-example-empty-3-nullmsg",
                                        NS_TEST_SOURCEDIR,
                                        3,
                                        "-nullmsg");
+static MpiTestSuite g_mpiNmsBatching2("mpi-example-nms-batching-2",
+                                      "nms-batching-distributed",
+                                      NS_TEST_SOURCEDIR,
+                                      2);
@@ -0,0 +1,208 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/topology-partitioner.h"
+
+/**
+ * @file
+ * @ingroup mpi-tests
+ * TopologyPartitioner test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * @ingroup mpi-tests
+ *
+ * @brief Keep clusters joined by short links together.
+ *
+ * Two clusters of four nodes are each joined by 1 ms links with a heavy
+ * traffic weight, and the clusters by a single light 10 ms link.  Cutting
+ * that link is the only partition into two ranks with a 10 ms lookahead.
+ */
+class TopologyPartitionerLookaheadTestCase : public TestCase
+{
+  public:
+    TopologyPartitionerLookaheadTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TopologyPartitionerLookaheadTestCase::TopologyPartitionerLookaheadTestCase()
+    : TestCase("Maximize the lookahead")
+{
+}
+
+void
+TopologyPartitionerLookaheadTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(8);
+    TopologyPartitioner partitioner;
+    partitioner.Add(nodes);
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        for (uint32_t i = 1; i < 4; ++i)
+        {
+            partitioner.AddLink(nodes.Get(4 * c), nodes.Get(4 * c + i), MilliSeconds(1), 10);
+        }
+    }
+    partitioner.AddLink(nodes.Get(3), nodes.Get(4), MilliSeconds(10));
+    partitioner.Partition(2);
+
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(10), "Wrong lookahead");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetCutWeight(), 1, "Wrong cut weight");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetRankWeight(0), 4, "Unbalanced ranks");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetRankWeight(1), 4, "Unbalanced ranks");
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(partitioner.GetSystemId(nodes.Get(i)),
+                              partitioner.GetSystemId(nodes.Get(i < 4 ? 0 : 4)),
+                              "Node " << i << " is not with its cluster");
+    }
+    Simulator::Destroy();
+}
+
+/**
+ * @ingroup mpi-tests
+ *
+ * @brief Cut the lightest link when all delays are equal.
+ *
+ * Six nodes form a line whose links have the same delay; the link in the
+ * middle carries much less traffic than the others.
+ */
+class TopologyPartitionerMinCutTestCase : public TestCase
+{
+  public:
+    TopologyPartitionerMinCutTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TopologyPartitionerMinCutTestCase::TopologyPartitionerMinCutTestCase()
+    : TestCase("Minimize the cut")
+{
+}
+
+void
+TopologyPartitionerMinCutTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(6);
+    TopologyPartitioner partitioner;
+    partitioner.Add(nodes);
+    for (uint32_t i = 0; i + 1 < 6; ++i)
+    {
+        partitioner.AddLink(nodes.Get(i), nodes.Get(i + 1), MilliSeconds(2), 100);
+    }
+    partitioner.SetLinkWeight(nodes.Get(2), nodes.Get(3), 1);
+    partitioner.Partition(2);
+
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(2), "Wrong lookahead");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetCutWeight(), 1, "Heavy link cut");
+    NS_TEST_EXPECT_MSG_NE(partitioner.GetSystemId(nodes.Get(2)),
+                          partitioner.GetSystemId(nodes.Get(3)),
+                          "Light link not cut");
+    Simulator::Destroy();
+}
+
+/**
+ * @ingroup mpi-tests
+ *
+ * @brief Partition a built topology and set the system ids.
+ *
+ * Four nodes are joined in a line by SimpleChannels with delays of 0, 2
+ * and 1 ms.  The channel without delay must not be cut, so the best
+ * partition into two ranks cuts the 2 ms channel.  The manual partition
+ * {0}, {1, 2, 3} is read back first and cuts the channel without delay.
+ */
+class TopologyPartitionerChannelsTestCase : public TestCase
+{
+  public:
+    TopologyPartitionerChannelsTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TopologyPartitionerChannelsTestCase::TopologyPartitionerChannelsTestCase()
+    : TestCase("Partition the channels of a built topology")
+{
+}
+
+void
+TopologyPartitionerChannelsTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(1, 0);
+    nodes.Create(3, 1);
+    for (uint32_t i = 0; i + 1 < 4; ++i)
+    {
+        auto channel = CreateObject<SimpleChannel>();
+        channel->SetAttribute("Delay", TimeValue(i == 0 ? Time() : MilliSeconds(3 - i)));
+        for (uint32_t j = i; j < i + 2; ++j)
+        {
+            auto device = CreateObject<SimpleNetDevice>();
+            device->SetChannel(channel);
+            nodes.Get(j)->AddDevice(device);
+        }
+    }
+
+    TopologyPartitioner partitioner;
+    partitioner.Add(nodes);
+    partitioner.AddChannels();
+    partitioner.ReadSystemIds();
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), Time(), "Channel without delay not cut");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetRankWeight(1), 3, "Wrong manual rank weight");
+
+    TopologyPartitioner reached;
+    reached.Add(nodes.Get(0));
+    reached.AddChannels();
+    reached.ReadSystemIds();
+    NS_TEST_EXPECT_MSG_EQ(reached.GetRankWeight(1), 3, "Channels of reached nodes not read");
+
+    partitioner.Partition(2);
+    partitioner.Apply();
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(2), "Wrong lookahead");
+    NS_TEST_EXPECT_MSG_EQ(nodes.Get(0)->GetSystemId(),
+                          nodes.Get(1)->GetSystemId(),
+                          "Channel without delay cut");
+    NS_TEST_EXPECT_MSG_NE(nodes.Get(1)->GetSystemId(),
+                          nodes.Get(2)->GetSystemId(),
+                          "Wrong channel cut");
+    NS_TEST_EXPECT_MSG_EQ(nodes.Get(2)->GetSystemId(),
+                          nodes.Get(3)->GetSystemId(),
+                          "Wrong channel cut");
+    Simulator::Destroy();
+}
+
+/**
+ * @ingroup mpi-tests
+ *
+ * @brief TopologyPartitioner test suite.
+ */
+class TopologyPartitionerTestSuite : public TestSuite
+{
+  public:
+    TopologyPartitionerTestSuite();
+};
+
+TopologyPartitionerTestSuite::TopologyPartitionerTestSuite()
+    : TestSuite("mpi-topology-partitioner", Type::UNIT)
+{
+    AddTestCase(new TopologyPartitionerLookaheadTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new TopologyPartitionerMinCutTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new TopologyPartitionerChannelsTestCase(), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static TopologyPartitionerTestSuite g_topologyPartitionerTestSuite;
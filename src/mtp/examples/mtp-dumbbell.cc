@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mtp
+ *
+ * A dumbbell run with MultithreadedSimulatorImpl:
+ *
+ *   l0 ---|                  |--- r0
+ *   l1 ---+- lr ------- rr --+--- r1
+ *   ...   |                  |    ...
+ *
+ * Each left leaf sends UDP traffic to the matching right leaf.  With
+ * --systemIds the left half is given system id 0 and the right half
+ * system id 1, otherwise the nodes are partitioned automatically into
+ * --threads partitions.  With --serial the same scenario runs on
+ * DefaultSimulatorImpl, and the received byte counts should match.
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t leaves = 8;
+    uint32_t threads = 2;
+    bool systemIds = false;
+    bool serial = false;
+    Time duration = Seconds(10);
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("leaves", "Number of leaves on each side", leaves);
+    cmd.AddValue("threads", "Maximum number of threads", threads);
+    cmd.AddValue("systemIds", "Partition by system id instead of automatically", systemIds);
+    cmd.AddValue("serial", "Run on the default, sequential simulator", serial);
+    cmd.AddValue("duration", "Simulated time", duration);
+    cmd.Parse(argc, argv);
+
+    if (!serial)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::MultithreadedSimulatorImpl"));
+        Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(threads));
+    }
+
+    Config::SetDefault("ns3::OnOffApplication::PacketSize", UintegerValue(512));
+    Config::SetDefault("ns3::OnOffApplication::DataRate", StringValue("10Mbps"));
+
+    uint32_t right = systemIds ? 1 : 0;
+    NodeContainer leftLeaves;
+    leftLeaves.Create(leaves, 0);
+    NodeContainer routers;
+    routers.Add(CreateObject<Node>(0));
+    routers.Add(CreateObject<Node>(right));
+    NodeContainer rightLeaves;
+    rightLeaves.Create(leaves, right);
+
+    PointToPointHelper routerLink;
+    routerLink.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    routerLink.SetChannelAttribute("Delay", StringValue("5ms"));
+    PointToPointHelper leafLink;
+    leafLink.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    leafLink.SetChannelAttribute("Delay", StringValue("1ms"));
+
+    NetDeviceContainer routerDevices = routerLink.Install(routers);
+
+    InternetStackHelper stack;
+    stack.InstallAll();
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.0.0.0", "255.255.255.0");
+    address.Assign(routerDevices);
+
+    Ipv4InterfaceContainer rightInterfaces;
+    for (uint32_t i = 0; i < leaves; ++i)
+    {
+        address.NewNetwork();
+        address.Assign(leafLink.Install(leftLeaves.Get(i), routers.Get(0)));
+        address.NewNetwork();
+        rightInterfaces.Add(
+            address.Assign(leafLink.Install(rightLeaves.Get(i), routers.Get(1))).Get(0));
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    uint16_t port = 50000;
+    PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinks = sinkHelper.Install(rightLeaves);
+    sinks.Start(Seconds(0));
+
+    OnOffHelper clientHelper("ns3::UdpSocketFactory", Address());
+    clientHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+    clientHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+    ApplicationContainer clients;
+    for (uint32_t i = 0; i < leaves; ++i)
+    {
+        clientHelper.SetAttribute("Remote",
+                                  AddressValue(InetSocketAddress(rightInterfaces.GetAddress(i),
+                                                                 port)));
+        clients.Add(clientHelper.Install(leftLeaves.Get(i)));
+    }
+    clients.Start(Seconds(1));
+
+    Simulator::Stop(duration);
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t received = 0;
+    for (uint32_t i = 0; i < sinks.GetN(); ++i)
+    {
+        received += DynamicCast<PacketSink>(sinks.Get(i))->GetTotalRx();
+    }
+    std::cout << "Received " << received << " bytes in " << Simulator::GetEventCount()
+              << " events, " << elapsed.count() << " s" << std::endl;
+
+    auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        std::cout << impl->GetNPartitions() << " partitions, lookahead " << impl->GetLookahead()
+                  << ", " << impl->GetWindowCount() << " windows" << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
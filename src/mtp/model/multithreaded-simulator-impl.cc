@@ -0,0 +1,798 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/make-event.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::m_current =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "Maximum number of threads, including the main thread; "
+                          "0 for the number of hardware threads.  Without system ids, "
+                          "this is also the number of partitions.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_globalUid(EventId::UID::VALID),
+      m_globalUnscheduled(0),
+      m_globalTs(0),
+      m_globalContext(Simulator::NO_CONTEXT),
+      m_globalCurrentUid(EventId::UID::INVALID),
+      m_globalEventCount(0),
+      m_nPartitions(0),
+      m_nThreads(1),
+      m_maxThreads(0),
+      m_lookahead(std::numeric_limits<uint64_t>::max()),
+      m_windowEnd(0),
+      m_windowCount(0),
+      m_done(false),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& p : m_partitions)
+    {
+        while (!p.events->IsEmpty())
+        {
+            p.events->RemoveNext().impl->Unref();
+        }
+        p.events = nullptr;
+    }
+    m_partitions.clear();
+    if (m_global)
+    {
+        while (!m_global->IsEmpty())
+        {
+            m_global->RemoveNext().impl->Unref();
+        }
+        m_global = nullptr;
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+
+    auto migrate = [&schedulerFactory](Ptr<Scheduler>& events) {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (events)
+        {
+            while (!events->IsEmpty())
+            {
+                scheduler->Insert(events->RemoveNext());
+            }
+        }
+        events = scheduler;
+    };
+    migrate(m_global);
+    for (auto& p : m_partitions)
+    {
+        migrate(p.events);
+    }
+}
+
+MultithreadedSimulatorImpl::Partition*
+MultithreadedSimulatorImpl::Current() const
+{
+    return m_current;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::PartitionOf(uint32_t context) const
+{
+    return context < m_partitionOf.size() ? m_partitionOf[context] : m_nPartitions;
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert(Scheduler* events,
+                                   uint32_t& uid,
+                                   uint64_t ts,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = uid;
+    uid++;
+    events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::InsertSerial(uint64_t ts, uint32_t context, EventImpl* event)
+{
+    uint32_t index = PartitionOf(context);
+    if (index < m_nPartitions)
+    {
+        Partition& p = m_partitions[index];
+        p.unscheduledEvents++;
+        return Insert(PeekPointer(p.events), p.uid, ts, context, event);
+    }
+    m_globalUnscheduled++;
+    return Insert(PeekPointer(m_global), m_globalUid, ts, context, event);
+}
+
+void
+MultithreadedSimulatorImpl::BuildPartitions()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Collect every pending event back into the global queue; keys are
+    // kept so that outstanding EventIds remain valid
+    for (auto& p : m_partitions)
+    {
+        while (!p.events->IsEmpty())
+        {
+            m_global->Insert(p.events->RemoveNext());
+            m_globalUnscheduled++;
+        }
+        m_globalUid = std::max(m_globalUid, p.uid);
+    }
+
+    uint32_t nNodes = NodeList::GetNNodes();
+    uint32_t maxSystemId = 0;
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        maxSystemId = std::max(maxSystemId, NodeList::GetNode(i)->GetSystemId());
+    }
+
+    uint32_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    uint32_t maxThreads = m_maxThreads == 0 ? hardware : m_maxThreads;
+    m_partitionOf.assign(nNodes, 0);
+    if (maxSystemId > 0)
+    {
+        m_nPartitions = maxSystemId + 1;
+        for (uint32_t i = 0; i < nNodes; ++i)
+        {
+            m_partitionOf[i] = NodeList::GetNode(i)->GetSystemId();
+        }
+    }
+    else
+    {
+        // Visit the nodes breadth first along channels, so that contiguous
+        // slices of the visiting order are groups of neighbours
+        m_nPartitions = std::max(1U, std::min(maxThreads, nNodes));
+        std::vector<uint32_t> order;
+        std::vector<bool> visited(nNodes, false);
+        std::deque<uint32_t> queue;
+        for (uint32_t root = 0; root < nNodes; ++root)
+        {
+            if (visited[root])
+            {
+                continue;
+            }
+            visited[root] = true;
+            queue.push_back(root);
+            while (!queue.empty())
+            {
+                uint32_t id = queue.front();
+                queue.pop_front();
+                order.push_back(id);
+                Ptr<Node> node = NodeList::GetNode(id);
+                for (uint32_t d = 0; d < node->GetNDevices(); ++d)
+                {
+                    Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+                    if (!channel)
+                    {
+                        continue;
+                    }
+                    for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+                    {
+                        uint32_t peer = channel->GetDevice(j)->GetNode()->GetId();
+                        if (!visited[peer])
+                        {
+                            visited[peer] = true;
+                            queue.push_back(peer);
+                        }
+                    }
+                }
+            }
+        }
+        uint32_t slice = (nNodes + m_nPartitions - 1) / std::max(1U, m_nPartitions);
+        for (uint32_t i = 0; i < order.size(); ++i)
+        {
+            m_partitionOf[order[i]] = i / slice;
+        }
+        // Channels tell local from remote peers by their system id
+        for (uint32_t i = 0; i < nNodes; ++i)
+        {
+            NodeList::GetNode(i)->SetAttribute("SystemId", UintegerValue(m_partitionOf[i]));
+        }
+    }
+
+    // The lookahead is the smallest delay of a channel across partitions.
+    // Only point-to-point channels know how to hand packets over to another
+    // thread; the breadth first split may also cut multi-access channels
+    TypeId p2p;
+    bool haveP2p = TypeId::LookupByNameFailSafe("ns3::PointToPointChannel", &p2p);
+    m_lookahead = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        for (uint32_t d = 0; d < node->GetNDevices(); ++d)
+        {
+            Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+            {
+                uint32_t peer = channel->GetDevice(j)->GetNode()->GetId();
+                if (m_partitionOf[peer] == m_partitionOf[i])
+                {
+                    continue;
+                }
+                TypeId tid = channel->GetInstanceTypeId();
+                NS_ABORT_MSG_IF(!haveP2p || (tid != p2p && !tid.IsChildOf(p2p)),
+                                "Channel " << tid.GetName()
+                                           << " connects nodes " << i << " and " << peer
+                                           << " of different partitions; only "
+                                              "PointToPointChannel may cross partitions.  "
+                                              "Assign system ids which keep the nodes of "
+                                              "this channel together");
+                TimeValue delay;
+                if (!channel->GetAttributeFailSafe("Delay", delay) ||
+                    !delay.Get().IsStrictlyPositive())
+                {
+                    NS_FATAL_ERROR("Channel " << tid.GetName() << " connects nodes " << i
+                                              << " and " << peer
+                                              << " of different partitions without a delay");
+                }
+                m_lookahead = std::min(m_lookahead, (uint64_t)delay.Get().GetTimeStep());
+            }
+        }
+    }
+
+    m_partitions.clear();
+    m_partitions.resize(m_nPartitions);
+    for (auto& p : m_partitions)
+    {
+        p.events = m_schedulerFactory.Create<Scheduler>();
+        p.uid = m_globalUid;
+        p.currentTs = m_globalTs;
+        p.outbox.resize(m_nPartitions);
+    }
+
+    // Hand the events with a node context to their partition
+    Ptr<Scheduler> global = m_schedulerFactory.Create<Scheduler>();
+    while (!m_global->IsEmpty())
+    {
+        Scheduler::Event ev = m_global->RemoveNext();
+        uint32_t index = PartitionOf(ev.key.m_context);
+        if (index < m_nPartitions)
+        {
+            m_partitions[index].events->Insert(ev);
+            m_partitions[index].unscheduledEvents++;
+            m_globalUnscheduled--;
+        }
+        else
+        {
+            global->Insert(ev);
+        }
+    }
+    m_global = global;
+
+    m_nThreads = std::max(1U, std::min(maxThreads, m_nPartitions));
+    NS_LOG_INFO(m_nPartitions << " partitions on " << m_nThreads << " threads, lookahead "
+                              << TimeStep(m_lookahead));
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_global)
+    {
+        m_global = m_schedulerFactory.Create<Scheduler>();
+    }
+    BuildPartitions();
+
+    m_stop = false;
+    m_done = false;
+    m_windowBarrier = std::make_unique<std::barrier<>>(m_nThreads);
+    m_syncBarrier =
+        std::make_unique<std::barrier<WindowCompletion>>(m_nThreads, WindowCompletion{this});
+    for (uint32_t t = 1; t < m_nThreads; ++t)
+    {
+        m_threads.emplace_back(&MultithreadedSimulatorImpl::Work, this, t);
+    }
+    Work(0);
+    for (auto& t : m_threads)
+    {
+        t.join();
+    }
+    m_threads.clear();
+    m_windowBarrier.reset();
+    m_syncBarrier.reset();
+
+    for (const auto& p : m_partitions)
+    {
+        m_globalTs = std::max(m_globalTs, p.currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Work(uint32_t thread)
+{
+    while (true)
+    {
+        m_syncBarrier->arrive_and_wait();
+        if (m_done)
+        {
+            break;
+        }
+        for (uint32_t i = thread; i < m_nPartitions; i += m_nThreads)
+        {
+            ProcessPartition(i);
+        }
+        m_windowBarrier->arrive_and_wait();
+        for (uint32_t i = thread; i < m_nPartitions; i += m_nThreads)
+        {
+            DeliverMessages(i);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessPartition(uint32_t index)
+{
+    Partition& p = m_partitions[index];
+    m_current = &p;
+    while (!p.events->IsEmpty() && !p.stopped)
+    {
+        if (p.events->PeekNext().key.m_ts >= m_windowEnd)
+        {
+            break;
+        }
+        Scheduler::Event next = p.events->RemoveNext();
+
+        PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+        NS_ASSERT(next.key.m_ts >= p.currentTs);
+        p.unscheduledEvents--;
+        p.eventCount++;
+        p.currentTs = next.key.m_ts;
+        p.currentContext = next.key.m_context;
+        p.currentUid = next.key.m_uid;
+        next.impl->Invoke();
+        next.impl->Unref();
+    }
+    m_current = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::DeliverMessages(uint32_t index)
+{
+    Partition& dst = m_partitions[index];
+    for (auto& src : m_partitions)
+    {
+        for (const auto& msg : src.outbox[index])
+        {
+            Insert(PeekPointer(dst.events), dst.uid, msg.ts, msg.context, msg.event);
+            dst.unscheduledEvents++;
+        }
+        src.outbox[index].clear();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::NextWindow()
+{
+    while (true)
+    {
+        if (m_stop)
+        {
+            m_done = true;
+            return;
+        }
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (const auto& p : m_partitions)
+        {
+            if (!p.events->IsEmpty())
+            {
+                next = std::min(next, p.events->PeekNext().key.m_ts);
+            }
+        }
+        bool haveGlobal = !m_global->IsEmpty();
+        if (haveGlobal && m_global->PeekNext().key.m_ts <= next)
+        {
+            // Global events run alone, with every partition at their time
+            Scheduler::Event ev = m_global->RemoveNext();
+            m_globalUnscheduled--;
+            m_globalEventCount++;
+            m_globalTs = ev.key.m_ts;
+            m_globalContext = ev.key.m_context;
+            m_globalCurrentUid = ev.key.m_uid;
+            ev.impl->Invoke();
+            ev.impl->Unref();
+            continue;
+        }
+        if (next == std::numeric_limits<uint64_t>::max())
+        {
+            m_done = true;
+            return;
+        }
+        m_globalTs = next;
+        m_globalContext = Simulator::NO_CONTEXT;
+        m_windowEnd = next + std::min(m_lookahead, std::numeric_limits<uint64_t>::max() - next);
+        if (haveGlobal)
+        {
+            m_windowEnd = std::min(m_windowEnd, m_global->PeekNext().key.m_ts);
+        }
+        m_windowCount++;
+        return;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    Partition* p = Current();
+    if (p != nullptr)
+    {
+        // The other partitions finish the window, so that where they stop
+        // does not depend on the thread schedule
+        p->stopped = true;
+    }
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    uint64_t ts = Now().GetTimeStep() + delay.GetTimeStep();
+    EventImpl* event = MakeEvent(&Simulator::Stop);
+    Partition* p = Current();
+    if (p == nullptr)
+    {
+        // A global event, so that every partition reaches the stop time
+        m_globalUnscheduled++;
+        return Insert(PeekPointer(m_global), m_globalUid, ts, Simulator::NO_CONTEXT, event);
+    }
+    // The other partitions may already be past the stop time: stop this one
+    // exactly, and the others at the end of that window, as Stop() does
+    p->unscheduledEvents++;
+    return Insert(PeekPointer(p->events), p->uid, ts, p->currentContext, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    Partition* p = Current();
+    if (p == nullptr)
+    {
+        return InsertSerial(m_globalTs + delay.GetTimeStep(), m_globalContext, event);
+    }
+    p->unscheduledEvents++;
+    return Insert(PeekPointer(p->events),
+                  p->uid,
+                  p->currentTs + delay.GetTimeStep(),
+                  p->currentContext,
+                  event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    Partition* p = Current();
+    if (p == nullptr)
+    {
+        InsertSerial(m_globalTs + delay.GetTimeStep(), context, event);
+        return;
+    }
+
+    uint64_t ts = p->currentTs + delay.GetTimeStep();
+    uint32_t index = PartitionOf(context);
+    if (index < m_nPartitions && &m_partitions[index] == p)
+    {
+        p->unscheduledEvents++;
+        Insert(PeekPointer(p->events), p->uid, ts, context, event);
+    }
+    else if (index < m_nPartitions)
+    {
+        NS_ASSERT_MSG(ts >= m_windowEnd,
+                      "Event for node " << context << " in another partition is "
+                                        << TimeStep(ts - p->currentTs)
+                                        << " ahead, less than the lookahead "
+                                        << TimeStep(m_lookahead));
+        p->outbox[index].push_back(Message{ts, context, event});
+    }
+    else
+    {
+        // The other partitions may already be past ts, so the event could
+        // not run alone at its time
+        NS_ABORT_MSG_IF(ts < m_windowEnd,
+                        "Event without a node context scheduled from a partition "
+                            << TimeStep(ts - p->currentTs)
+                            << " ahead, less than the end of the window; schedule it at "
+                               "least one lookahead ("
+                            << TimeStep(m_lookahead) << ") ahead");
+        std::unique_lock lock{m_globalMutex};
+        m_globalUnscheduled++;
+        Insert(PeekPointer(m_global), m_globalUid, ts, context, event);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    std::unique_lock lock{m_globalMutex};
+    EventId id(Ptr<EventImpl>(event, false), Now().GetTimeStep(), 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    Partition* p = Current();
+    return TimeStep(p ? p->currentTs : m_globalTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    return TimeStep(id.GetTs() - Now().GetTimeStep());
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        std::unique_lock lock{m_globalMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+
+    uint32_t index = PartitionOf(id.GetContext());
+    if (index < m_nPartitions)
+    {
+        NS_ASSERT_MSG(Current() == nullptr || Current() == &m_partitions[index],
+                      "Cannot remove an event of another partition");
+        m_partitions[index].events->Remove(event);
+        m_partitions[index].unscheduledEvents--;
+    }
+    else
+    {
+        std::unique_lock lock{m_globalMutex, std::defer_lock};
+        if (Current() != nullptr)
+        {
+            lock.lock();
+        }
+        m_global->Remove(event);
+        m_globalUnscheduled--;
+    }
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        std::unique_lock lock{m_globalMutex, std::defer_lock};
+        if (Current() != nullptr)
+        {
+            lock.lock();
+        }
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Compare with the clock of the queue holding the event
+    uint64_t currentTs = m_globalTs;
+    uint32_t currentUid = m_globalCurrentUid;
+    uint32_t index = PartitionOf(id.GetContext());
+    if (index < m_nPartitions)
+    {
+        // The clock of another partition moves during a window; global events
+        // only change between windows
+        NS_ASSERT_MSG(Current() == nullptr || Current() == &m_partitions[index],
+                      "Cannot check an event of another partition");
+        currentTs = m_partitions[index].currentTs;
+        currentUid = m_partitions[index].currentUid;
+    }
+    return id.PeekEventImpl() == nullptr || id.GetTs() < currentTs ||
+           (id.GetTs() == currentTs && id.GetUid() <= currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    Partition* p = Current();
+    return p ? p->currentContext : m_globalContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = m_globalEventCount;
+    for (const auto& p : m_partitions)
+    {
+        count += p.eventCount;
+    }
+    return count;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    if (m_global && !m_global->IsEmpty())
+    {
+        return false;
+    }
+    for (const auto& p : m_partitions)
+    {
+        if (!p.events->IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions() const
+{
+    return m_nPartitions;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return TimeStep(m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount() const
+{
+    return m_windowCount;
+}
+
+} // namespace ns3
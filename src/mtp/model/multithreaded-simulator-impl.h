@@ -0,0 +1,275 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/**
+ * @file
+ * @ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <barrier>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @defgroup mtp Multithreaded parallel simulation
+ *
+ * Conservative parallel simulation on the cores of a single host.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup mtp
+ *
+ * @brief Conservative parallel simulator implementation for shared memory.
+ *
+ * The nodes are split into partitions, or logical processes, each with
+ * its own event queue, clock and current context.  The partitions are
+ * given by Node::GetSystemId() when the nodes use more than one system
+ * id, otherwise the nodes are split automatically into groups of
+ * neighbours, one per thread.  Events are assigned to the partition of
+ * the node whose id is their context.
+ *
+ * The simulation advances in windows.  Within a window every partition
+ * executes its events independently, on a pool of worker threads.
+ * A window ends no later than the earliest pending event plus the
+ * lookahead.  The lookahead is the smallest \c Delay attribute of the
+ * channels which connect nodes of different partitions, as in
+ * DistributedSimulatorImpl.  An event scheduled by one partition for a node
+ * of another partition must therefore be at least one lookahead in the
+ * future.  Such events are queued in per-thread mailboxes and handed over
+ * to their destination between windows, without locks.
+ *
+ * Events without a node context, for example those scheduled from
+ * \c main() with Simulator::Schedule(), are global: they run alone,
+ * between windows, with all partitions stopped at their time.  A partition
+ * may only schedule such an event past the end of the current window.
+ *
+ * Simulator::Stop() called from a partition stops that partition after the
+ * current event, and the others at the end of the current window.  With a
+ * delay, it stops the calling partition at that time, and the others at
+ * the end of that window.  Either way, the events executed do not depend
+ * on the thread schedule.
+ *
+ * The models must only share state between partitions through
+ * Simulator::ScheduleWithContext().  PointToPointChannel copies packets
+ * deeply when they cross partitions; Run() aborts if any other channel
+ * connects nodes of different partitions.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     * Register this type.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Default constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // virtual from SimulatorImpl
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the number of partitions of the last run.
+     * @returns The number of partitions.
+     */
+    uint32_t GetNPartitions() const;
+    /**
+     * Get the lookahead of the last run.
+     * @returns The lookahead.
+     */
+    Time GetLookahead() const;
+    /**
+     * Get the number of windows executed so far.
+     * @returns The number of windows.
+     */
+    uint64_t GetWindowCount() const;
+
+  private:
+    void DoDispose() override;
+
+    /** Pending event handed over to another partition. */
+    struct Message
+    {
+        uint64_t ts;      //!< Absolute timestamp.
+        uint32_t context; //!< Event context.
+        EventImpl* event; //!< The event implementation.
+    };
+
+    /** A partition, or logical process. */
+    struct Partition
+    {
+        Ptr<Scheduler> events;                    //!< The event queue.
+        uint64_t currentTs{0};                    //!< Timestamp of the current event.
+        uint32_t currentContext{0};               //!< Context of the current event.
+        uint32_t currentUid{0};                   //!< Unique id of the current event.
+        uint32_t uid{0};                          //!< Next event unique id.
+        uint64_t eventCount{0};                   //!< Number of events executed.
+        int unscheduledEvents{0};                 //!< Number of events in the queue.
+        bool stopped{false};                      //!< Stop() was called from this partition.
+        std::vector<std::vector<Message>> outbox; //!< Events for other partitions.
+    };
+
+    /**
+     * Get the partition executing on the calling thread.
+     * @returns The partition, or \c nullptr outside of a parallel window.
+     */
+    Partition* Current() const;
+    /**
+     * Get the partition of a context.
+     * @param [in] context The context.
+     * @returns The partition index, or m_nPartitions for global events.
+     */
+    uint32_t PartitionOf(uint32_t context) const;
+    /**
+     * Insert an event in a queue.
+     * @param [in] events The queue.
+     * @param [in] uid The counter of unique ids of that queue.
+     * @param [in] ts The absolute timestamp.
+     * @param [in] context The context.
+     * @param [in] event The event implementation.
+     * @returns The event id.
+     */
+    EventId Insert(Scheduler* events,
+                   uint32_t& uid,
+                   uint64_t ts,
+                   uint32_t context,
+                   EventImpl* event);
+    /**
+     * Insert an event, from the main thread between windows.
+     * @param [in] ts The absolute timestamp.
+     * @param [in] context The context.
+     * @param [in] event The event implementation.
+     * @returns The event id.
+     */
+    EventId InsertSerial(uint64_t ts, uint32_t context, EventImpl* event);
+
+    /** Split the nodes into partitions and compute the lookahead. */
+    void BuildPartitions();
+    /**
+     * Body of a worker thread.
+     * @param [in] thread The thread index.
+     */
+    void Work(uint32_t thread);
+    /**
+     * Execute the events of one partition in the current window.
+     * @param [in] index The partition index.
+     */
+    void ProcessPartition(uint32_t index);
+    /**
+     * Move the events sent to one partition during the last window
+     * into its queue.
+     * @param [in] index The partition index.
+     */
+    void DeliverMessages(uint32_t index);
+    /**
+     * Run global events and compute the next window.  Called by one thread
+     * while all the others wait.
+     */
+    void NextWindow();
+
+    /** Completion function of m_syncBarrier. */
+    struct WindowCompletion
+    {
+        MultithreadedSimulatorImpl* impl; //!< The simulator.
+
+        /** Call NextWindow(). */
+        void operator()() noexcept
+        {
+            impl->NextWindow();
+        }
+    };
+
+    /** Default factory for the partition schedulers. */
+    ObjectFactory m_schedulerFactory;
+    /** Events scheduled outside of Run() or without a node context. */
+    Ptr<Scheduler> m_global;
+    /** Counter of unique ids for m_global. */
+    uint32_t m_globalUid;
+    /** Number of events in m_global. */
+    int m_globalUnscheduled;
+    /** Protects m_global and m_destroyEvents while partitions are running. */
+    mutable std::mutex m_globalMutex;
+    /** Timestamp of the current global event, or of the current window start. */
+    uint64_t m_globalTs;
+    /** Context of the current global event. */
+    uint32_t m_globalContext;
+    /** Unique id of the current global event. */
+    uint32_t m_globalCurrentUid;
+    /** Number of global events executed. */
+    uint64_t m_globalEventCount;
+
+    /** The partitions. */
+    std::vector<Partition> m_partitions;
+    /** Number of partitions. */
+    uint32_t m_nPartitions;
+    /** Partition index by node id. */
+    std::vector<uint32_t> m_partitionOf;
+    /** Number of threads, including the main thread. */
+    uint32_t m_nThreads;
+    /** Maximum number of threads, from the attribute. */
+    uint32_t m_maxThreads;
+    /** The lookahead. */
+    uint64_t m_lookahead;
+    /** Exclusive end of the current window. */
+    uint64_t m_windowEnd;
+    /** Number of windows executed. */
+    uint64_t m_windowCount;
+    /** Flag \c true when all threads should leave Run(). */
+    bool m_done;
+    /** Flag set by Stop(). */
+    std::atomic<bool> m_stop;
+    /** The worker threads. */
+    std::vector<std::thread> m_threads;
+    /** Barrier at the end of each window. */
+    std::unique_ptr<std::barrier<>> m_windowBarrier;
+    /** Barrier before each window; its completion computes the window. */
+    std::unique_ptr<std::barrier<WindowCompletion>> m_syncBarrier;
+    /** The partition executing on this thread, if any. */
+    static thread_local Partition* m_current;
+
+    /** The destroy events. */
+    std::list<EventId> m_destroyEvents;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,395 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/global-value.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+/**
+ * @file
+ * @ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * @ingroup mtp
+ * @defgroup mtp-tests Multithreaded simulation tests
+ */
+
+using namespace ns3;
+
+/**
+ * @ingroup mtp-tests
+ *
+ * Connect two nodes with a point-to-point channel, the only kind which may
+ * cross partitions.
+ *
+ * @param [in] a The first node.
+ * @param [in] b The second node.
+ * @param [in] delay The channel delay.
+ */
+static void
+ConnectPointToPoint(Ptr<Node> a, Ptr<Node> b, Time delay)
+{
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(delay));
+    for (auto node : {a, b})
+    {
+        Ptr<PointToPointNetDevice> device = CreateObject<PointToPointNetDevice>();
+        node->AddDevice(device);
+        device->Attach(channel);
+    }
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief Exchange events between two partitions and check their times.
+ *
+ * Four nodes form a line, 0 - 1 - 2 - 3, with a 1 ms point-to-point
+ * channel between nodes 1 and 2 and instantaneous simple channels on the
+ * sides.  Nodes 1 and 2 play ping-pong across the partitions,
+ * while nodes 0 and 3 tick locally; a global event and Simulator::Stop()
+ * are scheduled from the main program.
+ */
+class MtpPingPongTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * @param useSystemId Whether to partition by system id, rather than automatically.
+     * @param maxThreads The maximum number of threads.
+     */
+    MtpPingPongTestCase(bool useSystemId, uint32_t maxThreads);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record a ping-pong event and send the ball to the other side.
+     * @param left The number of hops left.
+     */
+    void Hop(uint32_t left);
+    /**
+     * Record a local event and schedule the next one.
+     */
+    void Tick();
+    /** Record the global event. */
+    void Global();
+
+    bool m_useSystemId;                      //!< Partition by system id.
+    uint32_t m_maxThreads;                   //!< Maximum number of threads.
+    uint32_t m_first;                        //!< Id of the first node.
+    std::vector<std::vector<Time>> m_events; //!< Event times by node.
+    Time m_globalTime;                       //!< Time of the global event.
+    uint32_t m_globalContext;                //!< Context of the global event.
+};
+
+MtpPingPongTestCase::MtpPingPongTestCase(bool useSystemId, uint32_t maxThreads)
+    : TestCase(std::string("Ping-pong, ") + (useSystemId ? "system ids" : "automatic") + ", " +
+               std::to_string(maxThreads) + " threads"),
+      m_useSystemId(useSystemId),
+      m_maxThreads(maxThreads),
+      m_first(0),
+      m_globalContext(0)
+{
+}
+
+void
+MtpPingPongTestCase::Hop(uint32_t left)
+{
+    uint32_t node = Simulator::GetContext() - m_first;
+    m_events[node].push_back(Simulator::Now());
+    if (left > 0)
+    {
+        Simulator::ScheduleWithContext(m_first + 3 - node,
+                                       MilliSeconds(1),
+                                       &MtpPingPongTestCase::Hop,
+                                       this,
+                                       left - 1);
+    }
+}
+
+void
+MtpPingPongTestCase::Tick()
+{
+    m_events[Simulator::GetContext() - m_first].push_back(Simulator::Now());
+    Simulator::Schedule(MicroSeconds(250), &MtpPingPongTestCase::Tick, this);
+}
+
+void
+MtpPingPongTestCase::Global()
+{
+    m_globalTime = Simulator::Now();
+    m_globalContext = Simulator::GetContext();
+}
+
+void
+MtpPingPongTestCase::DoRun()
+{
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Ptr<SimulatorImpl> impl = Simulator::GetImplementation();
+    impl->SetAttribute("MaxThreads", UintegerValue(m_maxThreads));
+
+    NodeContainer nodes;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        nodes.Add(CreateObject<Node>(m_useSystemId ? i / 2 : 0));
+    }
+    for (uint32_t i : {0, 2})
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        for (uint32_t j = i; j < i + 2; ++j)
+        {
+            Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+            device->SetChannel(channel);
+            nodes.Get(j)->AddDevice(device);
+        }
+    }
+    ConnectPointToPoint(nodes.Get(1), nodes.Get(2), MilliSeconds(1));
+
+    m_events.assign(4, {});
+    m_first = nodes.Get(0)->GetId();
+    Simulator::ScheduleWithContext(m_first + 1, Time(0), &MtpPingPongTestCase::Hop, this, 9);
+    Simulator::ScheduleWithContext(m_first, Time(0), &MtpPingPongTestCase::Tick, this);
+    Simulator::ScheduleWithContext(m_first + 3, Time(0), &MtpPingPongTestCase::Tick, this);
+    Simulator::Schedule(MicroSeconds(5100), &MtpPingPongTestCase::Global, this);
+    Simulator::Stop(MicroSeconds(9900));
+    Simulator::Run();
+
+    auto mt = DynamicCast<MultithreadedSimulatorImpl>(impl);
+    NS_TEST_ASSERT_MSG_NE(mt, nullptr, "Wrong simulator implementation");
+    NS_TEST_EXPECT_MSG_EQ(mt->GetNPartitions(), 2, "Wrong number of partitions");
+    NS_TEST_EXPECT_MSG_EQ(mt->GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+
+    // Nodes 1 and 2 alternate every millisecond, ten hops in all
+    NS_TEST_ASSERT_MSG_EQ(m_events[1].size(), 5, "Wrong number of hops on node 1");
+    NS_TEST_ASSERT_MSG_EQ(m_events[2].size(), 5, "Wrong number of hops on node 2");
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_events[1][i], MilliSeconds(2 * i), "Wrong hop time");
+        NS_TEST_EXPECT_MSG_EQ(m_events[2][i], MilliSeconds(2 * i + 1), "Wrong hop time");
+    }
+
+    // Ticks every 250 us until the stop time
+    for (uint32_t node : {0, 3})
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_events[node].size(), 40, "Wrong number of ticks");
+        for (uint32_t i = 0; i < 40; ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_events[node][i], MicroSeconds(250 * i), "Wrong tick time");
+        }
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(m_globalTime, MicroSeconds(5100), "Wrong global event time");
+    NS_TEST_EXPECT_MSG_EQ(m_globalContext, Simulator::NO_CONTEXT, "Wrong global event context");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(9900), "Wrong stop time");
+    NS_TEST_EXPECT_MSG_GT(mt->GetWindowCount(), 9, "Windows longer than the lookahead");
+
+    Simulator::Destroy();
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief Check that events are removed and expire in their own partition.
+ */
+class MtpRemoveTestCase : public TestCase
+{
+  public:
+    MtpRemoveTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count an event which should not be cancelled.
+     */
+    void Count();
+    /**
+     * Schedule an event and remove it, from a partition.
+     */
+    void ScheduleAndRemove();
+
+    uint32_t m_count; //!< Number of events run.
+};
+
+MtpRemoveTestCase::MtpRemoveTestCase()
+    : TestCase("Remove and cancel events"),
+      m_count(0)
+{
+}
+
+void
+MtpRemoveTestCase::Count()
+{
+    m_count++;
+}
+
+void
+MtpRemoveTestCase::ScheduleAndRemove()
+{
+    EventId ev = Simulator::Schedule(MilliSeconds(1), &MtpRemoveTestCase::Count, this);
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(ev), false, "Pending event expired");
+    Simulator::Remove(ev);
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(ev), true, "Removed event not expired");
+}
+
+void
+MtpRemoveTestCase::DoRun()
+{
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Ptr<SimulatorImpl> impl = Simulator::GetImplementation();
+    impl->SetAttribute("MaxThreads", UintegerValue(2));
+
+    NodeContainer nodes;
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(1));
+    uint32_t first = nodes.Get(0)->GetId();
+
+    Simulator::ScheduleWithContext(first, MilliSeconds(1), &MtpRemoveTestCase::Count, this);
+    Simulator::ScheduleWithContext(first + 1,
+                                   MilliSeconds(1),
+                                   &MtpRemoveTestCase::ScheduleAndRemove,
+                                   this);
+    EventId cancelled = Simulator::Schedule(MilliSeconds(2), &MtpRemoveTestCase::Count, this);
+    Simulator::Cancel(cancelled);
+    EventId kept = Simulator::Schedule(MilliSeconds(3), &MtpRemoveTestCase::Count, this);
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_count, 2, "Wrong number of events run");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(kept), true, "Event not expired");
+    // Including the initialization of the two nodes and the cancelled event
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetEventCount(), 6, "Wrong event count");
+
+    Simulator::Destroy();
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief Check that a stop from a partition does not depend on the threads.
+ *
+ * Two nodes in different partitions, 1 ms apart, tick every 100 us.  Node 1
+ * stops the simulation at 2.5 ms, either from its tick at that time or with
+ * a delay from an earlier tick.  Node 1 must stop right there and node 0 at
+ * the end of the window, 3 ms, with one thread or two.
+ */
+class MtpStopTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * @param [in] delayed Whether to stop with a delay rather than immediately.
+     * @param [in] maxThreads The maximum number of threads.
+     */
+    MtpStopTestCase(bool delayed, uint32_t maxThreads);
+
+  private:
+    void DoRun() override;
+
+    /** Record a tick, stop if it is time, and schedule the next one. */
+    void Tick();
+
+    bool m_delayed;                          //!< Stop with a delay.
+    uint32_t m_maxThreads;                   //!< Maximum number of threads.
+    uint32_t m_first;                        //!< Id of the first node.
+    std::vector<std::vector<Time>> m_events; //!< Tick times by node.
+};
+
+MtpStopTestCase::MtpStopTestCase(bool delayed, uint32_t maxThreads)
+    : TestCase(std::string("Stop from a partition, ") + (delayed ? "delayed" : "immediate") +
+               ", " + std::to_string(maxThreads) + " threads"),
+      m_delayed(delayed),
+      m_maxThreads(maxThreads),
+      m_first(0)
+{
+}
+
+void
+MtpStopTestCase::Tick()
+{
+    uint32_t node = Simulator::GetContext() - m_first;
+    Time now = Simulator::Now();
+    m_events[node].push_back(now);
+    if (node == 1 && !m_delayed && now == MicroSeconds(2500))
+    {
+        Simulator::Stop();
+    }
+    if (node == 1 && m_delayed && now == MicroSeconds(500))
+    {
+        Simulator::Stop(MicroSeconds(2050));
+    }
+    Simulator::Schedule(MicroSeconds(100), &MtpStopTestCase::Tick, this);
+}
+
+void
+MtpStopTestCase::DoRun()
+{
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Ptr<SimulatorImpl> impl = Simulator::GetImplementation();
+    impl->SetAttribute("MaxThreads", UintegerValue(m_maxThreads));
+
+    NodeContainer nodes;
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(1));
+    ConnectPointToPoint(nodes.Get(0), nodes.Get(1), MilliSeconds(1));
+
+    m_events.assign(2, {});
+    m_first = nodes.Get(0)->GetId();
+    Simulator::ScheduleWithContext(m_first, Time(0), &MtpStopTestCase::Tick, this);
+    Simulator::ScheduleWithContext(m_first + 1, Time(0), &MtpStopTestCase::Tick, this);
+    Simulator::Run();
+
+    // Node 1 ticks up to 2.5 ms included, node 0 until the window ends
+    NS_TEST_EXPECT_MSG_EQ(m_events[1].size(), 26, "Node 1 did not stop at its stop time");
+    NS_TEST_EXPECT_MSG_EQ(m_events[1].back(), MicroSeconds(2500), "Wrong last tick on node 1");
+    NS_TEST_EXPECT_MSG_EQ(m_events[0].size(), 30, "Node 0 did not stop at the window end");
+    NS_TEST_EXPECT_MSG_EQ(m_events[0].back(), MicroSeconds(2900), "Wrong last tick on node 0");
+
+    Simulator::Destroy();
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief MultithreadedSimulatorImpl test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", Type::UNIT)
+{
+    AddTestCase(new MtpPingPongTestCase(true, 2), TestCase::Duration::QUICK);
+    AddTestCase(new MtpPingPongTestCase(false, 2), TestCase::Duration::QUICK);
+    AddTestCase(new MtpPingPongTestCase(true, 1), TestCase::Duration::QUICK);
+    AddTestCase(new MtpRemoveTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new MtpStopTestCase(false, 1), TestCase::Duration::QUICK);
+    AddTestCase(new MtpStopTestCase(false, 2), TestCase::Duration::QUICK);
+    AddTestCase(new MtpStopTestCase(true, 1), TestCase::Duration::QUICK);
+    AddTestCase(new MtpStopTestCase(true, 2), TestCase::Duration::QUICK);
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,298 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "packet-memory-pool.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <mutex>
+#include <new>
+
+/**
+ * @file
+ * @ingroup packet
+ * ns3::PacketMemoryPool implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PacketMemoryPool");
+
+namespace
+{
+
+/** Granularity of the small size classes, in bytes. */
+constexpr std::size_t PACKET_POOL_GRANULE = 16;
+/** Number of small size classes. */
+constexpr std::size_t PACKET_POOL_SMALL_CLASSES = 16;
+/** Largest size of the small size classes. */
+constexpr std::size_t PACKET_POOL_SMALL_MAX = PACKET_POOL_GRANULE * PACKET_POOL_SMALL_CLASSES;
+/** Number of large size classes per power of two. */
+constexpr std::size_t PACKET_POOL_STEPS = 4;
+/** Largest block size served by the pools. */
+constexpr std::size_t PACKET_POOL_MAX = 64 * 1024;
+/** Total number of size classes. */
+constexpr std::size_t PACKET_POOL_CLASSES =
+    PACKET_POOL_SMALL_CLASSES +
+    PACKET_POOL_STEPS * (std::bit_width(PACKET_POOL_MAX) - std::bit_width(PACKET_POOL_SMALL_MAX));
+/** Smallest size of the chunks carved into blocks, in bytes. */
+constexpr std::size_t PACKET_POOL_CHUNK = 64 * 1024;
+/** Smallest number of blocks in a chunk. */
+constexpr std::size_t PACKET_POOL_CHUNK_BLOCKS = 4;
+
+/**
+ * Get the size class of a size.
+ * @param [in] size The size, at least 1.
+ * @returns The size class, or PACKET_POOL_CLASSES if \p size is too large.
+ */
+std::size_t
+ClassOf(std::size_t size)
+{
+    if (size <= PACKET_POOL_SMALL_MAX)
+    {
+        return (size - 1) / PACKET_POOL_GRANULE;
+    }
+    if (size > PACKET_POOL_MAX)
+    {
+        return PACKET_POOL_CLASSES;
+    }
+    // size is in (2^p, 2^(p+1)], which is split into PACKET_POOL_STEPS classes
+    std::size_t p = std::bit_width(size - 1) - 1;
+    std::size_t base = std::size_t(1) << p;
+    std::size_t step = base / PACKET_POOL_STEPS;
+    std::size_t sub = (size - base - 1) / step;
+    return PACKET_POOL_SMALL_CLASSES +
+           (p + 1 - std::bit_width(PACKET_POOL_SMALL_MAX)) * PACKET_POOL_STEPS + sub;
+}
+
+/**
+ * Get the block size of a size class.
+ * @param [in] cls The size class.
+ * @returns The size of its blocks.
+ */
+std::size_t
+BlockSizeOf(std::size_t cls)
+{
+    if (cls < PACKET_POOL_SMALL_CLASSES)
+    {
+        return (cls + 1) * PACKET_POOL_GRANULE;
+    }
+    std::size_t large = cls - PACKET_POOL_SMALL_CLASSES;
+    std::size_t base = PACKET_POOL_SMALL_MAX << (large / PACKET_POOL_STEPS);
+    return base + (large % PACKET_POOL_STEPS + 1) * (base / PACKET_POOL_STEPS);
+}
+
+/** A free block, linked into the free list of its size class. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< The next free block.
+};
+
+/** Free lists, indexed by size class. */
+typedef std::array<FreeBlock*, PACKET_POOL_CLASSES> FreeLists;
+
+/**
+ * State shared by all threads: the free blocks and statistics of threads
+ * which have exited.
+ */
+struct PacketPoolShared
+{
+    std::mutex mutex;                //!< Protects the other members.
+    FreeLists orphans{};             //!< Free blocks left by exited threads.
+    PacketMemoryPool::Stats stats{}; //!< Statistics of exited threads.
+};
+
+/**
+ * Get the shared pool state.
+ * @returns The shared state, which is never destroyed.
+ */
+PacketPoolShared&
+GetPacketPoolShared()
+{
+    static auto shared = new PacketPoolShared;
+    return *shared;
+}
+
+/**
+ * Flag \c true once the pool of this thread has been destroyed, which
+ * happens before static destruction on the main thread.
+ */
+thread_local bool g_packetPoolDead = false;
+
+/** Per-thread packet memory pool. */
+class PacketPool
+{
+  public:
+    ~PacketPool()
+    {
+        g_packetPoolDead = true;
+        auto& shared = GetPacketPoolShared();
+        std::unique_lock lock{shared.mutex};
+        for (std::size_t i = 0; i < PACKET_POOL_CLASSES; ++i)
+        {
+            while (m_free[i] != nullptr)
+            {
+                FreeBlock* b = m_free[i];
+                m_free[i] = b->next;
+                b->next = shared.orphans[i];
+                shared.orphans[i] = b;
+            }
+        }
+        shared.stats.allocations += m_stats.allocations;
+        shared.stats.hits += m_stats.hits;
+        shared.stats.oversize += m_stats.oversize;
+        shared.stats.chunkBytes += m_stats.chunkBytes;
+    }
+
+    /**
+     * Allocate a block.
+     * @param [in] size The requested size.
+     * @returns The block.
+     */
+    void* Allocate(std::size_t size)
+    {
+        ++m_stats.allocations;
+        std::size_t cls = ClassOf(size);
+        if (cls >= PACKET_POOL_CLASSES)
+        {
+            ++m_stats.oversize;
+            return ::operator new(size);
+        }
+        FreeBlock* b = m_free[cls];
+        if (b != nullptr)
+        {
+            ++m_stats.hits;
+            m_free[cls] = b->next;
+            return b;
+        }
+        return Refill(cls);
+    }
+
+    /**
+     * Free a block.
+     * @param [in] p The block.
+     * @param [in] cls The size class it was allocated from.
+     */
+    void Deallocate(void* p, std::size_t cls)
+    {
+        auto b = static_cast<FreeBlock*>(p);
+        b->next = m_free[cls];
+        m_free[cls] = b;
+    }
+
+    PacketMemoryPool::Stats m_stats{}; //!< Statistics of this thread.
+
+  private:
+    /**
+     * Refill an empty free list, from orphaned blocks if there are any,
+     * otherwise from a new chunk.
+     * @param [in] cls The size class.
+     * @returns A block of size class \p cls.
+     */
+    void* Refill(std::size_t cls)
+    {
+        auto& shared = GetPacketPoolShared();
+        {
+            std::unique_lock lock{shared.mutex};
+            if (shared.orphans[cls] != nullptr)
+            {
+                m_free[cls] = shared.orphans[cls];
+                shared.orphans[cls] = nullptr;
+            }
+        }
+        if (m_free[cls] == nullptr)
+        {
+            std::size_t blockSize = BlockSizeOf(cls);
+            std::size_t chunkSize =
+                std::max(PACKET_POOL_CHUNK, PACKET_POOL_CHUNK_BLOCKS * blockSize);
+            NS_LOG_LOGIC("new chunk of " << chunkSize << " bytes for blocks of " << blockSize);
+            auto chunk = static_cast<char*>(::operator new(chunkSize));
+            m_stats.chunkBytes += chunkSize;
+            for (std::size_t off = 0; off + blockSize <= chunkSize; off += blockSize)
+            {
+                auto b = reinterpret_cast<FreeBlock*>(chunk + off);
+                b->next = m_free[cls];
+                m_free[cls] = b;
+            }
+        }
+        FreeBlock* b = m_free[cls];
+        m_free[cls] = b->next;
+        return b;
+    }
+
+    FreeLists m_free{}; //!< Free lists of this thread.
+};
+
+/** The pool of this thread. */
+thread_local PacketPool g_packetPool;
+
+} // unnamed namespace
+
+void*
+PacketMemoryPool::Allocate(std::size_t size)
+{
+    size = std::max<std::size_t>(size, 1);
+    if (g_packetPoolDead)
+    {
+        // Round up, since the block may end up recycled in its size class
+        return ::operator new(GetBlockSize(size));
+    }
+    return g_packetPool.Allocate(size);
+}
+
+void
+PacketMemoryPool::Deallocate(void* p, std::size_t size)
+{
+    std::size_t cls = ClassOf(std::max<std::size_t>(size, 1));
+    if (cls >= PACKET_POOL_CLASSES)
+    {
+        ::operator delete(p);
+        return;
+    }
+    if (g_packetPoolDead)
+    {
+        auto& shared = GetPacketPoolShared();
+        std::unique_lock lock{shared.mutex};
+        auto b = static_cast<FreeBlock*>(p);
+        b->next = shared.orphans[cls];
+        shared.orphans[cls] = b;
+        return;
+    }
+    g_packetPool.Deallocate(p, cls);
+}
+
+std::size_t
+PacketMemoryPool::GetBlockSize(std::size_t size)
+{
+    std::size_t cls = ClassOf(std::max<std::size_t>(size, 1));
+    return cls < PACKET_POOL_CLASSES ? BlockSizeOf(cls) : size;
+}
+
+PacketMemoryPool::Stats
+PacketMemoryPool::GetStats()
+{
+    Stats stats = g_packetPool.m_stats;
+    auto& shared = GetPacketPoolShared();
+    std::unique_lock lock{shared.mutex};
+    stats.allocations += shared.stats.allocations;
+    stats.hits += shared.stats.hits;
+    stats.oversize += shared.stats.oversize;
+    stats.chunkBytes += shared.stats.chunkBytes;
+    return stats;
+}
+
+void
+PacketMemoryPool::ResetStats()
+{
+    g_packetPool.m_stats = {};
+    auto& shared = GetPacketPoolShared();
+    std::unique_lock lock{shared.mutex};
+    shared.stats = {};
+}
+
+} // namespace ns3
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PACKET_MEMORY_POOL_H
+#define PACKET_MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file
+ * @ingroup packet
+ * ns3::PacketMemoryPool declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup packet
+ *
+ * @brief Per-thread memory pool for packets and their data.
+ *
+ * Packet objects, Buffer data, PacketMetadata data, ByteTagList data and
+ * PacketTagList nodes are all served by this pool.  Blocks are grouped in
+ * size classes: 16 bytes apart up to 256 bytes, which covers the packet
+ * objects, tags and metadata, then four classes per power of two up to
+ * 64 KiB, which covers the buffer data.  Each class has a free list per
+ * thread, carved from chunks of at least 64 KiB.  Freed blocks go back to
+ * the free list of the thread which frees them, and the free blocks of an
+ * exited thread are handed over to the other threads.  Chunks are never
+ * returned to the heap, so that packets freed late, for example during
+ * static destruction, stay valid.
+ *
+ * Once the free lists hold enough blocks for the packets alive at the
+ * same time, creating, modifying and destroying packets makes no call to
+ * the global allocator.
+ */
+class PacketMemoryPool
+{
+  public:
+    /** Statistics of the pool. */
+    struct Stats
+    {
+        uint64_t allocations; //!< Number of allocations.
+        uint64_t hits;        //!< Allocations served by recycling a freed block.
+        uint64_t oversize;    //!< Allocations too large for the pools.
+        uint64_t chunkBytes;  //!< Bytes obtained from the heap for pool chunks.
+    };
+
+    /**
+     * Allocate a block from the pool of the calling thread.
+     *
+     * @param [in] size The requested size.
+     * @returns The block, of at least GetBlockSize(size) bytes.
+     */
+    static void* Allocate(std::size_t size);
+    /**
+     * Return a block to the pool of the calling thread.
+     *
+     * @param [in] p The block.
+     * @param [in] size The size it was allocated with, or any size up to
+     *             GetBlockSize() of that size.
+     */
+    static void Deallocate(void* p, std::size_t size);
+    /**
+     * Get the usable size of the blocks allocated for a size.
+     *
+     * @param [in] size The requested size.
+     * @returns The size of the blocks of the size class of \p size, or
+     *          \p size if it is too large for the pools.
+     */
+    static std::size_t GetBlockSize(std::size_t size);
+
+    /**
+     * Get the statistics, for the calling thread and all threads which
+     * have exited, since the last ResetStats().
+     *
+     * @returns The statistics.
+     */
+    static Stats GetStats();
+    /** Reset the statistics. */
+    static void ResetStats();
+};
+
+} // namespace ns3
+
+#endif /* PACKET_MEMORY_POOL_H */
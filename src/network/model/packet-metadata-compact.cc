@@ -0,0 +1,488 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// The compact and disabled implementations of PacketMetadata, selected
+// by the NS3_PACKET_METADATA build option; the full one is in
+// packet-metadata.cc
+
+#include "packet-metadata.h"
+
+#include "buffer.h"
+#include "header.h"
+#include "trailer.h"
+
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+#if defined(NS3_PACKET_METADATA_COMPACT) || defined(NS3_PACKET_METADATA_DISABLE)
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PacketMetadata");
+
+#if defined(NS3_PACKET_METADATA_DISABLE)
+
+PacketMetadata::ItemIterator
+PacketMetadata::BeginItem(Buffer buffer) const
+{
+    return ItemIterator(this, buffer);
+}
+
+PacketMetadata::ItemIterator::ItemIterator(const PacketMetadata* metadata, Buffer buffer)
+    : m_metadata(metadata),
+      m_buffer(buffer),
+      m_current(0),
+      m_offset(0)
+{
+}
+
+bool
+PacketMetadata::ItemIterator::HasNext() const
+{
+    return false;
+}
+
+PacketMetadata::Item
+PacketMetadata::ItemIterator::Next()
+{
+    NS_FATAL_ERROR("ns-3 was built without packet metadata");
+    return {};
+}
+
+uint32_t
+PacketMetadata::GetSerializedSize() const
+{
+    // the packet uid
+    return 8;
+}
+
+uint32_t
+PacketMetadata::Serialize(uint8_t* buffer, uint32_t maxSize) const
+{
+    NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (maxSize < 8)
+    {
+        return 0;
+    }
+    memcpy(buffer, &m_packetUid, 8);
+    return 1;
+}
+
+uint32_t
+PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &buffer << size);
+    // size includes the 4 bytes of the length written by the packet
+    if (size < 4 + 8)
+    {
+        return 0;
+    }
+    memcpy(&m_packetUid, buffer, 8);
+    // the full metadata of another build cannot be read back
+    return size == 4 + 8 ? 1 : 0;
+}
+
+#else
+
+bool PacketMetadata::m_enable = false;
+bool PacketMetadata::m_enableChecking = false;
+bool PacketMetadata::m_metadataSkipped = false;
+
+void
+PacketMetadata::Enable()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    NS_ASSERT_MSG(!m_metadataSkipped,
+                  "Error: attempting to enable the packet metadata "
+                  "subsystem too late in the simulation, which is not allowed.\n"
+                  "A common cause for this problem is to enable ASCII tracing "
+                  "after sending any packets.  One way to fix this problem is "
+                  "to call ns3::PacketMetadata::Enable () near the beginning of"
+                  " the program, before any packets are sent.");
+    m_enable = true;
+}
+
+void
+PacketMetadata::EnableChecking()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    Enable();
+    m_enableChecking = true;
+}
+
+void
+PacketMetadata::Insert(uint8_t index, const CompactItem& item)
+{
+    NS_ASSERT(index <= m_count);
+    if (m_count == COMPACT_ITEMS)
+    {
+        // Merge the two items in the middle, which are the least likely
+        // to be printed with their own type, into payload
+        uint8_t merged = m_count / 2 - 1;
+        m_items[merged] = {0,
+                           PacketMetadata::Item::PAYLOAD,
+                           false,
+                           m_items[merged].size + m_items[merged + 1].size,
+                           0};
+        Erase(merged + 1, 1);
+        if (index > merged + 1)
+        {
+            index--;
+        }
+    }
+    std::memmove(&m_items[index + 1], &m_items[index], (m_count - index) * sizeof(CompactItem));
+    m_items[index] = item;
+    m_count++;
+}
+
+void
+PacketMetadata::Erase(uint8_t index, uint8_t n)
+{
+    NS_ASSERT(index + n <= m_count);
+    std::memmove(&m_items[index],
+                 &m_items[index + n],
+                 (m_count - index - n) * sizeof(CompactItem));
+    m_count -= n;
+}
+
+void
+PacketMetadata::AddHeader(const Header& header, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &header << size);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    Insert(0, {header.GetInstanceTypeId().GetUid(), PacketMetadata::Item::HEADER, false, size, 0});
+}
+
+void
+PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &header << size);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    if (m_count > 0 && m_items[0].type == PacketMetadata::Item::HEADER &&
+        m_items[0].tid == header.GetInstanceTypeId().GetUid() && m_items[0].size == size &&
+        !m_items[0].isFragment)
+    {
+        Erase(0, 1);
+        return;
+    }
+    if (m_enableChecking)
+    {
+        NS_FATAL_ERROR("Removing unexpected header.");
+    }
+    RemoveAtStart(size);
+}
+
+void
+PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &trailer << size);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    Insert(m_count,
+           {trailer.GetInstanceTypeId().GetUid(), PacketMetadata::Item::TRAILER, false, size, 0});
+}
+
+void
+PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &trailer << size);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    if (m_count > 0)
+    {
+        const CompactItem& last = m_items[m_count - 1];
+        if (last.type == PacketMetadata::Item::TRAILER &&
+            last.tid == trailer.GetInstanceTypeId().GetUid() && last.size == size &&
+            !last.isFragment)
+        {
+            m_count--;
+            return;
+        }
+    }
+    if (m_enableChecking)
+    {
+        NS_FATAL_ERROR("Removing unexpected trailer.");
+    }
+    RemoveAtEnd(size);
+}
+
+PacketMetadata
+PacketMetadata::CreateFragment(uint32_t start, uint32_t end) const
+{
+    NS_LOG_FUNCTION(this << start << end);
+    PacketMetadata fragment = *this;
+    fragment.RemoveAtStart(start);
+    fragment.RemoveAtEnd(end);
+    return fragment;
+}
+
+void
+PacketMetadata::AddAtEnd(const PacketMetadata& o)
+{
+    NS_LOG_FUNCTION(this << &o);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    for (uint8_t i = 0; i < o.m_count; ++i)
+    {
+        Insert(m_count, o.m_items[i]);
+    }
+}
+
+void
+PacketMetadata::AddPaddingAtEnd(uint32_t end)
+{
+    NS_LOG_FUNCTION(this << end);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    Insert(m_count, {0, PacketMetadata::Item::PAYLOAD, false, end, 0});
+}
+
+void
+PacketMetadata::RemoveAtStart(uint32_t start)
+{
+    NS_LOG_FUNCTION(this << start);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    uint8_t removed = 0;
+    while (start > 0 && removed < m_count)
+    {
+        CompactItem& item = m_items[removed];
+        if (item.size <= start)
+        {
+            start -= item.size;
+            removed++;
+        }
+        else
+        {
+            item.size -= start;
+            item.trimmedFromStart += start;
+            item.isFragment = true;
+            start = 0;
+        }
+    }
+    Erase(0, removed);
+}
+
+void
+PacketMetadata::RemoveAtEnd(uint32_t end)
+{
+    NS_LOG_FUNCTION(this << end);
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return;
+    }
+    while (end > 0 && m_count > 0)
+    {
+        CompactItem& item = m_items[m_count - 1];
+        if (item.size <= end)
+        {
+            end -= item.size;
+            m_count--;
+        }
+        else
+        {
+            item.size -= end;
+            item.isFragment = true;
+            end = 0;
+        }
+    }
+}
+
+PacketMetadata::ItemIterator
+PacketMetadata::BeginItem(Buffer buffer) const
+{
+    NS_LOG_FUNCTION(this << &buffer);
+    return ItemIterator(this, buffer);
+}
+
+PacketMetadata::ItemIterator::ItemIterator(const PacketMetadata* metadata, Buffer buffer)
+    : m_metadata(metadata),
+      m_buffer(buffer),
+      m_current(0),
+      m_offset(0)
+{
+    NS_LOG_FUNCTION(this << metadata << &buffer);
+}
+
+bool
+PacketMetadata::ItemIterator::HasNext() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_current < m_metadata->m_count;
+}
+
+PacketMetadata::Item
+PacketMetadata::ItemIterator::Next()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(HasNext());
+    const CompactItem& compact = m_metadata->m_items[m_current++];
+    PacketMetadata::Item item;
+    item.type = static_cast<PacketMetadata::Item::ItemType>(compact.type);
+    item.isFragment = compact.isFragment;
+    item.tid.SetUid(compact.tid);
+    item.currentSize = compact.size;
+    item.currentTrimmedFromStart = compact.trimmedFromStart;
+    item.currentTrimmedFromEnd = 0;
+    if (!item.isFragment)
+    {
+        if (item.type == PacketMetadata::Item::HEADER)
+        {
+            item.current = m_buffer.Begin();
+            item.current.Next(m_offset);
+        }
+        else if (item.type == PacketMetadata::Item::TRAILER)
+        {
+            item.current = m_buffer.End();
+            item.current.Prev(m_buffer.GetSize() - (m_offset + compact.size));
+        }
+    }
+    m_offset += compact.size;
+    return item;
+}
+
+uint32_t
+PacketMetadata::GetSerializedSize() const
+{
+    NS_LOG_FUNCTION(this);
+    // the packet uid
+    uint32_t totalSize = 8;
+    if (!m_enable)
+    {
+        return totalSize;
+    }
+    for (uint8_t i = 0; i < m_count; ++i)
+    {
+        // the TypeId name with its length, the type, the fragment flag,
+        // the size and the bytes trimmed from the start
+        totalSize += 4 + 1 + 1 + 4 + 4;
+        if (m_items[i].tid != 0)
+        {
+            TypeId tid;
+            tid.SetUid(m_items[i].tid);
+            totalSize += tid.GetName().size();
+        }
+    }
+    return totalSize;
+}
+
+uint32_t
+PacketMetadata::Serialize(uint8_t* buffer, uint32_t maxSize) const
+{
+    NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (GetSerializedSize() > maxSize)
+    {
+        return 0;
+    }
+    memcpy(buffer, &m_packetUid, 8);
+    buffer += 8;
+    if (!m_enable)
+    {
+        return 1;
+    }
+    for (uint8_t i = 0; i < m_count; ++i)
+    {
+        const CompactItem& item = m_items[i];
+        // TypeIds are written by name, since their uids depend on the
+        // order in which a process registers them
+        std::string name;
+        if (item.tid != 0)
+        {
+            TypeId tid;
+            tid.SetUid(item.tid);
+            name = tid.GetName();
+        }
+        uint32_t nameSize = name.size();
+        memcpy(buffer, &nameSize, 4);
+        buffer += 4;
+        memcpy(buffer, name.data(), nameSize);
+        buffer += nameSize;
+        *buffer++ = item.type;
+        *buffer++ = item.isFragment ? 1 : 0;
+        memcpy(buffer, &item.size, 4);
+        buffer += 4;
+        memcpy(buffer, &item.trimmedFromStart, 4);
+        buffer += 4;
+    }
+    return 1;
+}
+
+uint32_t
+PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &buffer << size);
+    // size includes the 4 bytes of the length written by the packet
+    if (size < 4 + 8)
+    {
+        return 0;
+    }
+    const uint8_t* end = buffer + size - 4;
+    memcpy(&m_packetUid, buffer, 8);
+    buffer += 8;
+    m_count = 0;
+    while (buffer < end)
+    {
+        CompactItem item;
+        uint32_t nameSize;
+        if (end - buffer < 4)
+        {
+            return 0;
+        }
+        memcpy(&nameSize, buffer, 4);
+        buffer += 4;
+        if (static_cast<uint32_t>(end - buffer) < nameSize + 1 + 1 + 4 + 4)
+        {
+            return 0;
+        }
+        item.tid = 0;
+        if (nameSize > 0)
+        {
+            std::string name(reinterpret_cast<const char*>(buffer), nameSize);
+            item.tid = TypeId::LookupByName(name).GetUid();
+            buffer += nameSize;
+        }
+        item.type = *buffer++;
+        item.isFragment = *buffer++ != 0;
+        memcpy(&item.size, buffer, 4);
+        buffer += 4;
+        memcpy(&item.trimmedFromStart, buffer, 4);
+        buffer += 4;
+        Insert(m_count, item);
+    }
+    return 1;
+}
+
+#endif
+
+} // namespace ns3
+
+#endif
@@ -14,10 +14,15 @@
 #include "ns3/callback.h"
 #include "ns3/type-id.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdint.h>
 #include <vector>
 
+#if defined(NS3_PACKET_METADATA_COMPACT) && defined(NS3_PACKET_METADATA_DISABLE)
+#error "NS3_PACKET_METADATA_COMPACT and NS3_PACKET_METADATA_DISABLE are exclusive"
+#endif
+
 namespace ns3
 {
 
@@ -65,6 +70,19 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * The NS3_PACKET_METADATA build option selects one of three
+ * implementations of this class:
+ *   - \c full, the default, is the linked list described above.
+ *   - \c compact records only the type and size of the headers, trailers
+ *     and payload of a packet, in a fixed array stored inside the packet
+ *     (NS3_PACKET_METADATA_COMPACT).  Packets print as with \c full, but
+ *     fragmented areas lose their trimmed end, the packets which carried
+ *     them are not recorded, and once the array is full the two items in
+ *     the middle of the packet are merged into payload.
+ *   - \c off compiles the metadata out (NS3_PACKET_METADATA_DISABLE):
+ *     Enable() has no effect, packets print nothing, and adding and
+ *     removing headers costs nothing beyond the buffer operation.
  */
 class PacketMetadata
 {
@@ -147,7 +165,9 @@ class PacketMetadata
         Buffer m_buffer;                  //!< buffer the metadata refers to
         uint16_t m_current;               //!< current position
         uint32_t m_offset;                //!< offset
-        bool m_hasReadTail;               //!< true if the metadata tail has been read
+#if !defined(NS3_PACKET_METADATA_COMPACT) && !defined(NS3_PACKET_METADATA_DISABLE)
+        bool m_hasReadTail; //!< true if the metadata tail has been read
+#endif
     };
 
     /**
@@ -275,6 +295,54 @@ class PacketMetadata
     uint32_t Deserialize(const uint8_t* buffer, uint32_t size);
 
   private:
+#if defined(NS3_PACKET_METADATA_DISABLE)
+    uint64_t m_packetUid; //!< packet Uid
+#elif defined(NS3_PACKET_METADATA_COMPACT)
+    /// Number of items recorded in each packet
+    static constexpr uint8_t COMPACT_ITEMS = 8;
+
+    /**
+     * @brief A header, trailer or payload area of the compact metadata
+     */
+    struct CompactItem
+    {
+        uint16_t tid;              //!< TypeId uid of the header or trailer, 0 for payload
+        uint8_t type;              //!< the Item::ItemType of the area
+        bool isFragment;           //!< true if bytes were removed from the area
+        uint32_t size;             //!< current size of the area
+        uint32_t trimmedFromStart; //!< bytes removed from the start of the area
+    };
+
+    /// Friend class
+    friend class ItemIterator;
+
+    /**
+     * @brief Insert an item, merging the two items in the middle of the
+     * packet into payload if the array is full
+     * @param index the position of the new item
+     * @param item the item to insert
+     */
+    void Insert(uint8_t index, const CompactItem& item);
+    /**
+     * @brief Remove items
+     * @param index the position of the first item to remove
+     * @param n the number of items to remove
+     */
+    void Erase(uint8_t index, uint8_t n);
+
+    static bool m_enable;         //!< Enable the packet metadata
+    static bool m_enableChecking; //!< Enable the packet metadata checking
+    /**
+     * Set to true when adding metadata to a packet is skipped because
+     * m_enable is false; used to detect enabling of metadata in the
+     * middle of a simulation, which isn't allowed.
+     */
+    static bool m_metadataSkipped;
+
+    uint64_t m_packetUid;                //!< packet Uid
+    uint8_t m_count;                     //!< number of items in use
+    CompactItem m_items[COMPACT_ITEMS]; //!< the items, from the start of the packet
+#else
     /**
      * @brief Helper for the raw serialization.
      *
@@ -498,16 +566,6 @@ class PacketMetadata
         uint64_t packetUid;
     };
 
-    /**
-     * @brief Class to hold all the metadata
-     */
-    class DataFreeList : public std::vector<Data*>
-    {
-      public:
-        ~DataFreeList();
-    };
-
-    friend DataFreeList::~DataFreeList();
     /// Friend class
     friend class ItemIterator;
 
@@ -664,9 +722,8 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+    static bool m_enable;         //!< Enable the packet metadata
+    static bool m_enableChecking; //!< Enable the packet metadata checking
 
     /**
      * Set to true when adding metadata to a packet is skipped because
@@ -688,6 +745,7 @@ class PacketMetadata
     uint16_t m_tail;      //!< list tail
     uint32_t m_used;      //!< used portion
     uint64_t m_packetUid; //!< packet Uid
+#endif
 };
 
 } // namespace ns3
@@ -695,6 +753,122 @@ class PacketMetadata
 namespace ns3
 {
 
+#if defined(NS3_PACKET_METADATA_DISABLE)
+
+inline void
+PacketMetadata::Enable()
+{
+}
+
+inline void
+PacketMetadata::EnableChecking()
+{
+}
+
+PacketMetadata::PacketMetadata(uint64_t uid, uint32_t /* size */)
+    : m_packetUid(uid)
+{
+}
+
+PacketMetadata::PacketMetadata(const PacketMetadata& o) = default;
+
+PacketMetadata& PacketMetadata::operator=(const PacketMetadata& o) = default;
+
+PacketMetadata::~PacketMetadata() = default;
+
+inline void
+PacketMetadata::AddHeader(const Header& /* header */, uint32_t /* size */)
+{
+}
+
+inline void
+PacketMetadata::RemoveHeader(const Header& /* header */, uint32_t /* size */)
+{
+}
+
+inline void
+PacketMetadata::AddTrailer(const Trailer& /* trailer */, uint32_t /* size */)
+{
+}
+
+inline void
+PacketMetadata::RemoveTrailer(const Trailer& /* trailer */, uint32_t /* size */)
+{
+}
+
+inline PacketMetadata
+PacketMetadata::CreateFragment(uint32_t /* start */, uint32_t /* end */) const
+{
+    return *this;
+}
+
+inline void
+PacketMetadata::AddAtEnd(const PacketMetadata& /* o */)
+{
+}
+
+inline void
+PacketMetadata::AddPaddingAtEnd(uint32_t /* end */)
+{
+}
+
+inline void
+PacketMetadata::RemoveAtStart(uint32_t /* start */)
+{
+}
+
+inline void
+PacketMetadata::RemoveAtEnd(uint32_t /* end */)
+{
+}
+
+inline uint64_t
+PacketMetadata::GetUid() const
+{
+    return m_packetUid;
+}
+
+#elif defined(NS3_PACKET_METADATA_COMPACT)
+
+PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
+    : m_packetUid(uid),
+      m_count(0)
+{
+    if (size > 0)
+    {
+        AddPaddingAtEnd(size);
+    }
+}
+
+PacketMetadata::PacketMetadata(const PacketMetadata& o)
+    : m_packetUid(o.m_packetUid),
+      m_count(o.m_count)
+{
+    std::copy(o.m_items, o.m_items + o.m_count, m_items);
+}
+
+PacketMetadata&
+PacketMetadata::operator=(const PacketMetadata& o)
+{
+    if (this != &o)
+    {
+        m_packetUid = o.m_packetUid;
+        m_count = o.m_count;
+        std::copy(o.m_items, o.m_items + o.m_count, m_items);
+    }
+    return *this;
+}
+
+PacketMetadata::~PacketMetadata() = default;
+
+inline uint64_t
+PacketMetadata::GetUid() const
+{
+    return m_packetUid;
+}
+
+#else
+
 PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
     : m_data(PacketMetadata::Create(10)),
       m_head(0xffff),
@@ -754,6 +928,8 @@ PacketMetadata::~PacketMetadata()
     }
 }
 
+#endif
+
 } // namespace ns3
 
 #endif /* PACKET_METADATA_H */
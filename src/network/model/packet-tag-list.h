@@ -13,6 +13,8 @@
 \brief  Defines a linked list of Packet tags, including copy-on-write semantics.
 */
 
+#include "packet-memory-pool.h"
+
 #include "ns3/type-id.h"
 
 #include <ostream>
@@ -241,6 +243,12 @@ class PacketTagList
      * @returns The newly constructed TagData object.
      */
     static TagData* CreateTagData(size_t dataSize);
+    /**
+     * Destroy and free a TagData struct created by CreateTagData().
+     *
+     * @param [in] tag The TagData object.
+     */
+    inline static void FreeTagData(TagData* tag);
 
     /**
      * Typedef of method function pointer for copy-on-write operations
@@ -341,6 +349,14 @@ PacketTagList::~PacketTagList()
     RemoveAll();
 }
 
+void
+PacketTagList::FreeTagData(TagData* tag)
+{
+    std::size_t size = sizeof(TagData) + tag->size - 1;
+    tag->~TagData();
+    PacketMemoryPool::Deallocate(tag, size);
+}
+
 void
 PacketTagList::RemoveAll()
 {
@@ -354,15 +370,13 @@ PacketTagList::RemoveAll()
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            FreeTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        FreeTagData(prev);
     }
     m_next = nullptr;
 }
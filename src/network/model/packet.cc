@@ -7,6 +7,8 @@
  */
 #include "packet.h"
 
+#include "packet-memory-pool.h"
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -19,7 +21,7 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid{0};
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -116,6 +118,18 @@ PacketTagIterator::Item::GetTag(Tag& tag) const
     tag.Deserialize(TagBuffer((uint8_t*)m_data->data, (uint8_t*)m_data->data + m_data->size));
 }
 
+void*
+Packet::operator new(std::size_t size)
+{
+    return PacketMemoryPool::Allocate(size);
+}
+
+void
+Packet::operator delete(void* p, std::size_t size)
+{
+    PacketMemoryPool::Deallocate(p, size);
+}
+
 Ptr<Packet>
 Packet::Copy() const
 {
@@ -135,10 +149,11 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -175,10 +190,11 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -202,10 +218,11 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -22,6 +22,7 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <atomic>
 #include <stdint.h>
 
 namespace ns3
@@ -227,6 +228,19 @@ class PacketTagIterator
 class Packet : public SimpleRefCount<Packet>
 {
   public:
+    /**
+     * @brief Allocate a Packet from the PacketMemoryPool of the calling thread.
+     * @param size the size of the object
+     * @returns the storage
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * @brief Return a Packet to the PacketMemoryPool of the calling thread.
+     * @param p the storage
+     * @param size the size of the object
+     */
+    static void operator delete(void* p, std::size_t size);
+
     /**
      * @brief Create an empty packet with a new uid (as returned
      * by getUid).
@@ -784,7 +798,7 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
 };
 
 /**
@@ -14,6 +14,7 @@
 #include <cstdarg>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -326,6 +327,13 @@ class PacketMetadataTest : public TestCase
     void CheckHistory(Ptr<Packet> p, uint32_t n, ...);
     void DoRun() override;
 
+  protected:
+    /**
+     * Constructor
+     * @param name The name of the test case.
+     */
+    PacketMetadataTest(std::string name);
+
   private:
     /**
      * Adds an header to the packet
@@ -340,6 +348,11 @@ PacketMetadataTest::PacketMetadataTest()
 {
 }
 
+PacketMetadataTest::PacketMetadataTest(std::string name)
+    : TestCase(name)
+{
+}
+
 PacketMetadataTest::~PacketMetadataTest()
 {
 }
@@ -870,6 +883,109 @@ PacketMetadataTest::DoRun()
                           "Could not find original data in received packet");
 }
 
+#if defined(NS3_PACKET_METADATA_COMPACT)
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * Compact packet metadata unit tests.
+ */
+class PacketMetadataCompactTest : public PacketMetadataTest
+{
+  public:
+    PacketMetadataCompactTest();
+    void DoRun() override;
+};
+
+PacketMetadataCompactTest::PacketMetadataCompactTest()
+    : PacketMetadataTest("Compact packet metadata")
+{
+}
+
+void
+PacketMetadataCompactTest::DoRun()
+{
+    PacketMetadata::Enable();
+
+    Ptr<Packet> p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    ADD_HEADER(p, 2);
+    ADD_TRAILER(p, 100);
+    CHECK_HISTORY(p, 4, 2, 1, 10, 100);
+    REM_HEADER(p, 2);
+    REM_TRAILER(p, 100);
+    CHECK_HISTORY(p, 2, 1, 10);
+
+    // A fragment keeps the type of the header it cuts
+    p = Create<Packet>(10);
+    ADD_HEADER(p, 5);
+    Ptr<Packet> fragment = p->CreateFragment(2, 8);
+    CHECK_HISTORY(fragment, 2, 3, 5);
+    PacketMetadata::ItemIterator i = fragment->BeginItem();
+    PacketMetadata::Item item = i.Next();
+    NS_TEST_EXPECT_MSG_EQ(item.isFragment, true, "Cut header not a fragment");
+    NS_TEST_EXPECT_MSG_EQ(item.type, PacketMetadata::Item::HEADER, "Wrong fragment type");
+    NS_TEST_EXPECT_MSG_EQ(item.currentTrimmedFromStart, 2, "Wrong fragment start");
+
+    // Once the items are full, the two in the middle become payload
+    p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    ADD_HEADER(p, 2);
+    ADD_HEADER(p, 3);
+    ADD_HEADER(p, 4);
+    ADD_HEADER(p, 5);
+    ADD_HEADER(p, 6);
+    ADD_HEADER(p, 7);
+    CHECK_HISTORY(p, 8, 7, 6, 5, 4, 3, 2, 1, 10);
+    ADD_HEADER(p, 8);
+    CHECK_HISTORY(p, 8, 8, 7, 6, 5, 7, 2, 1, 10);
+    REM_HEADER(p, 8);
+    REM_HEADER(p, 7);
+    CHECK_HISTORY(p, 6, 6, 5, 7, 2, 1, 10);
+}
+
+#elif defined(NS3_PACKET_METADATA_DISABLE)
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * Check the packets of a build without packet metadata.
+ */
+class PacketMetadataDisabledTest : public TestCase
+{
+  public:
+    PacketMetadataDisabledTest();
+    void DoRun() override;
+};
+
+PacketMetadataDisabledTest::PacketMetadataDisabledTest()
+    : TestCase("Packet metadata compiled out")
+{
+}
+
+void
+PacketMetadataDisabledTest::DoRun()
+{
+    PacketMetadata::Enable();
+
+    Ptr<Packet> p = Create<Packet>(10);
+    HistoryHeader<1> header;
+    p->AddHeader(header);
+    NS_TEST_EXPECT_MSG_EQ(p->BeginItem().HasNext(), false, "Items recorded");
+    NS_TEST_EXPECT_MSG_EQ(p->ToString(), "", "Packet printed");
+
+    uint32_t size = p->GetSerializedSize();
+    std::vector<uint8_t> buffer(size);
+    p->Serialize(buffer.data(), size);
+    Ptr<Packet> copy = Create<Packet>(buffer.data(), size, true);
+    NS_TEST_EXPECT_MSG_EQ(copy->GetUid(), p->GetUid(), "Uid lost");
+    NS_TEST_EXPECT_MSG_EQ(copy->GetSize(), 11, "Wrong size");
+}
+
+#endif
+
 /**
  * @ingroup network-test
  * @ingroup tests
@@ -885,7 +1001,13 @@ class PacketMetadataTestSuite : public TestSuite
 PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", Type::UNIT)
 {
+#if defined(NS3_PACKET_METADATA_COMPACT)
+    AddTestCase(new PacketMetadataCompactTest, TestCase::Duration::QUICK);
+#elif defined(NS3_PACKET_METADATA_DISABLE)
+    AddTestCase(new PacketMetadataDisabledTest, TestCase::Duration::QUICK);
+#else
     AddTestCase(new PacketMetadataTest, TestCase::Duration::QUICK);
+#endif
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
@@ -5,6 +5,7 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/packet-memory-pool.h"
 #include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
 #include "ns3/test.h"
@@ -1257,6 +1258,68 @@ PacketTagListTest::DoRun()
     }
 }
 
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * @brief Check that PacketMemoryPool recycles all the memory of packets in
+ * steady state.
+ */
+class PacketMemoryPoolTest : public TestCase
+{
+  public:
+    PacketMemoryPoolTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * Create, modify and destroy packets.
+     * @param n The number of iterations.
+     */
+    void RunPackets(uint32_t n);
+};
+
+PacketMemoryPoolTest::PacketMemoryPoolTest()
+    : TestCase("PacketMemoryPool steady state")
+{
+}
+
+void
+PacketMemoryPoolTest::RunPackets(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(ATestHeader<10>());
+        p->AddPacketTag(ATestTag<3>());
+        p->AddByteTag(ATestTag<2>());
+        Ptr<Packet> copy = p->Copy();
+        ATestHeader<10> header;
+        copy->RemoveHeader(header);
+        copy->AddHeader(ATestHeader<20>());
+        Ptr<Packet> fragment = copy->CreateFragment(10, 500);
+        fragment->AddAtEnd(p);
+        ATestTag<3> tag;
+        fragment->RemovePacketTag(tag);
+    }
+}
+
+void
+PacketMemoryPoolTest::DoRun()
+{
+    RunPackets(16);
+    PacketMemoryPool::Stats before = PacketMemoryPool::GetStats();
+    RunPackets(1000);
+    PacketMemoryPool::Stats after = PacketMemoryPool::GetStats();
+
+    NS_TEST_EXPECT_MSG_GT(after.allocations, before.allocations, "Packets not pooled");
+    NS_TEST_EXPECT_MSG_EQ(after.hits - before.hits,
+                          after.allocations - before.allocations,
+                          "Allocation not served by a recycled block");
+    NS_TEST_EXPECT_MSG_EQ(after.oversize, before.oversize, "Unexpected oversize allocation");
+    NS_TEST_EXPECT_MSG_EQ(after.chunkBytes, before.chunkBytes, "Pool grew in steady state");
+}
+
 /**
  * @ingroup network-test
  * @ingroup tests
@@ -1274,6 +1337,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::Duration::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::Duration::QUICK);
+    AddTestCase(new PacketMemoryPoolTest, TestCase::Duration::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -9,10 +9,14 @@
 #include "point-to-point-net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/node.h"
 #include "ns3/packet.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -20,6 +24,20 @@ NS_LOG_COMPONENT_DEFINE("PointToPointChannel");
 
 NS_OBJECT_ENSURE_REGISTERED(PointToPointChannel);
 
+/**
+ * Check whether the simulator runs nodes of different system ids on
+ * different threads of this process.
+ * @returns \c true if the simulator is a MultithreadedSimulatorImpl.
+ */
+static bool
+IsMultithreaded()
+{
+    // Looked up by name: the mtp module may not be built
+    TypeId tid;
+    return TypeId::LookupByNameFailSafe("ns3::MultithreadedSimulatorImpl", &tid) &&
+           Simulator::GetImplementation()->GetInstanceTypeId() == tid;
+}
+
 TypeId
 PointToPointChannel::GetTypeId()
 {
@@ -48,7 +66,8 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(),
-      m_nDevices(0)
+      m_nDevices(0),
+      m_deepCopy(false)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -60,7 +79,11 @@ PointToPointChannel::Attach(Ptr<PointToPointNetDevice> device)
     NS_ASSERT_MSG(m_nDevices < N_DEVICES, "Only two devices permitted");
     NS_ASSERT(device);
 
-    m_link[m_nDevices++].m_src = device;
+    // Keep plain pointers to the nodes as well: with a multithreaded
+    // simulator, the peer node may belong to another thread, whose
+    // reference counts must not be touched
+    m_link[m_nDevices].m_src = device;
+    m_link[m_nDevices++].m_srcNode = PeekPointer(device->GetNode());
     //
     // If we have both devices connected to the channel, then finish introducing
     // the two halves and set the links to IDLE.
@@ -69,8 +92,13 @@ PointToPointChannel::Attach(Ptr<PointToPointNetDevice> device)
     {
         m_link[0].m_dst = m_link[1].m_src;
         m_link[1].m_dst = m_link[0].m_src;
+        m_link[0].m_dstNode = m_link[1].m_srcNode;
+        m_link[1].m_dstNode = m_link[0].m_srcNode;
         m_link[0].m_state = IDLE;
         m_link[1].m_state = IDLE;
+        // Decided here, on the main thread, since looking at the simulator
+        // from a partition would touch its reference count
+        m_deepCopy = IsMultithreaded();
     }
 }
 
@@ -84,15 +112,41 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
     NS_ASSERT(m_link[1].m_state != INITIALIZING);
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+    Link& link = m_link[wire];
+    if (link.m_dstNode == nullptr)
+    {
+        // The devices were attached before being added to their nodes
+        link.m_srcNode = PeekPointer(src->GetNode());
+        link.m_dstNode = PeekPointer(link.m_dst->GetNode());
+    }
 
-    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
-                                   txTime + m_delay,
-                                   &PointToPointNetDevice::Receive,
-                                   m_link[wire].m_dst,
-                                   p->Copy());
+    if (!m_deepCopy || link.m_srcNode->GetSystemId() == link.m_dstNode->GetSystemId())
+    {
+        Simulator::ScheduleWithContext(link.m_dstNode->GetId(),
+                                       txTime + m_delay,
+                                       &PointToPointNetDevice::Receive,
+                                       link.m_dst,
+                                       p->Copy());
+    }
+    else
+    {
+        // The receiver may run on another thread: hand it a deep copy which
+        // shares no buffer or tag with the original, and a plain pointer
+        uint32_t size = p->GetSerializedSize();
+        std::vector<uint8_t> buffer(size);
+        p->Serialize(buffer.data(), size);
+        Simulator::ScheduleWithContext(link.m_dstNode->GetId(),
+                                       txTime + m_delay,
+                                       &PointToPointNetDevice::Receive,
+                                       PeekPointer(link.m_dst),
+                                       Create<Packet>(buffer.data(), size, true));
+    }
 
     // Call the tx anim callback on the net device
-    m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    if (!m_txrxPointToPoint.IsEmpty())
+    {
+        m_txrxPointToPoint(p, src, link.m_dst, txTime, txTime + m_delay);
+    }
     return true;
 }
 
@@ -20,6 +20,7 @@ namespace ns3
 
 class PointToPointNetDevice;
 class Packet;
+class Node;
 
 /**
  * @ingroup point-to-point
@@ -143,6 +144,8 @@ class PointToPointChannel : public Channel
 
     Time m_delay;           //!< Propagation delay
     std::size_t m_nDevices; //!< Devices of this channel
+    /// Deep copy packets for a peer of another system id, which runs on another thread
+    bool m_deepCopy;
 
     /**
      * The trace source for the packet transmission animation events that the
@@ -193,6 +196,8 @@ class PointToPointChannel : public Channel
         WireState m_state{INITIALIZING};  //!< State of the link
         Ptr<PointToPointNetDevice> m_src; //!< First NetDevice
         Ptr<PointToPointNetDevice> m_dst; //!< Second NetDevice
+        Node* m_srcNode{nullptr};         //!< Node of the first NetDevice
+        Node* m_dstNode{nullptr};         //!< Node of the second NetDevice
     };
 
     Link m_link[N_DEVICES]; //!< Link model
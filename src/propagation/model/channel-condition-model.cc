@@ -215,6 +215,12 @@ ChannelConditionModel::~ChannelConditionModel()
 {
 }
 
+Time
+ChannelConditionModel::GetCoherenceTime() const
+{
+    return Seconds(0);
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(AlwaysLosChannelConditionModel);
@@ -431,15 +437,45 @@ ThreeGppChannelConditionModel::GetChannelCondition(Ptr<const MobilityModel> a,
         cond = ComputeChannelCondition(a, b);
         // store the channel condition in m_channelConditionMap, used as cache.
         // For this reason you see a const_cast.
+        auto model = const_cast<ThreeGppChannelConditionModel*>(this);
+        if (notFound && !m_updatePeriod.IsZero() &&
+            Simulator::Now() - m_lastRemoval > m_updatePeriod)
+        {
+            model->RemoveStaleConditions();
+        }
         Item mapItem;
         mapItem.m_condition = cond;
         mapItem.m_generatedTime = Simulator::Now();
-        const_cast<ThreeGppChannelConditionModel*>(this)->m_channelConditionMap[key] = mapItem;
+        model->m_channelConditionMap[key] = mapItem;
     }
 
     return cond;
 }
 
+Time
+ThreeGppChannelConditionModel::GetCoherenceTime() const
+{
+    return m_updatePeriod;
+}
+
+void
+ThreeGppChannelConditionModel::RemoveStaleConditions()
+{
+    NS_LOG_FUNCTION(this);
+    m_lastRemoval = Simulator::Now();
+    for (auto it = m_channelConditionMap.begin(); it != m_channelConditionMap.end();)
+    {
+        if (Simulator::Now() - it->second.m_generatedTime > m_updatePeriod)
+        {
+            it = m_channelConditionMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 ChannelCondition::O2iConditionValue
 ThreeGppChannelConditionModel::ComputeO2i(Ptr<const MobilityModel> a,
                                           Ptr<const MobilityModel> b) const
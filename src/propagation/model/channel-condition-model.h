@@ -256,6 +256,17 @@ class ChannelConditionModel : public Object
     virtual Ptr<ChannelCondition> GetChannelCondition(Ptr<const MobilityModel> a,
                                                       Ptr<const MobilityModel> b) const = 0;
 
+    /**
+     * Get the time after which the model computes again the condition of a
+     * channel.  The models which keep values derived from a condition may
+     * drop them when they are older than that, since they are stale.
+     *
+     * By default, the conditions are never computed again.
+     *
+     * @return the coherence time of the conditions, or 0 if they never change
+     */
+    virtual Time GetCoherenceTime() const;
+
     /**
      * If this  model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -462,6 +473,11 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
     Ptr<ChannelCondition> GetChannelCondition(Ptr<const MobilityModel> a,
                                               Ptr<const MobilityModel> b) const override;
 
+    /**
+     * @return the "UpdatePeriod" of the model
+     */
+    Time GetCoherenceTime() const override;
+
     /**
      * If this  model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -558,6 +574,12 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
      */
     static uint32_t GetKey(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
 
+    /**
+     * Remove from m_channelConditionMap the conditions older than the
+     * update period, which would be computed again anyway.
+     */
+    void RemoveStaleConditions();
+
     /**
      * Struct to store the channel condition in the m_channelConditionMap
      */
@@ -570,6 +592,7 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
     std::unordered_map<uint32_t, Item>
         m_channelConditionMap; //!< map to store the channel conditions
     Time m_updatePeriod;       //!< the update period for the channel condition
+    Time m_lastRemoval;        //!< the last time the stale conditions were removed
 
     double m_o2iThreshold{
         0}; //!< the threshold for determining what is the ratio of channels with O2I
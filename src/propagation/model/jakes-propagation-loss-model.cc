@@ -10,6 +10,7 @@
 
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -35,10 +36,52 @@ JakesPropagationLossModel::GetTypeId()
     static TypeId tid = TypeId("ns3::JakesPropagationLossModel")
                             .SetParent<PropagationLossModel>()
                             .SetGroupName("Propagation")
-                            .AddConstructor<JakesPropagationLossModel>();
+                            .AddConstructor<JakesPropagationLossModel>()
+                            .AddAttribute("CacheSize",
+                                          "The maximum number of paths whose JakesProcess is "
+                                          "kept. When it is reached, the process of the least "
+                                          "recently used path is dropped. 0 means no limit.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &JakesPropagationLossModel::SetCacheSize,
+                                              &JakesPropagationLossModel::GetCacheSize),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("CoherenceTime",
+                                          "The time after which a new JakesProcess, with new "
+                                          "random phases, is drawn for a path. 0 means that the "
+                                          "process of a path is kept for the whole simulation.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(
+                                              &JakesPropagationLossModel::SetCoherenceTime,
+                                              &JakesPropagationLossModel::GetCoherenceTime),
+                                          MakeTimeChecker(Seconds(0)));
     return tid;
 }
 
+void
+JakesPropagationLossModel::SetCacheSize(uint32_t cacheSize)
+{
+    m_propagationCache.SetMaxSize(cacheSize);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize() const
+{
+    return static_cast<uint32_t>(m_propagationCache.GetMaxSize());
+}
+
+void
+JakesPropagationLossModel::SetCoherenceTime(Time coherenceTime)
+{
+    m_propagationCache.SetCoherenceTime(coherenceTime);
+}
+
+Time
+JakesPropagationLossModel::GetCoherenceTime() const
+{
+    return m_propagationCache.GetCoherenceTime();
+}
+
 void
 JakesPropagationLossModel::DoDispose()
 {
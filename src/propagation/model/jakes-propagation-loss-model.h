@@ -36,6 +36,28 @@ class JakesPropagationLossModel : public PropagationLossModel
     JakesPropagationLossModel(const JakesPropagationLossModel&) = delete;
     JakesPropagationLossModel& operator=(const JakesPropagationLossModel&) = delete;
 
+    /**
+     * Set the maximum number of paths whose JakesProcess is kept.
+     * @param cacheSize the maximum number of paths, or 0 for no limit
+     */
+    void SetCacheSize(uint32_t cacheSize);
+
+    /**
+     * @return the maximum number of paths whose JakesProcess is kept, or 0 if there is no limit
+     */
+    uint32_t GetCacheSize() const;
+
+    /**
+     * Set the time after which a new JakesProcess is drawn for a path.
+     * @param coherenceTime the coherence time, or 0 to keep the process of a path forever
+     */
+    void SetCoherenceTime(Time coherenceTime);
+
+    /**
+     * @return the time after which a new JakesProcess is drawn for a path
+     */
+    Time GetCoherenceTime() const;
+
   protected:
     void DoDispose() override;
 
@@ -9,8 +9,15 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -19,12 +26,31 @@ namespace ns3
  * @brief Constructs a cache of objects, where each object is responsible for a single propagation
  * path loss calculations. Propagation path a-->b and b-->a is the same thing. Propagation path is
  * identified by a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are kept in a hash table, so a lookup takes a constant time on
+ * average.  The cache may be bounded in two ways:
+ *
+ * - with a maximum size, beyond which the least recently used path is evicted;
+ * - with a coherence time, after which the object of a path is stale: it is
+ *   evicted by the next GetPathData, which then returns nullptr so that the
+ *   caller computes a new one.  The cache also sweeps the stale paths at most
+ *   once per coherence time when a path is added, so the paths which are no
+ *   longer used do not stay in memory.
+ *
+ * Both bounds are disabled by default.  The evicted objects are disposed,
+ * as are all the objects when the cache is cleaned up.
  */
 template <class T>
 class PropagationCache
 {
   public:
     PropagationCache()
+        : m_maxSize(0),
+          m_coherenceTime(0),
+          m_lastSweep(0),
+          m_hits(0),
+          m_misses(0),
+          m_evictions(0)
     {
     }
 
@@ -32,12 +58,51 @@ class PropagationCache
     {
     }
 
+    /**
+     * Set the maximum number of paths in the cache.  If the cache holds more
+     * paths, the least recently used ones are evicted.
+     *
+     * @param maxSize the maximum number of paths, or 0 for no limit
+     */
+    void SetMaxSize(std::size_t maxSize)
+    {
+        m_maxSize = maxSize;
+        EvictLeastRecentlyUsed();
+    }
+
+    /**
+     * @return the maximum number of paths in the cache, or 0 if there is no limit
+     */
+    std::size_t GetMaxSize() const
+    {
+        return m_maxSize;
+    }
+
+    /**
+     * Set the time after which the object of a path is stale.
+     *
+     * @param coherenceTime the coherence time, or 0 if the objects never get stale
+     */
+    void SetCoherenceTime(Time coherenceTime)
+    {
+        m_coherenceTime = coherenceTime;
+    }
+
+    /**
+     * @return the time after which the object of a path is stale, or 0 if
+     * the objects never get stale
+     */
+    Time GetCoherenceTime() const
+    {
+        return m_coherenceTime;
+    }
+
     /**
      * Get the model associated with the path
      * @param a 1st node mobility model
      * @param b 2nd node mobility model
      * @param modelUid model UID
-     * @return the model
+     * @return the model, or nullptr if the path is not in the cache or its model is stale
      */
     Ptr<T> GetPathData(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
     {
@@ -45,9 +110,19 @@ class PropagationCache
         auto it = m_pathCache.find(key);
         if (it == m_pathCache.end())
         {
+            m_misses++;
             return nullptr;
         }
-        return it->second;
+        if (IsStale(*it->second))
+        {
+            Evict(it);
+            m_misses++;
+            return nullptr;
+        }
+        m_hits++;
+        // move the path to the front of the list of paths by recent use
+        m_lruList.splice(m_lruList.begin(), m_lruList, it->second);
+        return it->second->m_data;
     }
 
     /**
@@ -64,7 +139,14 @@ class PropagationCache
     {
         PropagationPathIdentifier key = PropagationPathIdentifier(a, b, modelUid);
         NS_ASSERT(m_pathCache.find(key) == m_pathCache.end());
-        m_pathCache.insert(std::make_pair(key, data));
+        if (m_coherenceTime.IsStrictlyPositive() &&
+            Simulator::Now() - m_lastSweep >= m_coherenceTime)
+        {
+            EvictStale();
+        }
+        m_lruList.push_front(Item{key, data, Simulator::Now()});
+        m_pathCache.insert(std::make_pair(key, m_lruList.begin()));
+        EvictLeastRecentlyUsed();
     }
 
     /**
@@ -72,11 +154,44 @@ class PropagationCache
      */
     void Cleanup()
     {
-        for (auto i : m_pathCache)
+        for (auto& item : m_lruList)
         {
-            i.second->Dispose();
+            item.m_data->Dispose();
         }
         m_pathCache.clear();
+        m_lruList.clear();
+    }
+
+    /**
+     * @return the number of paths in the cache
+     */
+    std::size_t GetSize() const
+    {
+        return m_pathCache.size();
+    }
+
+    /**
+     * @return the number of calls to GetPathData which returned a model
+     */
+    uint64_t GetHits() const
+    {
+        return m_hits;
+    }
+
+    /**
+     * @return the number of calls to GetPathData which returned nullptr
+     */
+    uint64_t GetMisses() const
+    {
+        return m_misses;
+    }
+
+    /**
+     * @return the number of paths evicted because the cache was full or their model was stale
+     */
+    uint64_t GetEvictions() const
+    {
+        return m_evictions;
     }
 
   private:
@@ -92,56 +207,124 @@ class PropagationCache
         PropagationPathIdentifier(Ptr<const MobilityModel> a,
                                   Ptr<const MobilityModel> b,
                                   uint32_t modelUid)
-            : m_srcMobility(a),
-              m_dstMobility(b),
+            : m_srcMobility(std::min(a, b)),
+              m_dstMobility(std::max(a, b)),
               m_spectrumModelUid(modelUid)
         {
         }
 
-        Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
-        Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
+        /// Links are supposed to be symmetrical, so the constructor sorts the mobility models
+        Ptr<const MobilityModel> m_srcMobility; //!< lower of the two mobility models
+        Ptr<const MobilityModel> m_dstMobility; //!< higher of the two mobility models
         uint32_t m_spectrumModelUid;            //!< model UID
 
         /**
-         * Less-than operator.
-         *
-         * The goal of this operator is just to provide a stable comparison
-         * to be used in containers requiring a order (of any kind).
-         *
-         * If the models are different, the comparison is based on their Uid.
-         * Otherwise, the comparison is based on the pointers of the Mobility models.
+         * Equality operator.
          *
          * @param other Right value of the operator.
-         * @returns True if the Left value is less than the Right value.
+         * @returns True if both values identify the same path.
          */
-        bool operator<(const PropagationPathIdentifier& other) const
+        bool operator==(const PropagationPathIdentifier& other) const
         {
-            if (m_spectrumModelUid != other.m_spectrumModelUid)
-            {
-                return m_spectrumModelUid < other.m_spectrumModelUid;
-            }
-            /// Links are supposed to be symmetrical!
-            if (std::min(m_dstMobility, m_srcMobility) !=
-                std::min(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::min(m_dstMobility, m_srcMobility) <
-                       std::min(other.m_dstMobility, other.m_srcMobility);
-            }
-            if (std::max(m_dstMobility, m_srcMobility) !=
-                std::max(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::max(m_dstMobility, m_srcMobility) <
-                       std::max(other.m_dstMobility, other.m_srcMobility);
-            }
-            return false;
+            return m_spectrumModelUid == other.m_spectrumModelUid &&
+                   m_srcMobility == other.m_srcMobility && m_dstMobility == other.m_dstMobility;
         }
     };
 
-    /// Typedef: PropagationPathIdentifier, Ptr<T>
-    typedef std::map<PropagationPathIdentifier, Ptr<T>> PathCache;
+    /// Hash of a PropagationPathIdentifier
+    struct PropagationPathIdentifierHash
+    {
+        /**
+         * @param key the path
+         * @return the hash of the path
+         */
+        std::size_t operator()(const PropagationPathIdentifier& key) const
+        {
+            std::hash<const MobilityModel*> hashPtr;
+            std::size_t h = hashPtr(PeekPointer(key.m_srcMobility));
+            h ^= hashPtr(PeekPointer(key.m_dstMobility)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>()(key.m_spectrumModelUid) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    /// A path of the cache
+    struct Item
+    {
+        PropagationPathIdentifier m_key; //!< the path
+        Ptr<T> m_data;                   //!< the model of the path
+        Time m_createdTime;              //!< the time when the model was added
+    };
+
+    /// List of the paths, from the most to the least recently used
+    typedef std::list<Item> LruList;
+
+    /// Typedef: PropagationPathIdentifier, position of the path in the LruList
+    typedef std::unordered_map<PropagationPathIdentifier,
+                               typename LruList::iterator,
+                               PropagationPathIdentifierHash>
+        PathCache;
+
+    /**
+     * @param item a path of the cache
+     * @return whether the model of the path is older than the coherence time
+     */
+    bool IsStale(const Item& item) const
+    {
+        return m_coherenceTime.IsStrictlyPositive() &&
+               Simulator::Now() - item.m_createdTime > m_coherenceTime;
+    }
+
+    /**
+     * Remove a path from the cache and dispose its model.
+     * @param it the path
+     */
+    void Evict(typename PathCache::iterator it)
+    {
+        Ptr<T> data = it->second->m_data;
+        m_lruList.erase(it->second);
+        m_pathCache.erase(it);
+        m_evictions++;
+        data->Dispose();
+    }
+
+    /**
+     * Evict the least recently used paths while the cache holds more than the maximum size.
+     */
+    void EvictLeastRecentlyUsed()
+    {
+        while (m_maxSize > 0 && m_pathCache.size() > m_maxSize)
+        {
+            Evict(m_pathCache.find(m_lruList.back().m_key));
+        }
+    }
+
+    /**
+     * Evict all the paths whose model is stale.
+     */
+    void EvictStale()
+    {
+        m_lastSweep = Simulator::Now();
+        for (auto it = m_pathCache.begin(); it != m_pathCache.end();)
+        {
+            auto next = std::next(it);
+            if (IsStale(*it->second))
+            {
+                Evict(it);
+            }
+            it = next;
+        }
+    }
 
   private:
     PathCache m_pathCache; //!< Path cache
+    LruList m_lruList;     //!< Paths, from the most to the least recently used
+    std::size_t m_maxSize; //!< Maximum number of paths, 0 if there is no limit
+    Time m_coherenceTime;  //!< Time after which a model is stale, 0 if it never is
+    Time m_lastSweep;      //!< Time of the last sweep of the stale paths
+    uint64_t m_hits;       //!< Number of lookups which returned a model
+    uint64_t m_misses;     //!< Number of lookups which returned nullptr
+    uint64_t m_evictions;  //!< Number of evicted paths
 };
 } // namespace ns3
 
@@ -0,0 +1,232 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * @ingroup propagation-tests
+ *
+ * @brief Object stored in the PropagationCache, which records whether it was disposed
+ */
+class CacheItem : public Object
+{
+  public:
+    /**
+     * Register this type.
+     * @return The TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("PropagationCacheTest:CacheItem")
+                                .SetParent<Object>()
+                                .SetGroupName("Propagation")
+                                .HideFromDocumentation()
+                                .AddConstructor<CacheItem>();
+        return tid;
+    }
+
+    bool m_disposed{false}; //!< Whether the object was disposed
+
+  protected:
+    void DoDispose() override
+    {
+        m_disposed = true;
+        Object::DoDispose();
+    }
+};
+
+} // namespace
+
+/**
+ * @ingroup propagation-tests
+ *
+ * @brief Check the lookups of the PropagationCache and its eviction of the
+ * least recently used paths.
+ */
+class PropagationCacheSizeTestCase : public TestCase
+{
+  public:
+    PropagationCacheSizeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PropagationCacheSizeTestCase::PropagationCacheSizeTestCase()
+    : TestCase("Check the lookups and the size limit of the PropagationCache")
+{
+}
+
+void
+PropagationCacheSizeTestCase::DoRun()
+{
+    auto a = CreateObject<ConstantPositionMobilityModel>();
+    auto b = CreateObject<ConstantPositionMobilityModel>();
+    auto c = CreateObject<ConstantPositionMobilityModel>();
+    PropagationCache<CacheItem> cache;
+
+    auto ab = CreateObject<CacheItem>();
+    cache.AddPathData(ab, a, b, 0);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(b, a, 0), ab, "Paths should be symmetrical");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(a, b, 1), nullptr, "Wrong model uid");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(a, c, 0), nullptr, "Wrong path");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetHits(), 1, "Wrong number of hits");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetMisses(), 2, "Wrong number of misses");
+
+    auto ac = CreateObject<CacheItem>();
+    cache.AddPathData(ac, a, c, 0);
+    cache.SetMaxSize(2);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetSize(), 2, "No path should be evicted yet");
+
+    // a-b is now more recently used than a-c, so a-c is evicted
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(a, b, 0), ab, "a-b should be in the cache");
+    auto bc = CreateObject<CacheItem>();
+    cache.AddPathData(bc, c, b, 0);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetSize(), 2, "The cache should not grow beyond its size");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetEvictions(), 1, "Wrong number of evictions");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(c, a, 0), nullptr, "a-c should be evicted");
+    NS_TEST_ASSERT_MSG_EQ(ac->m_disposed, true, "The evicted model should be disposed");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(b, c, 0), bc, "b-c should be in the cache");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(b, a, 0), ab, "a-b should be in the cache");
+
+    cache.SetMaxSize(1);
+    NS_TEST_ASSERT_MSG_EQ(cache.GetPathData(b, c, 0), nullptr, "b-c should be evicted");
+    NS_TEST_ASSERT_MSG_EQ(cache.GetEvictions(), 2, "Wrong number of evictions");
+
+    cache.Cleanup();
+    NS_TEST_ASSERT_MSG_EQ(cache.GetSize(), 0, "The cache should be empty");
+    NS_TEST_ASSERT_MSG_EQ(ab->m_disposed, true, "Cleanup should dispose the models");
+}
+
+/**
+ * @ingroup propagation-tests
+ *
+ * @brief Check that the PropagationCache drops the models older than its
+ * coherence time.
+ */
+class PropagationCacheCoherenceTestCase : public TestCase
+{
+  public:
+    PropagationCacheCoherenceTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Add a path to the cache.
+     * @param a 1st node mobility model
+     * @param b 2nd node mobility model
+     * @return the model of the path
+     */
+    Ptr<CacheItem> Add(Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+    /**
+     * Check the content of the cache.
+     * @param a 1st node mobility model
+     * @param b 2nd node mobility model
+     * @param expected the model expected for the path a-b
+     * @param size the expected number of paths in the cache
+     */
+    void Check(Ptr<MobilityModel> a,
+               Ptr<MobilityModel> b,
+               Ptr<CacheItem> expected,
+               std::size_t size);
+
+    PropagationCache<CacheItem> m_cache; //!< The cache under test
+};
+
+PropagationCacheCoherenceTestCase::PropagationCacheCoherenceTestCase()
+    : TestCase("Check the coherence time of the PropagationCache")
+{
+}
+
+Ptr<CacheItem>
+PropagationCacheCoherenceTestCase::Add(Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+    auto item = CreateObject<CacheItem>();
+    m_cache.AddPathData(item, a, b, 0);
+    return item;
+}
+
+void
+PropagationCacheCoherenceTestCase::Check(Ptr<MobilityModel> a,
+                                         Ptr<MobilityModel> b,
+                                         Ptr<CacheItem> expected,
+                                         std::size_t size)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_cache.GetPathData(a, b, 0),
+                          expected,
+                          "Wrong model at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_cache.GetSize(),
+                          size,
+                          "Wrong number of paths at " << Simulator::Now().As(Time::S));
+}
+
+void
+PropagationCacheCoherenceTestCase::DoRun()
+{
+    auto a = CreateObject<ConstantPositionMobilityModel>();
+    auto b = CreateObject<ConstantPositionMobilityModel>();
+    auto c = CreateObject<ConstantPositionMobilityModel>();
+    m_cache.SetCoherenceTime(Seconds(1));
+
+    Ptr<CacheItem> ab = Add(a, b);
+    Ptr<CacheItem> ac = Add(a, c);
+    Ptr<CacheItem> bc;
+    Simulator::Schedule(Seconds(1), &PropagationCacheCoherenceTestCase::Check, this, a, b, ab, 2);
+    // a-b is stale: the lookup evicts it
+    Simulator::Schedule(MilliSeconds(1500),
+                        &PropagationCacheCoherenceTestCase::Check,
+                        this,
+                        a,
+                        b,
+                        Ptr<CacheItem>(),
+                        1);
+    // adding b-c sweeps a-c, which is stale too
+    Simulator::Schedule(Seconds(2), [this, b, c, &bc]() { bc = Add(b, c); });
+    Simulator::Schedule(MilliSeconds(2500),
+                        &PropagationCacheCoherenceTestCase::Check,
+                        this,
+                        a,
+                        c,
+                        Ptr<CacheItem>(),
+                        1);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(ab->m_disposed, true, "The stale model should be disposed");
+    NS_TEST_ASSERT_MSG_EQ(ac->m_disposed, true, "The stale model should be disposed");
+    NS_TEST_ASSERT_MSG_EQ(bc->m_disposed, false, "The model is not stale");
+    NS_TEST_ASSERT_MSG_EQ(m_cache.GetEvictions(), 2, "Wrong number of evictions");
+    m_cache.Cleanup();
+}
+
+/**
+ * @ingroup propagation-tests
+ *
+ * @brief PropagationCache TestSuite
+ */
+class PropagationCacheTestSuite : public TestSuite
+{
+  public:
+    PropagationCacheTestSuite();
+};
+
+PropagationCacheTestSuite::PropagationCacheTestSuite()
+    : TestSuite("propagation-cache", Type::UNIT)
+{
+    AddTestCase(new PropagationCacheSizeTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new PropagationCacheCoherenceTestCase(), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static PropagationCacheTestSuite g_propagationCacheTestSuite;
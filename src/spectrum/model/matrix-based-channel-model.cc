@@ -16,4 +16,10 @@ MatrixBasedChannelModel::~MatrixBasedChannelModel()
 {
 }
 
+Time
+MatrixBasedChannelModel::GetCoherenceTime() const
+{
+    return Seconds(0);
+}
+
 } // namespace ns3
@@ -200,6 +200,17 @@ class MatrixBasedChannelModel : public Object
     virtual Ptr<const ChannelParams> GetParams(Ptr<const MobilityModel> aMob,
                                                Ptr<const MobilityModel> bMob) const = 0;
 
+    /**
+     * Get the time after which the model generates a new realization of a
+     * channel.  The models which keep values derived from a channel may drop
+     * them when the channel is older than that, since it is stale.
+     *
+     * By default, the channels are never generated again because of their age.
+     *
+     * @return the coherence time of the channels, or 0 if they do not age
+     */
+    virtual Time GetCoherenceTime() const;
+
     /**
      * Generate a unique value for the pair of unsigned integer of 32 bits,
      * where the order does not matter, i.e., the same value will be returned for (a,b) and (b,a).
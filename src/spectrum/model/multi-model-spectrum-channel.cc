@@ -27,9 +27,11 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
 #include <iostream>
+#include <thread>
 #include <utility>
 
 namespace ns3
@@ -71,7 +73,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo(Ptr<const SpectrumModel> rxSpectrumMode
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel()
-    : m_numDevices{0}
+    : m_numDevices{0},
+      m_maxRange{0},
+      m_gridStale{true},
+      m_rxThreads{0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -82,6 +87,9 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    m_grid.Clear();
+    m_gridPhys.clear();
+    m_pendingRx.clear();
     SpectrumChannel::DoDispose();
 }
 
@@ -92,11 +100,62 @@ MultiModelSpectrumChannel::GetTypeId()
                             .SetParent<SpectrumChannel>()
                             .SetGroupName("Spectrum")
                             .AddConstructor<MultiModelSpectrumChannel>()
-
-        ;
+                            .AddAttribute(
+                                "MaxRange",
+                                "If positive, the distance in meters beyond which receivers "
+                                "do not get the transmissions at all. The receivers are then "
+                                "found through a spatial index instead of a scan of all of "
+                                "them, which saves the events of receivers which can never "
+                                "decode a signal in large networks. Receivers without a "
+                                "MobilityModel always get the transmissions. The culling is "
+                                "not applied when a WraparoundModel is aggregated to the "
+                                "channel or the transmitter has no MobilityModel.",
+                                DoubleValue(0),
+                                MakeDoubleAccessor(&MultiModelSpectrumChannel::SetMaxRange),
+                                MakeDoubleChecker<double>(0))
+            .AddAttribute(
+                "RxThreads",
+                "If positive, the signals for all the receivers of a transmission are "
+                "computed when the transmission starts, instead of when each signal "
+                "reaches its receiver, and the part of the computation of the "
+                "PhasedArraySpectrumPropagationLossModel which only reads the channel "
+                "realizations runs on this number of threads. The propagation losses "
+                "and the channel realizations are still computed on the simulation "
+                "thread, in the order of the receivers, so the results do not depend "
+                "on the number of threads.",
+                UintegerValue(0),
+                MakeUintegerAccessor(&MultiModelSpectrumChannel::m_rxThreads),
+                MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetMaxRange(double maxRange)
+{
+    NS_LOG_FUNCTION(this << maxRange);
+    m_maxRange = maxRange;
+    m_grid.Clear();
+    m_gridPhys.clear();
+    m_gridStale = true;
+}
+
+void
+MultiModelSpectrumChannel::RebuildGrid()
+{
+    NS_LOG_FUNCTION(this);
+    m_grid.Reset(m_maxRange);
+    m_gridPhys.clear();
+    for (const auto& [rxSpectrumModelUid, rxInfo] : m_rxSpectrumModelInfoMap)
+    {
+        for (const auto& phy : rxInfo.m_rxPhys)
+        {
+            m_grid.Add(m_gridPhys.size(), phy->GetMobility());
+            m_gridPhys.emplace_back(rxSpectrumModelUid, phy);
+        }
+    }
+    m_gridStale = false;
+}
+
 void
 MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
 {
@@ -117,6 +176,7 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
         {
             rxInfoIterator->second.m_rxPhys.erase(phyIt);
             --m_numDevices;
+            m_gridStale = true;
             break; // there should be at most one entry
         }
     }
@@ -138,6 +198,7 @@ MultiModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     RemoveRx(phy);
 
     ++m_numDevices;
+    m_gridStale = true;
 
     auto [rxInfoIterator, inserted] =
         m_rxSpectrumModelInfoMap.emplace(rxSpectrumModelUid, RxSpectrumModelInfo(rxSpectrumModel));
@@ -228,7 +289,6 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
     auto wraparound = GetObject<WraparoundModel>();
     auto refTxMobility = txParams->txPhy->GetMobility();
-    auto txMobility = refTxMobility;
     const auto txSpectrumModelUid = txParams->psd->GetSpectrumModelUid();
     NS_LOG_LOGIC("txSpectrumModelUid " << txSpectrumModelUid);
 
@@ -271,6 +331,30 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
         convertedPsds.emplace(rxSpectrumModelUid, convertedTxPowerSpectrum);
     }
 
+    if (m_maxRange > 0 && refTxMobility && !wraparound)
+    {
+        if (m_gridStale)
+        {
+            RebuildGrid();
+        }
+        // the keys come in the order of m_gridPhys, which is the order of the scan below
+        for (auto key : m_grid.GetInRange(refTxMobility->GetPosition(), m_maxRange))
+        {
+            const auto& [rxSpectrumModelUid, rxPhy] = m_gridPhys[key];
+            if (!convertedPsds.contains(rxSpectrumModelUid))
+            {
+                // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
+                continue;
+            }
+            ScheduleRx(txParams, rxPhy, rxSpectrumModelUid, convertedPsds, nullptr);
+        }
+        if (!m_pendingRx.empty())
+        {
+            ComputePendingRx(txParams->psd, convertedPsds);
+        }
+        return;
+    }
+
     for (auto rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
@@ -288,92 +372,123 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
              rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
              ++rxPhyIterator)
         {
-            NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
-                          "SpectrumModel change was not notified to MultiModelSpectrumChannel "
-                          "(i.e., AddRx should be called again after model is changed)");
+            ScheduleRx(txParams,
+                       *rxPhyIterator,
+                       rxSpectrumModelUid,
+                       convertedPsds,
+                       wraparound);
+        }
+    }
+    if (!m_pendingRx.empty())
+    {
+        ComputePendingRx(txParams->psd, convertedPsds);
+    }
+}
 
-            auto txAntennaGain{0.0};
-            if ((*rxPhyIterator) != txParams->txPhy)
-            {
-                auto rxNetDevice = (*rxPhyIterator)->GetDevice();
-                auto txNetDevice = txParams->txPhy->GetDevice();
-
-                if (rxNetDevice && txNetDevice)
-                {
-                    // we assume that devices are attached to a node
-                    if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
-                    {
-                        NS_LOG_DEBUG(
-                            "Skipping the pathloss calculation among different antennas of the "
-                            "same node, not supported yet by any pathloss model in ns-3.");
-                        continue;
-                    }
-                }
-
-                if (m_filter && m_filter->Filter(txParams, *rxPhyIterator))
-                {
-                    continue;
-                }
-
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                auto rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(convertedPsds.at(rxSpectrumModelUid));
-                Time delay{0};
-
-                auto receiverMobility = (*rxPhyIterator)->GetMobility();
-
-                if (txMobility && receiverMobility)
-                {
-                    if (wraparound)
-                    {
-                        // Use virtual mobility model instead
-                        txMobility =
-                            wraparound->GetVirtualMobilityModel(refTxMobility, receiverMobility);
-                    }
-                    rxParams->txMobility = txMobility;
-
-                    if (rxParams->txAntenna)
-                    {
-                        Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
-                        NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
-                    }
-                    if (m_propagationDelay)
-                    {
-                        delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
-                    }
-                }
-
-                if (rxNetDevice)
-                {
-                    // the receiver has a NetDevice, so we expect that it is attached to a Node
-                    auto dstNode = rxNetDevice->GetNode()->GetId();
-                    Simulator::ScheduleWithContext(dstNode,
-                                                   delay,
-                                                   &MultiModelSpectrumChannel::StartRx,
-                                                   this,
-                                                   txParams->psd,
-                                                   txAntennaGain,
-                                                   rxParams,
-                                                   *rxPhyIterator,
-                                                   convertedPsds);
-                }
-                else
-                {
-                    // the receiver is not attached to a NetDevice, so we cannot assume that it is
-                    // attached to a node
-                    Simulator::Schedule(delay,
-                                        &MultiModelSpectrumChannel::StartRx,
-                                        this,
-                                        txParams->psd,
-                                        txAntennaGain,
-                                        rxParams,
-                                        *rxPhyIterator,
-                                        convertedPsds);
-                }
-            }
+void
+MultiModelSpectrumChannel::ScheduleRx(
+    Ptr<SpectrumSignalParameters> txParams,
+    Ptr<SpectrumPhy> receiver,
+    SpectrumModelUid_t rxSpectrumModelUid,
+    const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& convertedPsds,
+    Ptr<WraparoundModel> wraparound)
+{
+    NS_ASSERT_MSG(receiver->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
+                  "SpectrumModel change was not notified to MultiModelSpectrumChannel "
+                  "(i.e., AddRx should be called again after model is changed)");
+
+    if (receiver == txParams->txPhy)
+    {
+        return;
+    }
+
+    auto txAntennaGain{0.0};
+    auto rxNetDevice = receiver->GetDevice();
+    auto txNetDevice = txParams->txPhy->GetDevice();
+
+    if (rxNetDevice && txNetDevice)
+    {
+        // we assume that devices are attached to a node
+        if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
+        {
+            NS_LOG_DEBUG("Skipping the pathloss calculation among different antennas of the "
+                         "same node, not supported yet by any pathloss model in ns-3.");
+            return;
         }
     }
+
+    if (m_filter && m_filter->Filter(txParams, receiver))
+    {
+        return;
+    }
+
+    NS_LOG_LOGIC("copying signal parameters " << txParams);
+    auto rxParams = txParams->Copy();
+    rxParams->psd = Copy<SpectrumValue>(convertedPsds.at(rxSpectrumModelUid));
+    Time delay{0};
+
+    auto txMobility = txParams->txPhy->GetMobility();
+    auto receiverMobility = receiver->GetMobility();
+
+    if (txMobility && receiverMobility)
+    {
+        if (wraparound)
+        {
+            // Use virtual mobility model instead
+            txMobility = wraparound->GetVirtualMobilityModel(txMobility, receiverMobility);
+        }
+        rxParams->txMobility = txMobility;
+
+        if (rxParams->txAntenna)
+        {
+            Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
+            txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+            NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
+        }
+        if (m_propagationDelay)
+        {
+            delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
+        }
+    }
+
+    if (m_rxThreads > 0)
+    {
+        PendingRx rx;
+        rx.receiver = receiver;
+        rx.params = rxParams;
+        rx.txAntennaGain = txAntennaGain;
+        rx.delay = delay;
+        m_pendingRx.push_back(std::move(rx));
+        return;
+    }
+
+    if (rxNetDevice)
+    {
+        // the receiver has a NetDevice, so we expect that it is attached to a Node
+        auto dstNode = rxNetDevice->GetNode()->GetId();
+        Simulator::ScheduleWithContext(dstNode,
+                                       delay,
+                                       &MultiModelSpectrumChannel::StartRx,
+                                       this,
+                                       txParams->psd,
+                                       txAntennaGain,
+                                       rxParams,
+                                       receiver,
+                                       convertedPsds);
+    }
+    else
+    {
+        // the receiver is not attached to a NetDevice, so we cannot assume that it is
+        // attached to a node
+        Simulator::Schedule(delay,
+                            &MultiModelSpectrumChannel::StartRx,
+                            this,
+                            txParams->psd,
+                            txAntennaGain,
+                            rxParams,
+                            receiver,
+                            convertedPsds);
+    }
 }
 
 void
@@ -424,76 +539,209 @@ MultiModelSpectrumChannel::StartRx(
         }
     }
 
-    auto txMobility = params->txMobility;
-    auto rxMobility = receiver->GetMobility();
-    if (txMobility && rxMobility)
+    PendingRx rx;
+    rx.receiver = receiver;
+    rx.params = params;
+    rx.txAntennaGain = txAntennaGain;
+    rx.txMobility = params->txMobility;
+    CalcRxGains(rx);
+    if (rx.located)
     {
-        auto pathLossDb{-txAntennaGain};
-        auto rxAntennaGain{0.0};
-        auto propagationGainDb{0.0};
+        // Gain trace
+        m_gainTrace(rx.txMobility,
+                    receiver->GetMobility(),
+                    txAntennaGain,
+                    rx.rxAntennaGain,
+                    rx.propagationGainDb,
+                    rx.pathLossDb);
 
-        if (auto rxAntenna = DynamicCast<AntennaModel>(receiver->GetAntenna()))
-        {
-            Angles rxAngles(txMobility->GetPosition(), rxMobility->GetPosition());
-            rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
-            NS_LOG_LOGIC("rxAntennaGain = " << rxAntennaGain << " dB");
-            pathLossDb -= rxAntennaGain;
-        }
+        // Pathloss trace
+        m_pathLossTrace(params->txPhy, receiver, rx.pathLossDb);
 
-        if (m_propagationLoss && (txMobility->GetPosition() != rxMobility->GetPosition()))
+        if (!rx.inRange)
         {
-            propagationGainDb = m_propagationLoss->CalcRxPower(0, txMobility, rxMobility);
-            NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
-            pathLossDb -= propagationGainDb;
+            // beyond range
+            return;
         }
 
-        NS_LOG_LOGIC("total pathLoss = " << pathLossDb << " dB");
+        PrepareRxPsd(rx);
+        params = rx.task ? rx.task() : rx.params;
+    }
 
-        // Gain trace
-        m_gainTrace(txMobility,
-                    rxMobility,
-                    txAntennaGain,
-                    rxAntennaGain,
-                    propagationGainDb,
-                    pathLossDb);
+    receiver->StartRx(params);
+}
 
-        // Pathloss trace
-        m_pathLossTrace(params->txPhy, receiver, pathLossDb);
+void
+MultiModelSpectrumChannel::CalcRxGains(PendingRx& rx)
+{
+    auto txMobility = rx.txMobility;
+    auto rxMobility = rx.receiver->GetMobility();
+    rx.located = txMobility && rxMobility;
+    if (!rx.located)
+    {
+        return;
+    }
+
+    rx.pathLossDb = -rx.txAntennaGain;
+    if (auto rxAntenna = DynamicCast<AntennaModel>(rx.receiver->GetAntenna()))
+    {
+        Angles rxAngles(txMobility->GetPosition(), rxMobility->GetPosition());
+        rx.rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
+        NS_LOG_LOGIC("rxAntennaGain = " << rx.rxAntennaGain << " dB");
+        rx.pathLossDb -= rx.rxAntennaGain;
+    }
+
+    if (m_propagationLoss && (txMobility->GetPosition() != rxMobility->GetPosition()))
+    {
+        rx.propagationGainDb = m_propagationLoss->CalcRxPower(0, txMobility, rxMobility);
+        NS_LOG_LOGIC("propagationGainDb = " << rx.propagationGainDb << " dB");
+        rx.pathLossDb -= rx.propagationGainDb;
+    }
+
+    NS_LOG_LOGIC("total pathLoss = " << rx.pathLossDb << " dB");
+    rx.inRange = (rx.pathLossDb <= m_maxLossDb);
+}
+
+void
+MultiModelSpectrumChannel::PrepareRxPsd(PendingRx& rx)
+{
+    const auto pathLossLinear = std::pow(10.0, (-rx.pathLossDb) / 10.0);
+    *(rx.params->psd) *= pathLossLinear;
+
+    auto rxMobility = rx.receiver->GetMobility();
+    if (m_spectrumPropagationLoss)
+    {
+        rx.params->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity(rx.params,
+                                                                              rx.txMobility,
+                                                                              rxMobility);
+    }
+    else if (m_phasedArraySpectrumPropagationLoss)
+    {
+        auto txPhasedArrayModel = DynamicCast<PhasedArrayModel>(rx.params->txPhy->GetAntenna());
+        auto rxPhasedArrayModel = DynamicCast<PhasedArrayModel>(rx.receiver->GetAntenna());
+
+        NS_ASSERT_MSG(txPhasedArrayModel && rxPhasedArrayModel,
+                      "PhasedArrayModel instances should be installed at both TX and RX "
+                      "SpectrumPhy in order to use PhasedArraySpectrumPropagationLoss.");
+
+        rx.task = m_phasedArraySpectrumPropagationLoss->PrepareRxPowerSpectralDensity(
+            rx.params,
+            rx.txMobility,
+            rxMobility,
+            txPhasedArrayModel,
+            rxPhasedArrayModel);
+    }
+}
+
+void
+MultiModelSpectrumChannel::ComputePendingRx(
+    Ptr<SpectrumValue> txPsd,
+    const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& convertedPsds)
+{
+    NS_LOG_FUNCTION(this << m_pendingRx.size());
 
-        if (pathLossDb > m_maxLossDb)
+    // everything which updates the state of the models runs here, in order
+    for (auto& rx : m_pendingRx)
+    {
+        rx.txMobility = rx.params->txMobility;
+        CalcRxGains(rx);
+        if (rx.located && rx.inRange)
         {
-            // beyond range
-            return;
+            PrepareRxPsd(rx);
         }
+    }
 
-        const auto pathLossLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-        *(params->psd) *= pathLossLinear;
+    // the tasks only write their own signal parameters; the results are
+    // collected in a separate field, so that no shared object is released
+    // on a worker thread
+    const auto nThreads = std::min<std::size_t>(m_rxThreads, m_pendingRx.size());
+    auto work = [this, nThreads](std::size_t thread) {
+        for (auto i = thread; i < m_pendingRx.size(); i += nThreads)
+        {
+            auto& rx = m_pendingRx[i];
+            if (rx.task)
+            {
+                rx.result = rx.task();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < nThreads; ++t)
+    {
+        threads.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
 
-        if (m_spectrumPropagationLoss)
+    for (auto& rx : m_pendingRx)
+    {
+        if (rx.task)
         {
-            params->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity(params,
-                                                                                txMobility,
-                                                                                rxMobility);
+            rx.task = nullptr;
+            rx.params = std::move(rx.result);
         }
-        else if (m_phasedArraySpectrumPropagationLoss)
+        if (auto rxNetDevice = rx.receiver->GetDevice())
         {
-            auto txPhasedArrayModel = DynamicCast<PhasedArrayModel>(params->txPhy->GetAntenna());
-            auto rxPhasedArrayModel = DynamicCast<PhasedArrayModel>(receiver->GetAntenna());
-
-            NS_ASSERT_MSG(txPhasedArrayModel && rxPhasedArrayModel,
-                          "PhasedArrayModel instances should be installed at both TX and RX "
-                          "SpectrumPhy in order to use PhasedArraySpectrumPropagationLoss.");
-
-            params = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity(
-                params,
-                txMobility,
-                rxMobility,
-                txPhasedArrayModel,
-                rxPhasedArrayModel);
+            // the receiver has a NetDevice, so we expect that it is attached to a Node
+            auto dstNode = rxNetDevice->GetNode()->GetId();
+            Simulator::ScheduleWithContext(dstNode,
+                                           rx.delay,
+                                           &MultiModelSpectrumChannel::DeliverRx,
+                                           this,
+                                           txPsd,
+                                           rx,
+                                           convertedPsds);
+        }
+        else
+        {
+            Simulator::Schedule(rx.delay,
+                                &MultiModelSpectrumChannel::DeliverRx,
+                                this,
+                                txPsd,
+                                rx,
+                                convertedPsds);
         }
     }
+    m_pendingRx.clear();
+}
 
-    receiver->StartRx(params);
+void
+MultiModelSpectrumChannel::DeliverRx(
+    Ptr<SpectrumValue> txPsd,
+    PendingRx rx,
+    const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& availableConvertedPsds)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (rx.params->psd->GetSpectrumModelUid() != rx.receiver->GetRxSpectrumModel()->GetUid())
+    {
+        NS_LOG_LOGIC("SpectrumModelUid changed since TX started");
+        rx.params->txMobility = rx.txMobility;
+        StartRx(txPsd, rx.txAntennaGain, rx.params, rx.receiver, availableConvertedPsds);
+        return;
+    }
+
+    if (rx.located)
+    {
+        m_gainTrace(rx.txMobility,
+                    rx.receiver->GetMobility(),
+                    rx.txAntennaGain,
+                    rx.rxAntennaGain,
+                    rx.propagationGainDb,
+                    rx.pathLossDb);
+        m_pathLossTrace(rx.params->txPhy, rx.receiver, rx.pathLossDb);
+
+        if (!rx.inRange)
+        {
+            // beyond range
+            return;
+        }
+    }
+
+    rx.receiver->StartRx(rx.params);
 }
 
 std::size_t
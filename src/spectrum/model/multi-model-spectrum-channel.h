@@ -15,13 +15,17 @@
 #include "spectrum-value.h"
 
 #include "ns3/propagation-delay-model.h"
+#include "ns3/spatial-grid.h"
 
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3
 {
 
+class WraparoundModel;
+
 /**
  * @ingroup spectrum
  * Container: SpectrumModelUid_t, SpectrumConverter
@@ -113,6 +117,26 @@ class MultiModelSpectrumChannel : public SpectrumChannel
     void DoDispose() override;
 
   private:
+    /**
+     * The signal for one receiver, while it is being computed.
+     */
+    struct PendingRx
+    {
+        Ptr<SpectrumPhy> receiver;            //!< The receiver
+        Ptr<SpectrumSignalParameters> params; //!< The signal parameters at the receiver
+        double txAntennaGain{0};              //!< The TX antenna gain, in dB
+        Time delay{0};                        //!< The propagation delay
+        Ptr<MobilityModel> txMobility;        //!< The TX MobilityModel, maybe a virtual one
+        bool located{false};                  //!< Whether the path loss was computed
+        bool inRange{true};                   //!< Whether the path loss is within m_maxLossDb
+        double rxAntennaGain{0};              //!< The RX antenna gain, in dB
+        double propagationGainDb{0};          //!< The propagation gain, in dB
+        double pathLossDb{0};                 //!< The total path loss, in dB
+        /// The computation of the spectrum propagation loss left to run, if any
+        PhasedArraySpectrumPropagationLossModel::RxPsdTask task;
+        Ptr<SpectrumSignalParameters> result; //!< The signal parameters computed by task
+    };
+
     /**
      * This method checks if m_rxSpectrumModelInfoMap contains an entry
      * for the given TX SpectrumModel. If such entry exists, it returns
@@ -142,6 +166,78 @@ class MultiModelSpectrumChannel : public SpectrumChannel
         Ptr<SpectrumPhy> receiver,
         const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& availableConvertedPsds);
 
+    /**
+     * Compute the antenna gains and the propagation loss between the
+     * transmitter and a receiver.  This sets the located, inRange and gain
+     * fields of the PendingRx.
+     *
+     * @param rx The signal for the receiver, with the receiver, params,
+     *           txAntennaGain and txMobility fields set.
+     */
+    void CalcRxGains(PendingRx& rx);
+
+    /**
+     * Apply the path loss to the PSD of a signal in range, and prepare the
+     * spectrum propagation loss.  The computation of a
+     * PhasedArraySpectrumPropagationLossModel is left in the task field.
+     *
+     * @param rx The signal for the receiver, after CalcRxGains.
+     */
+    void PrepareRxPsd(PendingRx& rx);
+
+    /**
+     * Compute the signals collected in m_pendingRx by StartTx, the part of
+     * the computation which only reads the state of the models on m_rxThreads
+     * threads, then schedule DeliverRx for each of them, in order.
+     *
+     * @param txPsd The transmitted PSD.
+     * @param convertedPsds The TX PSD converted to each RX SpectrumModel.
+     */
+    void ComputePendingRx(Ptr<SpectrumValue> txPsd,
+                          const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& convertedPsds);
+
+    /**
+     * Used internally to deliver a signal computed by ComputePendingRx after
+     * the propagation delay.  If the receiver changed its SpectrumModel in the
+     * meantime, the signal is computed again by StartRx.
+     *
+     * @param txPsd The transmitted PSD.
+     * @param rx The signal for the receiver.
+     * @param availableConvertedPsds available converted PSDs from the TX PSD.
+     */
+    void DeliverRx(Ptr<SpectrumValue> txPsd,
+                   PendingRx rx,
+                   const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& availableConvertedPsds);
+
+    /**
+     * Used internally by StartTx to copy the signal parameters for a receiver
+     * and schedule StartRx after the propagation delay, or add the signal to
+     * m_pendingRx if m_rxThreads is set.
+     *
+     * @param txParams The signal parameters of the transmission.
+     * @param receiver A pointer to the receiver SpectrumPhy.
+     * @param rxSpectrumModelUid The uid of the RX SpectrumModel of the receiver.
+     * @param convertedPsds The TX PSD converted to each RX SpectrumModel.
+     * @param wraparound The WraparoundModel aggregated to the channel, if any.
+     */
+    void ScheduleRx(Ptr<SpectrumSignalParameters> txParams,
+                    Ptr<SpectrumPhy> receiver,
+                    SpectrumModelUid_t rxSpectrumModelUid,
+                    const std::map<SpectrumModelUid_t, Ptr<SpectrumValue>>& convertedPsds,
+                    Ptr<WraparoundModel> wraparound);
+
+    /**
+     * Set the range beyond which receivers do not get the transmissions.
+     *
+     * @param maxRange The range in meters, or 0 to disable the culling.
+     */
+    void SetMaxRange(double maxRange);
+
+    /**
+     * Index all the receivers in m_grid, in the order StartTx visits them.
+     */
+    void RebuildGrid();
+
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
      * converters to any RX SpectrumModel, and all the corresponding
@@ -160,6 +256,30 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    double m_maxRange; //!< Range beyond which receivers are skipped, 0 if disabled
+
+    /**
+     * Positions of the receivers, indexed by their rank in m_gridPhys, when
+     * m_maxRange is set.
+     */
+    SpatialGrid m_grid;
+
+    /**
+     * The RX SpectrumModel uid and the SpectrumPhy of each receiver indexed
+     * in m_grid, in the order StartTx visits them without culling.
+     */
+    std::vector<std::pair<SpectrumModelUid_t, Ptr<SpectrumPhy>>> m_gridPhys;
+
+    bool m_gridStale; //!< Whether receivers were added or removed since m_grid was built
+
+    /**
+     * Number of threads which compute the signals for the receivers when a
+     * transmission starts, 0 to compute each signal when it reaches its receiver.
+     */
+    uint32_t m_rxThreads;
+
+    std::vector<PendingRx> m_pendingRx; //!< Signals of the transmission being started
 };
 
 } // namespace ns3
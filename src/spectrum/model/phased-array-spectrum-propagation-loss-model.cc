@@ -77,6 +77,37 @@ PhasedArraySpectrumPropagationLossModel::CalcRxPowerSpectralDensity(
     return rxParams;
 }
 
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+PhasedArraySpectrumPropagationLossModel::PrepareRxPowerSpectralDensity(
+    Ptr<const SpectrumSignalParameters> params,
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+    if (m_next)
+    {
+        // the chain is computed as a whole
+        auto rxParams =
+            CalcRxPowerSpectralDensity(params, a, b, aPhasedArrayModel, bPhasedArrayModel);
+        return [rxParams]() { return rxParams; };
+    }
+    return DoPrepareRxPowerSpectralDensity(params, a, b, aPhasedArrayModel, bPhasedArrayModel);
+}
+
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+PhasedArraySpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity(
+    Ptr<const SpectrumSignalParameters> params,
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+    auto rxParams =
+        DoCalcRxPowerSpectralDensity(params, a, b, aPhasedArrayModel, bPhasedArrayModel);
+    return [rxParams]() { return rxParams; };
+}
+
 int64_t
 PhasedArraySpectrumPropagationLossModel::AssignStreams(int64_t stream)
 {
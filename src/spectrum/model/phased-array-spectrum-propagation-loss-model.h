@@ -14,6 +14,8 @@
 #include "ns3/object.h"
 #include "ns3/phased-array-model.h"
 
+#include <functional>
+
 namespace ns3
 {
 
@@ -34,6 +36,14 @@ struct SpectrumSignalParameters;
 class PhasedArraySpectrumPropagationLossModel : public Object
 {
   public:
+    /**
+     * The part of the computation of a received signal which is left to do
+     * once PrepareRxPowerSpectralDensity has updated the state of the model.
+     * The task only reads the state of the model and only writes the objects
+     * it creates, so tasks of different receivers may run on parallel threads.
+     */
+    using RxPsdTask = std::function<Ptr<SpectrumSignalParameters>()>;
+
     PhasedArraySpectrumPropagationLossModel();
     ~PhasedArraySpectrumPropagationLossModel() override;
 
@@ -78,6 +88,27 @@ class PhasedArraySpectrumPropagationLossModel : public Object
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
 
+    /**
+     * Split the work of CalcRxPowerSpectralDensity in two steps: this method
+     * updates the state of the model, such as the channel realizations and
+     * random variables, and the returned task computes the received signal.
+     * Running the task at once gives the same result as
+     * CalcRxPowerSpectralDensity.  The parameters are the ones of
+     * CalcRxPowerSpectralDensity.
+     *
+     * @param txPsd the spectrum signal parameters.
+     * @param a sender mobility
+     * @param b receiver mobility
+     * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+     * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+     * @return the task which computes the received signal parameters
+     */
+    RxPsdTask PrepareRxPowerSpectralDensity(Ptr<const SpectrumSignalParameters> txPsd,
+                                            Ptr<const MobilityModel> a,
+                                            Ptr<const MobilityModel> b,
+                                            Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                            Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
     /**
      * If this loss model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -103,6 +134,25 @@ class PhasedArraySpectrumPropagationLossModel : public Object
      */
     virtual int64_t DoAssignStreams(int64_t stream) = 0;
 
+    /**
+     * Update the state of the model for a received signal, and return the
+     * rest of the computation, see PrepareRxPowerSpectralDensity.  The default
+     * implementation does the whole computation at once.
+     *
+     * @param params the spectrum signal parameters.
+     * @param a sender mobility
+     * @param b receiver mobility
+     * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+     * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+     * @return the task which computes the received signal parameters
+     */
+    virtual RxPsdTask DoPrepareRxPowerSpectralDensity(
+        Ptr<const SpectrumSignalParameters> params,
+        Ptr<const MobilityModel> a,
+        Ptr<const MobilityModel> b,
+        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+        Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
   private:
     /**
      *
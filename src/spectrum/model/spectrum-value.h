@@ -544,6 +544,87 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     friend double Integral(const SpectrumValue& arg);
 
+    /**
+     * @name Operators on temporaries
+     *
+     * These overloads are picked when the left hand side is a temporary, as
+     * in a * b + c, and compute the result in the storage of the
+     * temporary instead of allocating a new one.  They return the same
+     * values as the overloads taking a const reference.
+     * @{
+     */
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs + rhs
+     */
+    friend SpectrumValue operator+(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs + rhs
+     */
+    friend SpectrumValue operator+(SpectrumValue&& lhs, double rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs - rhs
+     */
+    friend SpectrumValue operator-(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs - rhs
+     */
+    friend SpectrumValue operator-(SpectrumValue&& lhs, double rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs * rhs
+     */
+    friend SpectrumValue operator*(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs * rhs
+     */
+    friend SpectrumValue operator*(SpectrumValue&& lhs, double rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs * rhs
+     */
+    friend SpectrumValue operator*(double lhs, SpectrumValue&& rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs / rhs
+     */
+    friend SpectrumValue operator/(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    /**
+     * @param lhs Left Hand Side of the operator
+     * @param rhs Right Hand Side of the operator
+     * @return the value of lhs / rhs
+     */
+    friend SpectrumValue operator/(SpectrumValue&& lhs, double rhs);
+    /**
+     * @param rhs Right Hand Side of the operator
+     * @return the value of -rhs
+     */
+    friend SpectrumValue operator-(SpectrumValue&& rhs);
+    /**
+     * @param lhs the base
+     * @param rhs the exponent
+     * @return each value in base raised to the exponent
+     */
+    friend SpectrumValue Pow(SpectrumValue&& lhs, double rhs);
+    /**
+     * @param arg the argument
+     * @return the logarithm in base 10 of all values in the argument
+     */
+    friend SpectrumValue Log10(SpectrumValue&& arg);
+    /** @} */
+
     /**
      *
      * @return a Ptr to a copy of this instance
@@ -665,6 +746,18 @@ SpectrumValue Log10(const SpectrumValue& arg);
 SpectrumValue Log2(const SpectrumValue& arg);
 SpectrumValue Log(const SpectrumValue& arg);
 double Integral(const SpectrumValue& arg);
+SpectrumValue operator+(SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator+(SpectrumValue&& lhs, double rhs);
+SpectrumValue operator-(SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator-(SpectrumValue&& lhs, double rhs);
+SpectrumValue operator*(SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator*(SpectrumValue&& lhs, double rhs);
+SpectrumValue operator*(double lhs, SpectrumValue&& rhs);
+SpectrumValue operator/(SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator/(SpectrumValue&& lhs, double rhs);
+SpectrumValue operator-(SpectrumValue&& rhs);
+SpectrumValue Pow(SpectrumValue&& lhs, double rhs);
+SpectrumValue Log10(SpectrumValue&& arg);
 
 } // namespace ns3
 
@@ -2511,6 +2511,12 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     // get the 3GPP parameters
     Ptr<const ParamsTable> table3gpp = GetThreeGppTable(aMob, bMob, condition);
 
+    if (notFoundParams && !m_updatePeriod.IsZero() &&
+        Simulator::Now() - m_lastRemoval > m_updatePeriod)
+    {
+        RemoveStaleChannels();
+    }
+
     if (notFoundParams || updateParams)
     {
         // Step 4: Generate large scale parameters. All LSPS are uncorrelated.
@@ -2578,6 +2584,41 @@ ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const Mobilit
     }
 }
 
+Time
+ThreeGppChannelModel::GetCoherenceTime() const
+{
+    return m_updatePeriod;
+}
+
+void
+ThreeGppChannelModel::RemoveStaleChannels()
+{
+    NS_LOG_FUNCTION(this);
+    m_lastRemoval = Simulator::Now();
+    for (auto it = m_channelParamsMap.begin(); it != m_channelParamsMap.end();)
+    {
+        if (Simulator::Now() - it->second->m_generatedTime > m_updatePeriod)
+        {
+            it = m_channelParamsMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    for (auto it = m_channelMatrixMap.begin(); it != m_channelMatrixMap.end();)
+    {
+        if (Simulator::Now() - it->second->m_generatedTime > m_updatePeriod)
+        {
+            it = m_channelMatrixMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
 ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition> channelCondition,
                                                 const Ptr<const ParamsTable> table3gpp,
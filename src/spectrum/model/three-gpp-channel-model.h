@@ -118,6 +118,12 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      */
     Ptr<const ChannelParams> GetParams(Ptr<const MobilityModel> aMob,
                                        Ptr<const MobilityModel> bMob) const override;
+
+    /**
+     * @return the "UpdatePeriod" of the model
+     */
+    Time GetCoherenceTime() const override;
+
     /**
      * @brief Assign a fixed random variable stream number to the random variables
      * used by this model.
@@ -329,6 +335,12 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                              Ptr<const PhasedArrayModel> bAntenna,
                              Ptr<const ChannelMatrix> channelMatrix);
 
+    /**
+     * Remove from m_channelParamsMap and m_channelMatrixMap the channels
+     * older than the update period, which would be generated again anyway.
+     */
+    void RemoveStaleChannels();
+
     std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
         m_channelMatrixMap; //!< map containing the channel realizations per pair of
                             //!< PhasedAntennaArray instances, the key of this map is reciprocal
@@ -338,6 +350,7 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                             //!< key of this map is reciprocal and uniquely identifies a pair of
                             //!< nodes
     Time m_updatePeriod;    //!< the channel update period
+    Time m_lastRemoval;     //!< the last time the stale channels were removed
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
     Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
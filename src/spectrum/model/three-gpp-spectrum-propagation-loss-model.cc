@@ -193,12 +193,14 @@ ThreeGppSpectrumPropagationLossModel::CalculateLongTermComponent(
     return txSum;
 }
 
-Ptr<SpectrumSignalParameters>
+void
 ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
-    Ptr<const SpectrumSignalParameters> params,
-    Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
-    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    SpectrumSignalParameters& rxParams,
+    const MatrixBasedChannelModel::Complex3DVector& longTerm,
+    const MatrixBasedChannelModel::ChannelMatrix& channelMatrix,
+    const MatrixBasedChannelModel::ChannelParams& channelParams,
+    ComplexMatrixArray delaySincos,
+    double slotTime,
     const Vector& sSpeed,
     const ns3::Vector& uSpeed,
     uint8_t numTxPorts,
@@ -206,28 +208,27 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     bool isReverse) const
 
 {
-    NS_LOG_FUNCTION(this);
-    Ptr<SpectrumSignalParameters> rxParams = params->Copy();
-    size_t numCluster = channelMatrix->m_channel.GetNumPages();
+    // This function may run on a worker thread: it must neither log nor copy
+    // the smart pointers it reaches, whose reference counts are not atomic.
+    size_t numCluster = channelMatrix.m_channel.GetNumPages();
     // compute the doppler term
     // NOTE the update of Doppler is simplified by only taking the center angle of
     // each cluster in to consideration.
-    double slotTime = Simulator::Now().GetSeconds();
     double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
     PhasedArrayModel::ComplexVector doppler(numCluster);
 
     // Make sure that all the structures that are passed to this function
     // are of the correct dimensions before using the operator [].
-    NS_ASSERT(numCluster <= channelParams->m_alpha.size());
-    NS_ASSERT(numCluster <= channelParams->m_D.size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
-    NS_ASSERT(numCluster <= longTerm->GetNumPages());
+    NS_ASSERT(numCluster <= channelParams.m_alpha.size());
+    NS_ASSERT(numCluster <= channelParams.m_D.size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
+    NS_ASSERT(numCluster <= longTerm.GetNumPages());
 
     // check if channelParams structure is generated in direction s-to-u or u-to-s
-    bool isSameDir = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
+    bool isSameDir = (channelParams.m_nodeIds == channelMatrix.m_nodeIds);
 
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith of departure and arrival are ok,
@@ -235,7 +236,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
     using DPV = std::vector<std::pair<double, double>>;
     using MBCM = MatrixBasedChannelModel;
-    const auto& cachedAngleSincos = channelParams->m_cachedAngleSincos;
+    const auto& cachedAngleSincos = channelParams.m_cachedAngleSincos;
     const DPV& zoa = cachedAngleSincos[isSameDir ? MBCM::ZOA_INDEX : MBCM::ZOD_INDEX];
     const DPV& zod = cachedAngleSincos[isSameDir ? MBCM::ZOD_INDEX : MBCM::ZOA_INDEX];
     const DPV& aoa = cachedAngleSincos[isSameDir ? MBCM::AOA_INDEX : MBCM::AOD_INDEX];
@@ -254,8 +255,8 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
         // By default, m_vScatt is set to 0, so there is no additional Doppler
         // contribution.
 
-        double alpha = channelParams->m_alpha[cIndex];
-        double D = channelParams->m_D[cIndex];
+        double alpha = channelParams.m_alpha[cIndex];
+        double D = channelParams.m_D[cIndex];
 
         // cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
         double tempDoppler =
@@ -271,43 +272,41 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     NS_ASSERT(numCluster <= doppler.GetSize());
 
     // set the channel matrix
-    rxParams->spectrumChannelMatrix = GenSpectrumChannelMatrix(rxParams->psd,
-                                                               longTerm,
-                                                               channelMatrix,
-                                                               channelParams,
-                                                               doppler,
-                                                               numTxPorts,
-                                                               numRxPorts,
-                                                               isReverse);
-
-    NS_ASSERT_MSG(rxParams->psd->GetValuesN() == rxParams->spectrumChannelMatrix->GetNumPages(),
+    rxParams.spectrumChannelMatrix = GenSpectrumChannelMatrix(*rxParams.psd,
+                                                              longTerm,
+                                                              std::move(delaySincos),
+                                                              doppler,
+                                                              numTxPorts,
+                                                              numRxPorts,
+                                                              isReverse);
+
+    NS_ASSERT_MSG(rxParams.psd->GetValuesN() == rxParams.spectrumChannelMatrix->GetNumPages(),
                   "RX PSD and the spectrum channel matrix should have the same number of RBs ");
 
     // Calculate RX PSD from the spectrum channel matrix H and
     // the precoding matrix P as: PSD = (H*P)^h * (H*P)
-    Ptr<const ComplexMatrixArray> p;
-    if (!rxParams->precodingMatrix)
+    // When we have the precoding matrix P, we first do
+    // H(rxPorts,txPorts,numRbs) x P(txPorts,txStreams,numRbs) = HxP(rxPorts,txStreams,numRbs)
+    MatrixBasedChannelModel::Complex3DVector hP;
+    if (!rxParams.precodingMatrix)
     {
         // When the precoding matrix P is not set, we create one with a single column
         ComplexMatrixArray page =
-            ComplexMatrixArray(rxParams->spectrumChannelMatrix->GetNumCols(), 1, 1);
+            ComplexMatrixArray(rxParams.spectrumChannelMatrix->GetNumCols(), 1, 1);
         // Initialize it to the inverse square of the number of txPorts
-        page.Elem(0, 0, 0) = 1.0 / sqrt(rxParams->spectrumChannelMatrix->GetNumCols());
-        for (size_t rowI = 0; rowI < rxParams->spectrumChannelMatrix->GetNumCols(); rowI++)
+        page.Elem(0, 0, 0) = 1.0 / sqrt(rxParams.spectrumChannelMatrix->GetNumCols());
+        for (size_t rowI = 0; rowI < rxParams.spectrumChannelMatrix->GetNumCols(); rowI++)
         {
             page.Elem(rowI, 0, 0) = page.Elem(0, 0, 0);
         }
         // Replicate vector to match the number of RBGs
-        p = Create<const ComplexMatrixArray>(
-            page.MakeNCopies(rxParams->spectrumChannelMatrix->GetNumPages()));
+        hP = *rxParams.spectrumChannelMatrix *
+             page.MakeNCopies(rxParams.spectrumChannelMatrix->GetNumPages());
     }
     else
     {
-        p = rxParams->precodingMatrix;
+        hP = *rxParams.spectrumChannelMatrix * *rxParams.precodingMatrix;
     }
-    // When we have the precoding matrix P, we first do
-    // H(rxPorts,txPorts,numRbs) x P(txPorts,txStreams,numRbs) = HxP(rxPorts,txStreams,numRbs)
-    MatrixBasedChannelModel::Complex3DVector hP = *rxParams->spectrumChannelMatrix * *p;
 
     // Then (HxP)^h dimensions are (txStreams, rxPorts, numRbs)
     // MatrixBasedChannelModel::Complex3DVector hPHerm = hP.HermitianTranspose();
@@ -317,40 +316,29 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
 
     // And the received psd is the Trace(PSD).
     // To avoid wasting computations, we only compute the main diagonal of hPHerm*hP
-    for (uint32_t rbIdx = 0; rbIdx < rxParams->psd->GetValuesN(); ++rbIdx)
+    for (uint32_t rbIdx = 0; rbIdx < rxParams.psd->GetValuesN(); ++rbIdx)
     {
-        (*rxParams->psd)[rbIdx] = 0.0;
+        (*rxParams.psd)[rbIdx] = 0.0;
         for (size_t rxPort = 0; rxPort < hP.GetNumRows(); ++rxPort)
         {
             for (size_t txStream = 0; txStream < hP.GetNumCols(); ++txStream)
             {
-                (*rxParams->psd)[rbIdx] +=
+                (*rxParams.psd)[rbIdx] +=
                     std::real(std::conj(hP(rxPort, txStream, rbIdx)) * hP(rxPort, txStream, rbIdx));
             }
         }
     }
-    return rxParams;
 }
 
-Ptr<MatrixBasedChannelModel::Complex3DVector>
-ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
-    Ptr<SpectrumValue> inPsd,
-    Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
+ComplexMatrixArray
+ThreeGppSpectrumPropagationLossModel::GetDelaySincos(
+    Ptr<const SpectrumValue> inPsd,
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-    PhasedArrayModel::ComplexVector doppler,
-    uint8_t numTxPorts,
-    uint8_t numRxPorts,
-    bool isReverse) const
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams) const
 {
     size_t numCluster = channelMatrix->m_channel.GetNumPages();
     auto numRb = inPsd->GetValuesN();
 
-    auto directionalLongTerm = isReverse ? longTerm->Transpose() : (*longTerm);
-
-    Ptr<MatrixBasedChannelModel::Complex3DVector> chanSpct =
-        Create<MatrixBasedChannelModel::Complex3DVector>(numRxPorts, numTxPorts, (uint16_t)numRb);
-
     // Precompute the delay until numRb, numCluster or RB width changes
     // Whenever the channelParams is updated, the number of numRbs, numClusters
     // and RB width (12*SCS) are reset, ensuring these values are updated too
@@ -375,14 +363,33 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
             sbit++;
         }
     }
+    return channelParams->m_cachedDelaySincos;
+}
+
+Ptr<MatrixBasedChannelModel::Complex3DVector>
+ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
+    const SpectrumValue& inPsd,
+    const MatrixBasedChannelModel::Complex3DVector& longTerm,
+    ComplexMatrixArray delaySincos,
+    const PhasedArrayModel::ComplexVector& doppler,
+    uint8_t numTxPorts,
+    uint8_t numRxPorts,
+    bool isReverse) const
+{
+    size_t numCluster = delaySincos.GetNumCols();
+    auto numRb = inPsd.GetValuesN();
+
+    auto directionalLongTerm = isReverse ? longTerm.Transpose() : longTerm;
+
+    Ptr<MatrixBasedChannelModel::Complex3DVector> chanSpct =
+        Create<MatrixBasedChannelModel::Complex3DVector>(numRxPorts, numTxPorts, (uint16_t)numRb);
 
     // Compute the product between the doppler and the delay sincos
-    auto delaySincosCopy = channelParams->m_cachedDelaySincos;
-    for (size_t iRb = 0; iRb < inPsd->GetValuesN(); iRb++)
+    for (size_t iRb = 0; iRb < numRb; iRb++)
     {
         for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
         {
-            delaySincosCopy(iRb, cIndex) *= doppler[cIndex];
+            delaySincos(iRb, cIndex) *= doppler[cIndex];
         }
     }
 
@@ -390,10 +397,10 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
     // is a DL transmission but params and longTerm were last updated during UL), then the elements
     // in longTerm start from different offsets.
 
-    auto vit = inPsd->ValuesBegin(); // psd iterator
+    auto vit = inPsd.ConstValuesBegin(); // psd iterator
     size_t iRb = 0;
     // Compute the frequency-domain channel matrix
-    while (vit != inPsd->ValuesEnd())
+    while (vit != inPsd.ConstValuesEnd())
     {
         if ((*vit) != 0.00)
         {
@@ -406,7 +413,7 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
                     for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
                     {
                         subsbandGain += directionalLongTerm(rxPortIdx, txPortIdx, cIndex) *
-                                        delaySincosCopy(iRb, cIndex);
+                                        delaySincos(iRb, cIndex);
                     }
                     // Multiply with the square root of the input PSD so that the norm (absolute
                     // value squared) of chanSpct will be the output PSD
@@ -475,6 +482,24 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm(
         notFound = true;
     }
 
+    Time coherenceTime = m_channelModel->GetCoherenceTime();
+    if (notFound && !coherenceTime.IsZero() && Simulator::Now() - m_lastRemoval > coherenceTime)
+    {
+        // the long terms of the channels older than the coherence time would be computed again
+        m_lastRemoval = Simulator::Now();
+        for (auto it = m_longTermMap.begin(); it != m_longTermMap.end();)
+        {
+            if (Simulator::Now() - it->second->m_channel->m_generatedTime > coherenceTime)
+            {
+                it = m_longTermMap.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
     if (update || notFound)
     {
         NS_LOG_DEBUG("compute the long term");
@@ -501,6 +526,21 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     Ptr<const MobilityModel> b,
     Ptr<const PhasedArrayModel> aPhasedArrayModel,
     Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+    return DoPrepareRxPowerSpectralDensity(spectrumSignalParams,
+                                           a,
+                                           b,
+                                           aPhasedArrayModel,
+                                           bPhasedArrayModel)();
+}
+
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+ThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity(
+    Ptr<const SpectrumSignalParameters> spectrumSignalParams,
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
     NS_LOG_FUNCTION(this << spectrumSignalParams << a << b << aPhasedArrayModel
                          << bPhasedArrayModel);
@@ -524,16 +564,38 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     auto isReverse =
         channelMatrix->IsReverse(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
 
+    // the signal parameters are copied here, so that the task only writes
+    // the objects it owns
+    Ptr<SpectrumSignalParameters> rxParams = spectrumSignalParams->Copy();
+    rxParams->spectrumChannelMatrix = nullptr;
+    auto delaySincos = GetDelaySincos(rxParams->psd, channelMatrix, channelParams);
+
     // apply the beamforming gain
-    return CalcBeamformingGain(spectrumSignalParams,
-                               longTerm,
-                               channelMatrix,
-                               channelParams,
-                               a->GetVelocity(),
-                               b->GetVelocity(),
-                               aPhasedArrayModel->GetNumPorts(),
-                               bPhasedArrayModel->GetNumPorts(),
-                               isReverse);
+    return [this,
+            rxParams,
+            longTerm,
+            channelMatrix,
+            channelParams,
+            delaySincos = std::move(delaySincos),
+            slotTime = Simulator::Now().GetSeconds(),
+            sSpeed = a->GetVelocity(),
+            uSpeed = b->GetVelocity(),
+            numTxPorts = aPhasedArrayModel->GetNumPorts(),
+            numRxPorts = bPhasedArrayModel->GetNumPorts(),
+            isReverse]() mutable {
+        CalcBeamformingGain(*rxParams,
+                            *longTerm,
+                            *channelMatrix,
+                            *channelParams,
+                            std::move(delaySincos),
+                            slotTime,
+                            sSpeed,
+                            uSpeed,
+                            numTxPorts,
+                            numRxPorts,
+                            isReverse);
+        return rxParams;
+    };
 }
 
 int64_t
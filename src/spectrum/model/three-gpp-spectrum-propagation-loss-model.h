@@ -121,6 +121,28 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
+    /**
+     * @brief Prepares the computation of the received PSD.
+     *
+     * This function retrieves the channel matrix and the long term component
+     * between node a and node b, which may update the channel realizations,
+     * and returns the computation of the Doppler, delay and beamforming terms
+     * for each resource block, which only reads them.
+     *
+     * @param spectrumSignalParams spectrum signal tx parameters
+     * @param a first node mobility model
+     * @param b second node mobility model
+     * @param aPhasedArrayModel the antenna array of the first node
+     * @param bPhasedArrayModel the antenna array of the second node
+     * @return the task which computes the received PSD
+     */
+    RxPsdTask DoPrepareRxPowerSpectralDensity(
+        Ptr<const SpectrumSignalParameters> spectrumSignalParams,
+        Ptr<const MobilityModel> a,
+        Ptr<const MobilityModel> b,
+        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+        Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
+
   protected:
     /**
      * Data structure that stores the long term component for a tx-rx pair
@@ -138,11 +160,24 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     };
 
     /**
-     * Computes the frequency-domain channel matrix with the dimensions numRxPorts*numTxPorts*numRBs
+     * Returns the delay term of each cluster in each sub-band of a PSD, and
+     * caches it in the channel parameters until the number of sub-bands, the
+     * number of clusters or the width of the sub-bands changes.
      * @param inPsd the input PSD
-     * @param longTerm the long term component
      * @param channelMatrix the channel matrix structure
      * @param channelParams the channel parameters, including delays
+     * @return the delay term, with dimensions numRBs * numClusters
+     */
+    ComplexMatrixArray GetDelaySincos(
+        Ptr<const SpectrumValue> inPsd,
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams) const;
+
+    /**
+     * Computes the frequency-domain channel matrix with the dimensions numRxPorts*numTxPorts*numRBs
+     * @param inPsd the input PSD
+     * @param longTerm the long term component
+     * @param delaySincos the delay term of each cluster in each sub-band, see GetDelaySincos
      * @param doppler the doppler for each cluster
      * @param numTxPorts the number of antenna ports at the transmitter
      * @param numRxPorts the number of antenna ports at the receiver
@@ -150,11 +185,10 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      * @return 3D spectrum channel matrix with dimensions numRxPorts * numTxPorts * numRBs
      */
     Ptr<MatrixBasedChannelModel::Complex3DVector> GenSpectrumChannelMatrix(
-        Ptr<SpectrumValue> inPsd,
-        Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
-        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-        PhasedArrayModel::ComplexVector doppler,
+        const SpectrumValue& inPsd,
+        const MatrixBasedChannelModel::Complex3DVector& longTerm,
+        ComplexMatrixArray delaySincos,
+        const PhasedArrayModel::ComplexVector& doppler,
         uint8_t numTxPorts,
         uint8_t numRxPorts,
         bool isReverse) const;
@@ -168,7 +202,9 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     /**
      * Looks for the long term component in m_longTermMap. If found, checks
      * whether it has to be updated. If not found or if it has to be updated,
-     * calls the method CalcLongTerm to compute it.
+     * calls the method CalcLongTerm to compute it.  Before adding a new
+     * component, removes the components of the channels older than the
+     * coherence time of the channel model, at most once per coherence time.
      * @param channelMatrix the channel matrix
      * @param aPhasedArrayModel the antenna array of the tx device
      * @param bPhasedArrayModel the antenna array of the rx device
@@ -211,33 +247,41 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
 
     /**
      * @brief Computes the beamforming gain and applies it to the TX PSD
-     * @param params SpectrumSignalParameters holding TX PSD
+     *
+     * This function only reads the state of the model and the shared
+     * structures it is given, so that it can run on a worker thread.
+     *
+     * @param rxParams SpectrumSignalParameters holding TX PSD, updated with the RX PSD
+     *        and the spectrum channel matrix
      * @param longTerm the long term component
      * @param channelMatrix the channel matrix structure
      * @param channelParams the channel params structure
+     * @param delaySincos the delay term of each cluster in each sub-band, see GetDelaySincos
+     * @param slotTime the time of the reception, in seconds
      * @param sSpeed the speed of the first node
      * @param uSpeed the speed of the second node
      * @param numTxPorts the number of the ports of the first node
      * @param numRxPorts the number of the porst of the second node
      * @param isReverse indicator that tells whether the channel matrix is reverse
-     * @return
      */
-    Ptr<SpectrumSignalParameters> CalcBeamformingGain(
-        Ptr<const SpectrumSignalParameters> params,
-        Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
-        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-        const Vector& sSpeed,
-        const Vector& uSpeed,
-        uint8_t numTxPorts,
-        uint8_t numRxPorts,
-        bool isReverse) const;
+    void CalcBeamformingGain(SpectrumSignalParameters& rxParams,
+                             const MatrixBasedChannelModel::Complex3DVector& longTerm,
+                             const MatrixBasedChannelModel::ChannelMatrix& channelMatrix,
+                             const MatrixBasedChannelModel::ChannelParams& channelParams,
+                             ComplexMatrixArray delaySincos,
+                             double slotTime,
+                             const Vector& sSpeed,
+                             const Vector& uSpeed,
+                             uint8_t numTxPorts,
+                             uint8_t numRxPorts,
+                             bool isReverse) const;
 
     int64_t DoAssignStreams(int64_t stream) override;
 
     mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
         m_longTermMap;                           //!< map containing the long term components
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
+    mutable Time m_lastRemoval;                  //!< last removal of the stale long terms
 };
 } // namespace ns3
 
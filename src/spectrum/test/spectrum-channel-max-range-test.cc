@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief SpectrumPhy which records the order of the signals it receives
+ */
+class RecordingSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * @param id the identifier recorded at each reception
+     * @param rxSpectrumModel the RX SpectrumModel
+     * @param receptions the list where receptions are recorded
+     */
+    RecordingSpectrumPhy(uint32_t id,
+                         Ptr<const SpectrumModel> rxSpectrumModel,
+                         std::vector<uint32_t>* receptions)
+        : m_id(id),
+          m_rxSpectrumModel(rxSpectrumModel),
+          m_receptions(receptions)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        m_receptions->push_back(m_id);
+    }
+
+  private:
+    uint32_t m_id;                              //!< Identifier recorded at each reception
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< RX SpectrumModel
+    Ptr<MobilityModel> m_mobility;              //!< Mobility model
+    std::vector<uint32_t>* m_receptions;        //!< List where receptions are recorded
+};
+
+} // namespace
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief Check that the MaxRange attribute of MultiModelSpectrumChannel only
+ * removes the receivers out of range, and keeps the order of the others.
+ *
+ * Ten PHYs lie on a line, 10 m apart, and use two SpectrumModels so that
+ * the channel does not visit them in the order they were added.  The last
+ * PHY has no mobility model.  PHY 0 transmits twice, before and after PHY 1
+ * moves away.
+ */
+class SpectrumChannelMaxRangeTestCase : public TestCase
+{
+  public:
+    SpectrumChannelMaxRangeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the scenario.
+     * @param maxRange the MaxRange attribute of the channel
+     * @return the identifiers of the PHYs, in the order they received the signals
+     */
+    std::vector<uint32_t> RunScenario(double maxRange);
+};
+
+SpectrumChannelMaxRangeTestCase::SpectrumChannelMaxRangeTestCase()
+    : TestCase("Check the receivers culled by the MaxRange of MultiModelSpectrumChannel")
+{
+}
+
+std::vector<uint32_t>
+SpectrumChannelMaxRangeTestCase::RunScenario(double maxRange)
+{
+    std::vector<double> coarse{1e9, 1.01e9, 1.02e9};
+    std::vector<double> fine{1e9, 1.005e9, 1.01e9, 1.015e9, 1.02e9};
+    Ptr<SpectrumModel> modelA = Create<SpectrumModel>(coarse);
+    Ptr<SpectrumModel> modelB = Create<SpectrumModel>(fine);
+
+    auto channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("MaxRange", DoubleValue(maxRange));
+
+    std::vector<uint32_t> receptions;
+    std::vector<Ptr<RecordingSpectrumPhy>> phys;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        auto phy =
+            CreateObject<RecordingSpectrumPhy>(i, (i % 2 == 0) ? modelB : modelA, &receptions);
+        if (i < 9)
+        {
+            auto mobility = CreateObject<ConstantPositionMobilityModel>();
+            mobility->SetPosition(Vector(10.0 * i, 0, 0));
+            phy->SetMobility(mobility);
+        }
+        channel->AddRx(phy);
+        phys.push_back(phy);
+    }
+
+    auto params = Create<SpectrumSignalParameters>();
+    params->txPhy = phys[0];
+    params->duration = MicroSeconds(100);
+    params->psd = Create<SpectrumValue>(modelA);
+    (*params->psd) = 1e-9;
+
+    Simulator::Schedule(Seconds(1), &MultiModelSpectrumChannel::StartTx, channel, params);
+    Simulator::Schedule(Seconds(2), [&phys]() {
+        DynamicCast<ConstantPositionMobilityModel>(phys[1]->GetMobility())
+            ->SetPosition(Vector(1000, 0, 0));
+    });
+    Simulator::Schedule(Seconds(3), &MultiModelSpectrumChannel::StartTx, channel, params);
+    Simulator::Run();
+    Simulator::Destroy();
+    channel->Dispose();
+    return receptions;
+}
+
+void
+SpectrumChannelMaxRangeTestCase::DoRun()
+{
+    std::vector<uint32_t> all = RunScenario(0);
+    NS_TEST_ASSERT_MSG_EQ(all.size(), 18, "All the other PHYs should receive both signals");
+
+    // PHYs 1 to 3 are within 35 m, PHY 9 has no position; PHY 1 moves away
+    std::vector<uint32_t> expected;
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        bool second = (i >= all.size() / 2);
+        uint32_t id = all[i];
+        if ((id == 1 && !second) || id == 2 || id == 3 || id == 9)
+        {
+            expected.push_back(id);
+        }
+    }
+
+    std::vector<uint32_t> culled = RunScenario(35);
+    NS_TEST_ASSERT_MSG_EQ(culled.size(), expected.size(), "Wrong number of receptions");
+    for (std::size_t i = 0; i < culled.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(culled[i], expected[i], "Wrong receiver or order of receivers");
+    }
+}
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief MultiModelSpectrumChannel MaxRange TestSuite
+ */
+class SpectrumChannelMaxRangeTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelMaxRangeTestSuite();
+};
+
+SpectrumChannelMaxRangeTestSuite::SpectrumChannelMaxRangeTestSuite()
+    : TestSuite("spectrum-channel-max-range", Type::UNIT)
+{
+    AddTestCase(new SpectrumChannelMaxRangeTestCase(), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelMaxRangeTestSuite g_spectrumChannelMaxRangeTestSuite;
@@ -0,0 +1,275 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/angles.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/// A reception recorded by RecordingSpectrumPhy
+struct Reception
+{
+    uint32_t id;               //!< Identifier of the receiver
+    Time time;                 //!< Time of the reception
+    std::vector<double> psd;   //!< Received PSD
+    std::size_t channelValues; //!< Number of values of the spectrum channel matrix
+};
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief SpectrumPhy with a phased array which records the signals it receives
+ */
+class RecordingSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * @param id the identifier recorded at each reception
+     * @param rxSpectrumModel the RX SpectrumModel
+     * @param antenna the phased array of the PHY
+     * @param receptions the list where receptions are recorded
+     */
+    RecordingSpectrumPhy(uint32_t id,
+                         Ptr<const SpectrumModel> rxSpectrumModel,
+                         Ptr<PhasedArrayModel> antenna,
+                         std::vector<Reception>* receptions)
+        : m_id(id),
+          m_rxSpectrumModel(rxSpectrumModel),
+          m_antenna(antenna),
+          m_receptions(receptions)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+        m_device = d;
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return m_device;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return m_antenna;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        Reception r{m_id,
+                    Simulator::Now(),
+                    {params->psd->ConstValuesBegin(), params->psd->ConstValuesEnd()},
+                    0};
+        if (params->spectrumChannelMatrix)
+        {
+            r.channelValues = params->spectrumChannelMatrix->GetSize();
+        }
+        m_receptions->push_back(r);
+    }
+
+  private:
+    uint32_t m_id;                              //!< Identifier recorded at each reception
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< RX SpectrumModel
+    Ptr<PhasedArrayModel> m_antenna;            //!< Phased array
+    Ptr<NetDevice> m_device;                    //!< Net device
+    Ptr<MobilityModel> m_mobility;              //!< Mobility model
+    std::vector<Reception>* m_receptions;       //!< List where receptions are recorded
+};
+
+} // namespace
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief Check that the RxThreads attribute of MultiModelSpectrumChannel does
+ * not change the signals the receivers get.
+ *
+ * A PHY transmits to eight PHYs with the 3GPP spectrum propagation loss
+ * model.  The receivers are added in the order of their distance to the
+ * transmitter, and do not move, so the signals computed when the transmission
+ * starts draw the same channel realizations as the signals computed when
+ * they reach each receiver.
+ */
+class SpectrumChannelRxThreadsTestCase : public TestCase
+{
+  public:
+    SpectrumChannelRxThreadsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the scenario.
+     * @param rxThreads the RxThreads attribute of the channel
+     * @return the receptions, in the order they happened
+     */
+    std::vector<Reception> RunScenario(uint32_t rxThreads);
+};
+
+SpectrumChannelRxThreadsTestCase::SpectrumChannelRxThreadsTestCase()
+    : TestCase("Check the signals computed by the RxThreads of MultiModelSpectrumChannel")
+{
+}
+
+std::vector<Reception>
+SpectrumChannelRxThreadsTestCase::RunScenario(uint32_t rxThreads)
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        freqs.push_back(2.4e9 + i * 180e3);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+
+    auto lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    lossModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    DynamicCast<ThreeGppChannelModel>(lossModel->GetChannelModel())->AssignStreams(1);
+
+    auto channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("RxThreads", UintegerValue(rxThreads));
+    channel->AddPropagationLossModel(CreateObject<FriisPropagationLossModel>());
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    channel->AddPhasedArraySpectrumPropagationLossModel(lossModel);
+
+    std::vector<Reception> receptions;
+    std::vector<Ptr<RecordingSpectrumPhy>> phys;
+    NodeContainer nodes;
+    nodes.Create(9);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        auto device = CreateObject<SimpleNetDevice>();
+        nodes.Get(i)->AddDevice(device);
+        device->SetNode(nodes.Get(i));
+        auto mobility = CreateObject<ConstantPositionMobilityModel>();
+        Vector position(20.0 * i, 5.0 * (i % 3), 10.0);
+        mobility->SetPosition(position);
+        nodes.Get(i)->AggregateObject(mobility);
+
+        auto antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(2),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()));
+        // the transmitter points at the fourth receiver, the receivers at the transmitter
+        Vector target = (i == 0) ? Vector(80, 5, 10) : Vector(0, 0, 10);
+        antenna->SetBeamformingVector(antenna->GetBeamformingVector(Angles(target, position)));
+        auto phy = CreateObject<RecordingSpectrumPhy>(i, model, antenna, &receptions);
+        phy->SetDevice(device);
+        phy->SetMobility(mobility);
+        channel->AddRx(phy);
+        phys.push_back(phy);
+    }
+
+    auto params = Create<SpectrumSignalParameters>();
+    params->txPhy = phys[0];
+    params->duration = MicroSeconds(100);
+    params->psd = Create<SpectrumValue>(model);
+    (*params->psd) = 1e-9;
+
+    Simulator::Schedule(Seconds(1), &MultiModelSpectrumChannel::StartTx, channel, params);
+    Simulator::Schedule(Seconds(2), &MultiModelSpectrumChannel::StartTx, channel, params);
+    Simulator::Run();
+    Simulator::Destroy();
+    channel->Dispose();
+    return receptions;
+}
+
+void
+SpectrumChannelRxThreadsTestCase::DoRun()
+{
+    std::vector<Reception> reference = RunScenario(0);
+    NS_TEST_ASSERT_MSG_EQ(reference.size(), 16, "All the other PHYs should receive both signals");
+
+    for (uint32_t rxThreads : {1, 3})
+    {
+        std::vector<Reception> receptions = RunScenario(rxThreads);
+        NS_TEST_ASSERT_MSG_EQ(receptions.size(), reference.size(), "Wrong number of receptions");
+        for (std::size_t i = 0; i < receptions.size(); ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(receptions[i].id, reference[i].id, "Wrong receiver");
+            NS_TEST_ASSERT_MSG_EQ(receptions[i].time, reference[i].time, "Wrong time");
+            NS_TEST_ASSERT_MSG_GT(receptions[i].channelValues,
+                                  0,
+                                  "The spectrum channel matrix is not set");
+            NS_TEST_ASSERT_MSG_EQ(receptions[i].channelValues,
+                                  reference[i].channelValues,
+                                  "Wrong size of the spectrum channel matrix");
+            NS_TEST_ASSERT_MSG_EQ((receptions[i].psd == reference[i].psd),
+                                  true,
+                                  "Wrong PSD with " << rxThreads << " threads at receiver "
+                                                    << receptions[i].id);
+        }
+    }
+}
+
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief MultiModelSpectrumChannel RxThreads TestSuite
+ */
+class SpectrumChannelRxThreadsTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelRxThreadsTestSuite();
+};
+
+SpectrumChannelRxThreadsTestSuite::SpectrumChannelRxThreadsTestSuite()
+    : TestSuite("spectrum-channel-rx-threads", Type::UNIT)
+{
+    AddTestCase(new SpectrumChannelRxThreadsTestCase(), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelRxThreadsTestSuite g_spectrumChannelRxThreadsTestSuite;
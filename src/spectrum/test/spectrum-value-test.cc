@@ -15,6 +15,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 using namespace ns3;
 
@@ -81,6 +82,99 @@ SpectrumValueTestCase::DoRun()
     NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(m_a, m_b, TOLERANCE, "");
 }
 
+/**
+ * @ingroup spectrum-tests
+ *
+ * @brief Check that the arithmetic of SpectrumValue gives, for every band,
+ * exactly the value of the same operation on doubles
+ *
+ * The number of bands is not a multiple of the block size of the vector
+ * kernels, so that both the vector and the scalar loops are exercised.
+ */
+class SpectrumValueKernelTestCase : public TestCase
+{
+  public:
+    SpectrumValueKernelTestCase();
+    void DoRun() override;
+};
+
+SpectrumValueKernelTestCase::SpectrumValueKernelTestCase()
+    : TestCase("Check SpectrumValue arithmetic band by band")
+{
+}
+
+void
+SpectrumValueKernelTestCase::DoRun()
+{
+    const size_t nBands = 21;
+    std::vector<double> freqs;
+    for (size_t i = 0; i <= nBands; i++)
+    {
+        freqs.push_back(1e9 + i * 1e6);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+
+    SpectrumValue a(model);
+    SpectrumValue b(model);
+    SpectrumValue c(model);
+    for (size_t i = 0; i < nBands; i++)
+    {
+        a[i] = 0.3 + 0.7 * i;
+        b[i] = 1.1 - 0.13 * i;
+        c[i] = 2.5 / (i + 1);
+    }
+
+    SpectrumValue r = a * b + c - a;
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], a[i] * b[i] + c[i] - a[i], "a * b + c - a differs");
+    }
+
+    r = (a / b - 2.0) * 3.0 + 1.0;
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], (a[i] / b[i] - 2.0) * 3.0 + 1.0, "(a / b - 2) * 3 + 1 differs");
+    }
+
+    r = -(a + b) / c;
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], -(a[i] + b[i]) / c[i], "-(a + b) / c differs");
+    }
+
+    r = Log10(a * 2.0);
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], std::log10(a[i] * 2.0), "Log10(a * 2) differs");
+    }
+
+    r = 0.5 * Pow(a + b, 2.0);
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i],
+                              0.5 * std::pow(a[i] + b[i], 2.0),
+                              "0.5 * Pow(a + b, 2) differs");
+    }
+
+    r = a;
+    r += r;
+    r *= r;
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], (a[i] + a[i]) * (a[i] + a[i]), "in place operations differ");
+    }
+
+    r = 4.25;
+    for (size_t i = 0; i < nBands; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(r[i], 4.25, "assignment of a double differs");
+    }
+
+    // the temporaries must not change the operands
+    NS_TEST_ASSERT_MSG_EQ(a[nBands - 1], 0.3 + 0.7 * (nBands - 1), "operand a was modified");
+    NS_TEST_ASSERT_MSG_EQ(b[nBands - 1], 1.1 - 0.13 * (nBands - 1), "operand b was modified");
+}
+
 /**
  * @ingroup spectrum-tests
  *
@@ -264,6 +358,8 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     tv1rs3 = v1 >> 3;
     AddTestCase(new SpectrumValueTestCase(tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"),
                 TestCase::Duration::QUICK);
+
+    AddTestCase(new SpectrumValueKernelTestCase(), TestCase::Duration::QUICK);
 }
 
 /**
@@ -14,6 +14,7 @@
 #include "wifi-utils.h"
 #include "yans-wifi-phy.h"
 
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
@@ -22,6 +23,8 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
 
+#include <limits>
+
 namespace ns3
 {
 
@@ -46,11 +49,29 @@ YansWifiChannel::GetTypeId()
                           "A pointer to the propagation delay model attached to this channel.",
                           PointerValue(),
                           MakePointerAccessor(&YansWifiChannel::m_delay),
-                          MakePointerChecker<PropagationDelayModel>());
+                          MakePointerChecker<PropagationDelayModel>())
+            .AddAttribute("MaxRange",
+                          "If positive, the distance in meters beyond which the PHYs do not "
+                          "get the PPDUs at all. The PHYs are then found through a spatial "
+                          "index instead of a scan of all of them, which saves the "
+                          "propagation loss computations and the events of PHYs which can "
+                          "never decode a PPDU in large networks.",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&YansWifiChannel::SetMaxRange),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MinRxPower",
+                          "The RX power, before the RX gain of the receiver, below which a "
+                          "PPDU is not delivered to a PHY. Unlike the RX sensitivity of the "
+                          "PHY, the reception is then not scheduled and the SignalArrival "
+                          "trace of the PHY is not fired. The default delivers all the PPDUs.",
+                          DoubleValue(-std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&YansWifiChannel::m_minRxPower),
+                          MakeDoubleChecker<double>());
     return tid;
 }
 
 YansWifiChannel::YansWifiChannel()
+    : m_maxRange(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -58,6 +79,7 @@ YansWifiChannel::YansWifiChannel()
 YansWifiChannel::~YansWifiChannel()
 {
     NS_LOG_FUNCTION(this);
+    m_grid.Clear();
     m_phyList.clear();
 }
 
@@ -75,48 +97,89 @@ YansWifiChannel::SetPropagationDelayModel(const Ptr<PropagationDelayModel> delay
     m_delay = delay;
 }
 
+void
+YansWifiChannel::SetMaxRange(double maxRange)
+{
+    NS_LOG_FUNCTION(this << maxRange);
+    m_maxRange = maxRange;
+    m_grid.Clear();
+}
+
 void
 YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, dBm_u txPower) const
 {
     NS_LOG_FUNCTION(this << sender << ppdu << txPower);
     Ptr<MobilityModel> senderMobility = sender->GetMobility();
     NS_ASSERT(senderMobility);
-    for (auto i = m_phyList.begin(); i != m_phyList.end(); i++)
+    if (m_maxRange > 0)
     {
-        if (sender != (*i))
+        if (m_grid.GetN() != m_phyList.size())
         {
-            // For now don't account for inter channel interference nor channel bonding
-            if ((*i)->GetChannelNumber() != sender->GetChannelNumber())
+            m_grid.Reset(m_maxRange);
+            for (std::size_t i = 0; i < m_phyList.size(); ++i)
             {
-                continue;
+                m_grid.Add(i, m_phyList[i]->GetMobility());
             }
+        }
+        // the ranks come in increasing order, as in the scan below
+        for (auto i : m_grid.GetInRange(senderMobility->GetPosition(), m_maxRange))
+        {
+            SendTo(sender, m_phyList[i], ppdu, txPower);
+        }
+        return;
+    }
+    for (auto i = m_phyList.begin(); i != m_phyList.end(); i++)
+    {
+        SendTo(sender, *i, ppdu, txPower);
+    }
+}
 
-            auto receiverMobility = (*i)->GetMobility()->GetObject<MobilityModel>();
-            const auto delay = m_delay->GetDelay(senderMobility, receiverMobility);
-            const dBm_u rxPower{m_loss->CalcRxPower(txPower, senderMobility, receiverMobility)};
-            NS_LOG_DEBUG("propagation: txPower="
-                         << txPower << "dBm, rxPower=" << rxPower << "dBm, "
-                         << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
-                         << "m, delay=" << delay);
-            auto dstNetDevice = (*i)->GetDevice();
-            uint32_t dstNode;
-            if (!dstNetDevice)
-            {
-                dstNode = 0xffffffff;
-            }
-            else
-            {
-                dstNode = dstNetDevice->GetNode()->GetId();
-            }
+void
+YansWifiChannel::SendTo(Ptr<YansWifiPhy> sender,
+                        Ptr<YansWifiPhy> receiver,
+                        Ptr<const WifiPpdu> ppdu,
+                        dBm_u txPower) const
+{
+    if (sender == receiver)
+    {
+        return;
+    }
+    // For now don't account for inter channel interference nor channel bonding
+    if (receiver->GetChannelNumber() != sender->GetChannelNumber())
+    {
+        return;
+    }
 
-            Simulator::ScheduleWithContext(dstNode,
-                                           delay,
-                                           &YansWifiChannel::Receive,
-                                           (*i),
-                                           ppdu,
-                                           rxPower);
-        }
+    Ptr<MobilityModel> senderMobility = sender->GetMobility();
+    auto receiverMobility = receiver->GetMobility()->GetObject<MobilityModel>();
+    const auto delay = m_delay->GetDelay(senderMobility, receiverMobility);
+    const dBm_u rxPower{m_loss->CalcRxPower(txPower, senderMobility, receiverMobility)};
+    NS_LOG_DEBUG("propagation: txPower="
+                 << txPower << "dBm, rxPower=" << rxPower << "dBm, "
+                 << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
+                 << "m, delay=" << delay);
+    if (rxPower < m_minRxPower)
+    {
+        NS_LOG_DEBUG("RX power below " << m_minRxPower << "dBm, not delivered");
+        return;
     }
+    auto dstNetDevice = receiver->GetDevice();
+    uint32_t dstNode;
+    if (!dstNetDevice)
+    {
+        dstNode = 0xffffffff;
+    }
+    else
+    {
+        dstNode = dstNetDevice->GetNode()->GetId();
+    }
+
+    Simulator::ScheduleWithContext(dstNode,
+                                   delay,
+                                   &YansWifiChannel::Receive,
+                                   receiver,
+                                   ppdu,
+                                   rxPower);
 }
 
 void
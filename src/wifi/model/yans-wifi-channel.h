@@ -12,6 +12,7 @@
 #include "wifi-units.h"
 
 #include "ns3/channel.h"
+#include "ns3/spatial-grid.h"
 
 namespace ns3
 {
@@ -104,9 +105,40 @@ class YansWifiChannel : public Channel
      */
     static void Receive(Ptr<YansWifiPhy> receiver, Ptr<const WifiPpdu> ppdu, dBm_u txPower);
 
+    /**
+     * Compute the RX power and the delay of a PPDU at a receiver and schedule
+     * its reception.
+     *
+     * @param sender the PHY object from which the packet is originating
+     * @param receiver the PHY object which receives the PPDU
+     * @param ppdu the PPDU to send
+     * @param txPower the TX power associated to the packet
+     */
+    void SendTo(Ptr<YansWifiPhy> sender,
+                Ptr<YansWifiPhy> receiver,
+                Ptr<const WifiPpdu> ppdu,
+                dBm_u txPower) const;
+
+    /**
+     * Set the range beyond which receivers do not get the PPDUs.
+     *
+     * @param maxRange the range in meters, or 0 to disable the culling
+     */
+    void SetMaxRange(double maxRange);
+
     PhyList m_phyList;                  //!< List of YansWifiPhys connected to this YansWifiChannel
     Ptr<PropagationLossModel> m_loss;   //!< Propagation loss model
     Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+    double m_maxRange;                  //!< Range beyond which receivers are skipped, 0 if disabled
+    dBm_u m_minRxPower;                 //!< RX power below which PPDUs are not delivered
+
+    /**
+     * Positions of the YansWifiPhys, indexed by their rank in m_phyList, when
+     * m_maxRange is set.  The PHYs are indexed at the first transmission
+     * which follows their addition, since their mobility model may be
+     * aggregated to the node after the PHY is added to the channel.
+     */
+    mutable SpatialGrid m_grid;
 };
 
 } // namespace ns3
@@ -11,6 +11,7 @@
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
+#include "ns3/packet-memory-pool.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
@@ -352,6 +353,7 @@ runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 static void
 runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
 {
+    PacketMemoryPool::ResetStats();
     uint64_t minDelay = std::numeric_limits<uint64_t>::max();
     for (uint32_t i = 0; i < minIterations; i++)
     {
@@ -363,6 +365,10 @@ runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char
     ps /= minDelay;
     std::cout << ps << " packets/s"
               << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+    PacketMemoryPool::Stats stats = PacketMemoryPool::GetStats();
+    std::cout << "\tpool: " << stats.allocations << " allocations, " << stats.hits << " recycled, "
+              << stats.oversize << " oversize, " << stats.chunkBytes / 1024 << " KiB of chunks"
+              << std::endl;
 }
 
 int
@@ -13,6 +13,7 @@
 #include <iomanip>
 #include <iostream>
 #include <string.h>
+#include <thread>
 #include <vector>
 
 using namespace ns3;
@@ -373,6 +374,151 @@ BenchSuite::Log() const
     LOG("");
 }
 
+/**
+ *  Benchmark of events injected from other threads.
+ *
+ *  A number of producer threads each call Simulator::ScheduleWithContext()
+ *  with zero delay as fast as they can, while the main thread runs the
+ *  simulation, moving the injected events into the scheduler and
+ *  executing them.
+ */
+class InjectBench
+{
+  public:
+    /**
+     * Constructor
+     * @param [in] threads The number of producer threads.
+     * @param [in] events The number of events injected by each thread.
+     */
+    InjectBench(uint32_t threads, uint64_t events)
+        : m_threads(threads),
+          m_events(events),
+          m_count(0)
+    {
+    }
+
+    /** Perform one run and write the results to \c LOG() */
+    void Run();
+
+  private:
+    /** First event: start the producer threads. */
+    void Start();
+    /** Keep the simulation alive until all injected events have run. */
+    void KeepAlive();
+    /** Event function for the injected events. */
+    void Injected();
+    /**
+     * Producer thread body.
+     * @param [in] context The context to inject the events with.
+     */
+    void Produce(uint32_t context);
+
+    uint32_t m_threads;                   /**< Number of producer threads. */
+    uint64_t m_events;                    /**< Events injected per thread. */
+    uint64_t m_count;                     /**< Injected events executed so far. */
+    std::vector<std::thread> m_producers; /**< The producer threads. */
+    std::vector<double> m_produce;        /**< Per-thread injection time (s). */
+};
+
+void
+InjectBench::Run()
+{
+    SystemWallClockMs timer;
+    m_count = 0;
+    m_produce.assign(m_threads, 0);
+
+    Simulator::ScheduleNow(&InjectBench::Start, this);
+    timer.Start();
+    Simulator::Run();
+    double simu = timer.End() / 1000.0;
+    Simulator::Destroy();
+
+    double produce = 0;
+    for (auto t : m_produce)
+    {
+        produce = std::max(produce, t);
+    }
+    uint64_t total = m_threads * m_events;
+    LOG(std::left << std::setw(g_fwidth) << m_threads << std::setw(g_fwidth) << produce
+                  << std::setw(g_fwidth) << total / produce << std::setw(g_fwidth) << simu
+                  << std::setw(g_fwidth) << total / simu);
+}
+
+void
+InjectBench::Start()
+{
+    m_producers.clear();
+    for (uint32_t i = 0; i < m_threads; ++i)
+    {
+        m_producers.emplace_back(&InjectBench::Produce, this, i);
+    }
+    KeepAlive();
+}
+
+void
+InjectBench::KeepAlive()
+{
+    if (m_count >= m_threads * m_events)
+    {
+        for (auto& t : m_producers)
+        {
+            t.join();
+        }
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(NanoSeconds(1), &InjectBench::KeepAlive, this);
+}
+
+void
+InjectBench::Injected()
+{
+    ++m_count;
+}
+
+void
+InjectBench::Produce(uint32_t context)
+{
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t i = 0; i < m_events; ++i)
+    {
+        Simulator::ScheduleWithContext(context, Time(0), &InjectBench::Injected, this);
+    }
+    m_produce[context] = timer.End() / 1000.0;
+}
+
+/**
+ *  Run the cross-thread injection benchmark with 1, 2, 4, ... producer
+ *  threads below \p threads, and then with \p threads itself.
+ *
+ *  @param [in] threads The maximum number of producer threads.
+ *  @param [in] events The number of events injected by each thread.
+ */
+void
+InjectSuite(uint32_t threads, uint64_t events)
+{
+    LOG("");
+    LOG("Cross-thread injection, " << events << " events per thread");
+    LOG(std::left << std::setw(g_fwidth) << "Thrds" << std::setw(2 * g_fwidth)
+                  << "Injection:" << "End to end:");
+    LOG(std::left << std::setw(g_fwidth) << "" << std::setw(g_fwidth) << "Time (s)"
+                  << std::setw(g_fwidth) << "Rate (ev/s)" << std::setw(g_fwidth) << "Time (s)"
+                  << "Rate (ev/s)");
+    // Powers of two below the maximum, then the maximum itself
+    std::vector<uint32_t> counts;
+    for (uint32_t n = 1; n < threads; n *= 2)
+    {
+        counts.push_back(n);
+    }
+    counts.push_back(threads);
+    for (auto n : counts)
+    {
+        InjectBench(n, events).Run();
+    }
+    LOG("");
+}
+
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
@@ -381,15 +527,29 @@ BenchSuite::Log() const
  *
  *  If the \p filename is `-` standard input will be used.
  *
+ *  If \p pareto is \c true a heavy-tailed Pareto distribution is used
+ *  instead, with mostly short delays (scale 10 ns) and rare very long ones
+ *  (shape 1.1, bound 1 s), like many timers amid bursts of PHY events.
+ *
  *  @param [in] filename The delay interval source file name.
+ *  @param [in] pareto Whether to use the Pareto distribution.
  *  @returns The RandomVariableStream.
  */
 Ptr<RandomVariableStream>
-GetRandomStream(std::string filename)
+GetRandomStream(std::string filename, bool pareto)
 {
     Ptr<RandomVariableStream> stream = nullptr;
 
-    if (filename.empty())
+    if (pareto)
+    {
+        LOG("  Event time distribution:      pareto");
+        auto prv = CreateObject<ParetoRandomVariable>();
+        prv->SetAttribute("Scale", DoubleValue(10));
+        prv->SetAttribute("Shape", DoubleValue(1.1));
+        prv->SetAttribute("Bound", DoubleValue(1e9));
+        stream = prv;
+    }
+    else if (filename.empty())
     {
         LOG("  Event time distribution:      default exponential");
         auto erv = CreateObject<ExponentialRandomVariable>();
@@ -443,6 +603,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -452,12 +613,16 @@ main(int argc, char* argv[])
     uint64_t runs = 1;
     std::string filename = "";
     bool calRev = false;
+    bool pareto = false;
+    uint32_t inject = 0;
+    uint64_t injectEvents = 100000;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
               "\n"
               "Event intervals are taken from one of:\n"
               "  an exponential distribution, with mean 100 ns,\n"
+              "  a heavy-tailed Pareto distribution, given by --pareto,\n"
               "  an ascii file, given by the --file=\"<filename>\" argument,\n"
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
@@ -468,6 +633,7 @@ main(int argc, char* argv[])
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -476,7 +642,12 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("pareto", "use a heavy-tailed Pareto distribution of event times", pareto);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
+    cmd.AddValue("inject",
+                 "benchmark cross-thread injection with up to this many producer threads",
+                 inject);
+    cmd.AddValue("injectEvents", "events injected by each producer thread", injectEvents);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
@@ -491,15 +662,15 @@ main(int argc, char* argv[])
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    auto eventStream = GetRandomStream(filename, pareto);
 
     ObjectFactory factory("ns3::MapScheduler");
     if (schedCal)
@@ -518,6 +689,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::HeapScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
@@ -539,6 +715,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::PriorityQueueScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (inject > 0)
+    {
+        Simulator::SetScheduler(ObjectFactory("ns3::MapScheduler"));
+        InjectSuite(inject, injectEvents);
+    }
 
     return 0;
 }
@@ -0,0 +1,357 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program compares the SpectrumValue arithmetic with the element by
+// element loops and the copy per operator it used to be built on, for a
+// SpectrumValue of 'bands' bands.
+// Sample usage:  ./ns3 run 'bench-spectrum-value --n=100000 --bands=1024'
+
+#include "ns3/command-line.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <cstdlib> // for exit ()
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/// Reference implementation: the loops SpectrumValue used to run
+namespace reference
+{
+
+/**
+ * Add y to x, component by component
+ * @param x the values updated
+ * @param y the values added
+ */
+void
+Add(Values& x, const Values& y)
+{
+    auto it1 = x.begin();
+    auto it2 = y.begin();
+    while (it1 != x.end())
+    {
+        *it1 += *it2;
+        ++it1;
+        ++it2;
+    }
+}
+
+/**
+ * Multiply x by y, component by component
+ * @param x the values updated
+ * @param y the factors
+ */
+void
+Multiply(Values& x, const Values& y)
+{
+    auto it1 = x.begin();
+    auto it2 = y.begin();
+    while (it1 != x.end())
+    {
+        *it1 *= *it2;
+        ++it1;
+        ++it2;
+    }
+}
+
+/**
+ * Multiply x by a scalar
+ * @param x the values updated
+ * @param s the factor
+ */
+void
+Multiply(Values& x, double s)
+{
+    auto it1 = x.begin();
+    while (it1 != x.end())
+    {
+        *it1 *= s;
+        ++it1;
+    }
+}
+
+/**
+ * Change the sign of x
+ * @param x the values updated
+ */
+void
+ChangeSign(Values& x)
+{
+    auto it1 = x.begin();
+    while (it1 != x.end())
+    {
+        *it1 = -(*it1);
+        ++it1;
+    }
+}
+
+/**
+ * @param lhs Left Hand Side of the operator
+ * @param rhs Right Hand Side of the operator
+ * @return the value of lhs * rhs, through a copy of lhs
+ */
+Values
+Times(const Values& lhs, const Values& rhs)
+{
+    Values res = lhs;
+    Multiply(res, rhs);
+    return res;
+}
+
+/**
+ * @param lhs Left Hand Side of the operator
+ * @param rhs Right Hand Side of the operator
+ * @return the value of lhs + rhs, through a copy of lhs
+ */
+Values
+Plus(const Values& lhs, const Values& rhs)
+{
+    Values res = lhs;
+    Add(res, rhs);
+    return res;
+}
+
+/**
+ * @param lhs Left Hand Side of the operator
+ * @param rhs Right Hand Side of the operator
+ * @return the value of lhs - rhs, through a negated copy of rhs
+ */
+Values
+Minus(const Values& lhs, const Values& rhs)
+{
+    Values res = rhs;
+    ChangeSign(res);
+    Add(res, lhs);
+    return res;
+}
+
+} // namespace reference
+
+/// Number of bands of the SpectrumValues
+uint32_t g_bands = 0;
+
+/// Sink of the results, so that the compiler keeps the computations
+double g_sink = 0;
+
+/**
+ * @return a SpectrumModel with g_bands bands of 1 MHz
+ */
+Ptr<const SpectrumModel>
+MakeModel()
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < g_bands; ++i)
+    {
+        freqs.push_back(5e9 + i * 1e6);
+    }
+    return Create<const SpectrumModel>(freqs);
+}
+
+/**
+ * @param model the SpectrumModel of the value
+ * @param offset the offset of the values
+ * @return a SpectrumValue filled with values which depend on offset
+ */
+SpectrumValue
+MakeValue(Ptr<const SpectrumModel> model, double offset)
+{
+    SpectrumValue v(model);
+    for (uint32_t i = 0; i < g_bands; ++i)
+    {
+        v[i] = offset + 1e-3 * i;
+    }
+    return v;
+}
+
+/**
+ * Accumulate n signals, as an interference model does.
+ * @param n the number of iterations
+ */
+void
+benchAccumulate(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    SpectrumValue sum(model);
+    SpectrumValue psd = MakeValue(model, 1);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += psd;
+    }
+    g_sink += sum[0];
+}
+
+/**
+ * Accumulate n signals with the reference loops.
+ * @param n the number of iterations
+ */
+void
+benchAccumulateReference(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    SpectrumValue v = MakeValue(model, 1);
+    Values sum(g_bands);
+    Values psd(v.ConstValuesBegin(), v.ConstValuesEnd());
+    for (uint32_t i = 0; i < n; i++)
+    {
+        reference::Add(sum, psd);
+    }
+    g_sink += sum[0];
+}
+
+/**
+ * Scale n signals by a path loss, as a channel does.
+ * @param n the number of iterations
+ */
+void
+benchScale(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    SpectrumValue psd = MakeValue(model, 1);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        psd *= 0.999999;
+    }
+    g_sink += psd[0];
+}
+
+/**
+ * Scale n signals with the reference loops.
+ * @param n the number of iterations
+ */
+void
+benchScaleReference(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    SpectrumValue v = MakeValue(model, 1);
+    Values psd(v.ConstValuesBegin(), v.ConstValuesEnd());
+    for (uint32_t i = 0; i < n; i++)
+    {
+        reference::Multiply(psd, 0.999999);
+    }
+    g_sink += psd[0];
+}
+
+/**
+ * Evaluate a * b + c - d, which builds temporaries.
+ * @param n the number of iterations
+ */
+void
+benchExpression(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    SpectrumValue a = MakeValue(model, 1);
+    SpectrumValue b = MakeValue(model, 2);
+    SpectrumValue c = MakeValue(model, 3);
+    SpectrumValue d = MakeValue(model, 4);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        SpectrumValue r = a * b + c - d;
+        g_sink += r[0];
+    }
+}
+
+/**
+ * Evaluate a * b + c - d with the reference operators.
+ * @param n the number of iterations
+ */
+void
+benchExpressionReference(uint32_t n)
+{
+    Ptr<const SpectrumModel> model = MakeModel();
+    std::vector<Values> v;
+    for (double offset : {1, 2, 3, 4})
+    {
+        SpectrumValue s = MakeValue(model, offset);
+        v.emplace_back(s.ConstValuesBegin(), s.ConstValuesEnd());
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Values r = reference::Minus(reference::Plus(reference::Times(v[0], v[1]), v[2]), v[3]);
+        g_sink += r[0];
+    }
+}
+
+/**
+ * Run a benchmark once.
+ * @param bench the benchmark
+ * @param n the number of iterations
+ * @return the elapsed time in milliseconds
+ */
+uint64_t
+runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
+{
+    SystemWallClockMs time;
+    time.Start();
+    (*bench)(n);
+    uint64_t deltaMs = time.End();
+    return deltaMs;
+}
+
+/**
+ * Run a benchmark several times and print the fastest run.
+ * @param bench the benchmark
+ * @param n the number of iterations
+ * @param minIterations the number of runs
+ * @param name the name of the benchmark
+ */
+void
+runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        uint64_t delay = runBenchOneIteration(bench, n);
+        minDelay = std::min(minDelay, delay);
+    }
+    double ops = n;
+    ops *= 1000;
+    ops /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ops << " ops/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    uint32_t minIterations = 1;
+    g_bands = 1024;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark SpectrumValue arithmetic");
+    cmd.AddValue("n", "number of iterations", n);
+    cmd.AddValue("bands", "number of bands of the SpectrumValues", g_bands);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0 || g_bands == 0)
+    {
+        std::cerr << "Error-- number of iterations must be specified "
+                  << "by command-line argument --n=(number of iterations)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-spectrum-value with n=" << n << " and " << g_bands << " bands"
+              << std::endl;
+
+    runBench(&benchAccumulate, n, minIterations, "a += b");
+    runBench(&benchAccumulateReference, n, minIterations, "a += b (reference)");
+    runBench(&benchScale, n, minIterations, "a *= s");
+    runBench(&benchScaleReference, n, minIterations, "a *= s (reference)");
+    runBench(&benchExpression, n, minIterations, "a * b + c - d");
+    runBench(&benchExpressionReference, n, minIterations, "a * b + c - d (reference)");
+
+    std::cout << "checksum " << g_sink << std::endl;
+    return 0;
+}